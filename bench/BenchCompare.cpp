@@ -0,0 +1,509 @@
+#include "BenchCompare.h"
+#include "../include/DataGenerator.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace {
+    /**
+     * 只解析结果 JSON 所需的最小读取器：按结构逐项读取，不认识的值整体跳过
+     */
+    class JsonReader {
+    public:
+        explicit JsonReader(const std::string& text)
+            : p(text.c_str()), end(text.c_str() + text.size()), failed(false) {}
+        
+        bool ok() const { return !failed; }
+        
+        bool consume(char c) {
+            skipSpace();
+            if (p < end && *p == c) {
+                ++p;
+                return true;
+            }
+            return false;
+        }
+        
+        void expect(char c) {
+            if (!consume(c)) {
+                failed = true;
+            }
+        }
+        
+        bool peek(char c) {
+            skipSpace();
+            return p < end && *p == c;
+        }
+        
+        std::string string() {
+            std::string out;
+            if (!consume('"')) {
+                failed = true;
+                return out;
+            }
+            while (p < end && *p != '"') {
+                char c = *p++;
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (p >= end) {
+                    break;
+                }
+                c = *p++;
+                switch (c) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'r': out += '\r'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'u': appendCodePoint(out); break;
+                    default: out += c; break;   // \" \\ \/
+                }
+            }
+            if (p >= end) {
+                failed = true;
+                return out;
+            }
+            ++p;
+            return out;
+        }
+        
+        // 字符串取内容，数值 / true / false / null 取原文
+        std::string scalar() {
+            if (peek('"')) {
+                return string();
+            }
+            const char* start = p;
+            while (p < end && (std::isalnum(static_cast<unsigned char>(*p)) ||
+                               *p == '-' || *p == '+' || *p == '.')) {
+                ++p;
+            }
+            if (p == start) {
+                failed = true;
+            }
+            return std::string(start, p);
+        }
+        
+        double number() {
+            std::string text = scalar();
+            char* stop = nullptr;
+            double value = std::strtod(text.c_str(), &stop);
+            if (text.empty() || *stop != '\0') {
+                failed = true;
+            }
+            return value;
+        }
+        
+        void skip() {
+            if (consume('{')) {
+                if (!consume('}')) {
+                    do {
+                        string();
+                        expect(':');
+                        skip();
+                    } while (!failed && consume(','));
+                    expect('}');
+                }
+            } else if (consume('[')) {
+                if (!consume(']')) {
+                    do {
+                        skip();
+                    } while (!failed && consume(','));
+                    expect(']');
+                }
+            } else {
+                scalar();
+            }
+        }
+    
+    private:
+        const char* p;
+        const char* end;
+        bool failed;
+        
+        void skipSpace() {
+            while (p < end && std::isspace(static_cast<unsigned char>(*p))) {
+                ++p;
+            }
+        }
+        
+        // \uXXXX（只处理基本多文种平面）转为 UTF-8
+        void appendCodePoint(std::string& out) {
+            if (end - p < 4) {
+                failed = true;
+                return;
+            }
+            std::string hex(p, p + 4);
+            unsigned cp = static_cast<unsigned>(std::strtoul(hex.c_str(), nullptr, 16));
+            p += 4;
+            if (cp < 0x80) {
+                out += static_cast<char>(cp);
+            } else if (cp < 0x800) {
+                out += static_cast<char>(0xC0 | (cp >> 6));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            } else {
+                out += static_cast<char>(0xE0 | (cp >> 12));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+    };
+    
+    bool readBenchmark(JsonReader& r, BenchResult& result) {
+        double medianNs = 0;
+        r.expect('{');
+        if (!r.consume('}')) {
+            do {
+                std::string key = r.string();
+                r.expect(':');
+                if (key == "name") {
+                    result.name = r.string();
+                } else if (key == "size") {
+                    result.size = static_cast<size_t>(r.number());
+                } else if (key == "items") {
+                    result.items = static_cast<size_t>(r.number());
+                } else if (key == "iterations") {
+                    result.iterations = static_cast<size_t>(r.number());
+                } else if (key == "median_ns") {
+                    medianNs = r.number();
+                } else if (key == "samples_ns") {
+                    r.expect('[');
+                    if (!r.consume(']')) {
+                        do {
+                            result.samples.push_back(r.number());
+                        } while (r.ok() && r.consume(','));
+                        r.expect(']');
+                    }
+                } else {
+                    r.skip();
+                }
+            } while (r.ok() && r.consume(','));
+            r.expect('}');
+        }
+        result.stats = BenchStats::of(result.samples);
+        if (result.samples.empty()) {
+            result.stats.median = result.stats.mean = medianNs;
+        }
+        return r.ok() && !result.name.empty();
+    }
+    
+    double median(std::vector<double>& values) {
+        size_t n = values.size();
+        std::nth_element(values.begin(), values.begin() + n / 2, values.end());
+        double upper = values[n / 2];
+        if (n % 2) {
+            return upper;
+        }
+        return (*std::max_element(values.begin(), values.begin() + n / 2) + upper) / 2;
+    }
+    
+    // 两组都不超过该样本数且无并列时用精确分布
+    const size_t EXACT_LIMIT = 20;
+    
+    /**
+     * 精确分布下 P(U ≤ u)
+     * f(m, n, u) = f(m-1, n, u-n) + f(m, n-1, u)：最大的值来自第一组时 U 增加 n
+     */
+    double exactCdf(size_t m, size_t n, size_t u) {
+        // table[i][j] 为 f(i, j, ·) 的计数分布
+        std::vector<std::vector<std::vector<double> > > table(
+            m + 1, std::vector<std::vector<double> >(n + 1));
+        for (size_t i = 0; i <= m; ++i) {
+            for (size_t j = 0; j <= n; ++j) {
+                std::vector<double>& f = table[i][j];
+                f.assign(i * j + 1, 0.0);
+                if (i == 0 || j == 0) {
+                    f[0] = 1.0;
+                    continue;
+                }
+                const std::vector<double>& left = table[i - 1][j];
+                const std::vector<double>& down = table[i][j - 1];
+                for (size_t k = 0; k < left.size(); ++k) {
+                    f[k + j] += left[k];
+                }
+                for (size_t k = 0; k < down.size(); ++k) {
+                    f[k] += down[k];
+                }
+            }
+        }
+        const std::vector<double>& f = table[m][n];
+        double total = 0;
+        double below = 0;
+        for (size_t k = 0; k < f.size(); ++k) {
+            total += f[k];
+            if (k <= u) {
+                below += f[k];
+            }
+        }
+        return below / total;
+    }
+    
+    std::string percent(double ratio) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%+.1f%%", ratio * 100);
+        return buf;
+    }
+    
+    const char* verdictLabel(BenchComparison::Verdict v) {
+        switch (v) {
+            case BenchComparison::SLOWER: return "变慢";
+            case BenchComparison::FASTER: return "变快";
+            case BenchComparison::NEW: return "新增";
+            case BenchComparison::TOO_FEW: return "样本不足";
+            default: return "持平";
+        }
+    }
+}
+
+std::string BenchRun::contextValue(const std::string& key) const {
+    for (size_t i = 0; i < context.size(); ++i) {
+        if (context[i].first == key) {
+            return context[i].second;
+        }
+    }
+    return std::string();
+}
+
+namespace BenchCompare {
+    bool readJson(const std::string& filename, BenchRun& run, std::string* error) {
+        std::ifstream fin(filename.c_str(), std::ios::binary);
+        if (!fin) {
+            if (error) *error = "无法打开基线文件：" + filename;
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << fin.rdbuf();
+        std::string text = buffer.str();
+        
+        JsonReader r(text);
+        r.expect('{');
+        if (!r.consume('}')) {
+            do {
+                std::string key = r.string();
+                r.expect(':');
+                if (key == "context") {
+                    r.expect('{');
+                    if (!r.consume('}')) {
+                        do {
+                            std::string name = r.string();
+                            r.expect(':');
+                            run.context.push_back(std::make_pair(name, r.scalar()));
+                        } while (r.ok() && r.consume(','));
+                        r.expect('}');
+                    }
+                } else if (key == "benchmarks") {
+                    r.expect('[');
+                    if (!r.consume(']')) {
+                        do {
+                            BenchResult result;
+                            if (!readBenchmark(r, result)) {
+                                break;
+                            }
+                            run.results.push_back(result);
+                        } while (r.ok() && r.consume(','));
+                        r.expect(']');
+                    }
+                } else {
+                    r.skip();
+                }
+            } while (r.ok() && r.consume(','));
+            r.expect('}');
+        }
+        if (!r.ok()) {
+            if (error) *error = "基线文件格式错误：" + filename;
+            return false;
+        }
+        return true;
+    }
+    
+    double mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b) {
+        const size_t n1 = a.size();
+        const size_t n2 = b.size();
+        if (n1 == 0 || n2 == 0) {
+            return 1.0;
+        }
+        
+        // 合并排序后求秩，并列取平均秩
+        std::vector<std::pair<double, int> > all;
+        all.reserve(n1 + n2);
+        for (size_t i = 0; i < n1; ++i) all.push_back(std::make_pair(a[i], 0));
+        for (size_t i = 0; i < n2; ++i) all.push_back(std::make_pair(b[i], 1));
+        std::sort(all.begin(), all.end());
+        
+        const double N = static_cast<double>(n1 + n2);
+        double rankSumA = 0;
+        double tieTerm = 0;
+        for (size_t i = 0; i < all.size();) {
+            size_t j = i;
+            while (j < all.size() && all[j].first == all[i].first) {
+                ++j;
+            }
+            double rank = (i + 1 + j) / 2.0;
+            for (size_t k = i; k < j; ++k) {
+                if (all[k].second == 0) rankSumA += rank;
+            }
+            double t = static_cast<double>(j - i);
+            tieTerm += t * t * t - t;
+            i = j;
+        }
+        
+        double u1 = rankSumA - n1 * (n1 + 1) / 2.0;
+        double mean = n1 * n2 / 2.0;
+        double uMin = std::min(u1, n1 * n2 - u1);
+        
+        if (tieTerm == 0 && n1 <= EXACT_LIMIT && n2 <= EXACT_LIMIT) {
+            double p = 2 * exactCdf(n1, n2, static_cast<size_t>(uMin + 0.5));
+            return std::min(1.0, p);
+        }
+        
+        double variance = n1 * n2 / 12.0 * ((N + 1) - tieTerm / (N * (N - 1)));
+        if (variance <= 0) {
+            return 1.0;
+        }
+        // 连续性修正
+        double z = (std::fabs(u1 - mean) - 0.5) / std::sqrt(variance);
+        if (z < 0) {
+            z = 0;
+        }
+        return std::min(1.0, std::erfc(z / std::sqrt(2.0)));
+    }
+    
+    void bootstrapRatio(const std::vector<double>& base, const std::vector<double>& current,
+                        unsigned resamples, std::uint64_t seed, double level,
+                        double* low, double* high) {
+        *low = *high = 0;
+        if (base.empty() || current.empty() || resamples == 0) {
+            return;
+        }
+        Xoshiro256 rng(seed);
+        std::vector<double> ratios;
+        ratios.reserve(resamples);
+        std::vector<double> x(base.size());
+        std::vector<double> y(current.size());
+        for (unsigned r = 0; r < resamples; ++r) {
+            for (size_t i = 0; i < x.size(); ++i) {
+                x[i] = base[rng.below(static_cast<std::uint32_t>(base.size()))];
+            }
+            for (size_t i = 0; i < y.size(); ++i) {
+                y[i] = current[rng.below(static_cast<std::uint32_t>(current.size()))];
+            }
+            double mx = median(x);
+            if (mx > 0) {
+                ratios.push_back(median(y) / mx);
+            }
+        }
+        if (ratios.empty()) {
+            return;
+        }
+        std::sort(ratios.begin(), ratios.end());
+        double tail = (1 - level) / 2;
+        size_t last = ratios.size() - 1;
+        *low = ratios[static_cast<size_t>(tail * last + 0.5)];
+        *high = ratios[static_cast<size_t>((1 - tail) * last + 0.5)];
+    }
+    
+    std::vector<BenchComparison> compare(const BenchRun& base, const BenchRun& current,
+                                         const CompareOptions& options) {
+        std::map<std::string, const BenchResult*> baseline;
+        for (size_t i = 0; i < base.results.size(); ++i) {
+            baseline[base.results[i].key()] = &base.results[i];
+        }
+        
+        std::vector<BenchComparison> rows;
+        for (size_t i = 0; i < current.results.size(); ++i) {
+            const BenchResult& cur = current.results[i];
+            BenchComparison row;
+            row.key = cur.key();
+            row.currentMedian = cur.stats.median;
+            
+            std::map<std::string, const BenchResult*>::const_iterator it = baseline.find(row.key);
+            if (it == baseline.end()) {
+                row.verdict = BenchComparison::NEW;
+                rows.push_back(row);
+                continue;
+            }
+            const BenchResult& old = *it->second;
+            row.baseMedian = old.stats.median;
+            row.change = row.baseMedian > 0 ? row.currentMedian / row.baseMedian - 1 : 0.0;
+            
+            if (old.samples.size() < 2 || cur.samples.size() < 2) {
+                row.verdict = BenchComparison::TOO_FEW;
+                rows.push_back(row);
+                continue;
+            }
+            row.pValue = mannWhitneyP(old.samples, cur.samples);
+            bootstrapRatio(old.samples, cur.samples, options.resamples, options.seed + i, 0.95,
+                           &row.ciLow, &row.ciHigh);
+            row.ciLow -= 1;
+            row.ciHigh -= 1;
+            
+            double limit = options.thresholdPct / 100;
+            if (row.pValue < options.alpha && row.change > limit) {
+                row.verdict = BenchComparison::SLOWER;
+            } else if (row.pValue < options.alpha && row.change < -limit) {
+                row.verdict = BenchComparison::FASTER;
+            }
+            rows.push_back(row);
+        }
+        return rows;
+    }
+    
+    std::vector<std::string> environmentDiff(const BenchRun& base, const BenchRun& current) {
+        static const char* const KEYS[] = {
+            "cpu", "cores", "os", "compiler", "build", "trace", "seed"
+        };
+        std::vector<std::string> lines;
+        for (size_t i = 0; i < sizeof(KEYS) / sizeof(KEYS[0]); ++i) {
+            std::string before = base.contextValue(KEYS[i]);
+            std::string after = current.contextValue(KEYS[i]);
+            if (!before.empty() && !after.empty() && before != after) {
+                lines.push_back(std::string(KEYS[i]) + "：基线 " + before + "，当前 " + after);
+            }
+        }
+        return lines;
+    }
+    
+    std::string format(const std::vector<BenchComparison>& rows, const CompareOptions& options) {
+        std::ostringstream oss;
+        oss << Bench::pad("基准", 28, true) << Bench::pad("基线", 12, false)
+            << Bench::pad("当前", 12, false) << Bench::pad("变化", 10, false)
+            << Bench::pad("95% 置信区间", 22, false) << Bench::pad("p 值", 9, false)
+            << "  结论\n";
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const BenchComparison& row = rows[i];
+            bool compared = row.verdict != BenchComparison::NEW;
+            bool tested = compared && row.verdict != BenchComparison::TOO_FEW;
+            char p[16];
+            std::snprintf(p, sizeof(p), "%.4f", row.pValue);
+            oss << Bench::pad(row.key, 28, true)
+                << Bench::pad(compared ? Bench::formatNanos(row.baseMedian) : "-", 12, false)
+                << Bench::pad(Bench::formatNanos(row.currentMedian), 12, false)
+                << Bench::pad(compared ? percent(row.change) : "-", 10, false)
+                << Bench::pad(tested ? "[" + percent(row.ciLow) + ", " + percent(row.ciHigh) + "]"
+                                     : "-", 22, false)
+                << Bench::pad(tested ? p : "-", 9, false)
+                << "  " << verdictLabel(row.verdict) << "\n";
+        }
+        char summary[160];
+        std::snprintf(summary, sizeof(summary),
+                      "变慢 %zu 个，变快 %zu 个，持平 %zu 个（阈值 ±%.1f%%，显著性水平 %.2f）\n",
+                      count(rows, BenchComparison::SLOWER), count(rows, BenchComparison::FASTER),
+                      count(rows, BenchComparison::SAME), options.thresholdPct, options.alpha);
+        oss << summary;
+        return oss.str();
+    }
+    
+    size_t count(const std::vector<BenchComparison>& rows, BenchComparison::Verdict verdict) {
+        size_t n = 0;
+        for (size_t i = 0; i < rows.size(); ++i) {
+            n += rows[i].verdict == verdict;
+        }
+        return n;
+    }
+}
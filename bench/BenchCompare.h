@@ -0,0 +1,92 @@
+#ifndef BENCH_COMPARE_H
+#define BENCH_COMPARE_H
+
+#include "BenchHarness.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * 一次基准运行（读自结果 JSON 或刚跑完的 BenchRunner）
+ */
+struct BenchRun {
+    std::vector<std::pair<std::string, std::string> > context;
+    std::vector<BenchResult> results;
+    
+    // context 中 key 的值，不存在时返回空串
+    std::string contextValue(const std::string& key) const;
+};
+
+/**
+ * 比较参数
+ */
+struct CompareOptions {
+    double thresholdPct;    // 中位数变化超过该百分比且统计显著才算回归 / 改进
+    double alpha;           // Mann–Whitney U 检验的显著性水平
+    unsigned resamples;     // 自助法重抽样次数
+    std::uint64_t seed;     // 重抽样的种子（固定，报告可复现）
+    
+    CompareOptions() : thresholdPct(5.0), alpha(0.05), resamples(2000), seed(1) {}
+};
+
+/**
+ * 单个基准的对比结果
+ */
+struct BenchComparison {
+    enum Verdict {
+        SAME,           // 无显著变化或变化在阈值内
+        SLOWER,         // 回归
+        FASTER,         // 改进
+        NEW,            // 基线中没有
+        TOO_FEW         // 样本不足，无法检验
+    };
+    
+    std::string key;        // "name/size"
+    double baseMedian;      // 纳秒
+    double currentMedian;
+    double change;          // 中位数之比减 1（0.1 为慢 10%）
+    double ciLow;           // 中位数之比减 1 的 95% 自助法置信区间
+    double ciHigh;
+    double pValue;          // 双侧 Mann–Whitney U 检验
+    Verdict verdict;
+    
+    BenchComparison()
+        : baseMedian(0), currentMedian(0), change(0), ciLow(0), ciHigh(0),
+          pValue(1), verdict(SAME) {}
+};
+
+namespace BenchCompare {
+    /**
+     * 读取 platecore_bench --json 写出的结果
+     * @return 文件无法打开或格式不符时返回 false，error 给出原因
+     */
+    bool readJson(const std::string& filename, BenchRun& run, std::string* error);
+    
+    /**
+     * 双侧 Mann–Whitney U 检验的 p 值
+     * 两组都不超过 20 个样本且没有并列时用精确分布，否则用带并列修正的正态近似
+     */
+    double mannWhitneyP(const std::vector<double>& a, const std::vector<double>& b);
+    
+    /**
+     * 中位数之比 median(current) / median(base) 的自助法百分位置信区间
+     */
+    void bootstrapRatio(const std::vector<double>& base, const std::vector<double>& current,
+                        unsigned resamples, std::uint64_t seed, double level,
+                        double* low, double* high);
+    
+    // 按 key 对比 current 中的每个基准（基线中多出的基准忽略）
+    std::vector<BenchComparison> compare(const BenchRun& base, const BenchRun& current,
+                                         const CompareOptions& options);
+    
+    // 影响可比性的环境差异（CPU、核数、编译器、构建类型、种子等），每项一行
+    std::vector<std::string> environmentDiff(const BenchRun& base, const BenchRun& current);
+    
+    // 对比表
+    std::string format(const std::vector<BenchComparison>& rows, const CompareOptions& options);
+    
+    size_t count(const std::vector<BenchComparison>& rows, BenchComparison::Verdict verdict);
+}
+
+#endif // BENCH_COMPARE_H
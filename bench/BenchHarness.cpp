@@ -0,0 +1,428 @@
+#include "BenchHarness.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifdef __unix__
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+// 由 CMake 在配置时传入；手工编译时为空
+#ifndef PLATE_BENCH_BUILD_TYPE
+#define PLATE_BENCH_BUILD_TYPE ""
+#endif
+#ifndef PLATE_BENCH_GIT_COMMIT
+#define PLATE_BENCH_GIT_COMMIT "unknown"
+#endif
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+    
+    double elapsedNanos(Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+    
+    // 连续执行 body iterations 次，返回总耗时（纳秒）
+    double timeBody(const std::function<void()>& body, size_t iterations) {
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        return elapsedNanos(start);
+    }
+    
+    void appendEscaped(std::string& out, const std::string& text) {
+        for (size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+            if (c == '"' || c == '\\') {
+                out += '\\';
+            }
+            out += c;
+        }
+    }
+    
+    std::string number(double value) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6g", value);
+        return buf;
+    }
+    
+    // 计数器列：无效时显示 "-"
+    std::string counterCell(double value, const char* format) {
+        if (value < 0) {
+            return "-";
+        }
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), format, value);
+        return buf;
+    }
+    
+    const PerfCounters::Event MISS_COLUMNS[] = {
+        PerfCounters::L1D_MISSES, PerfCounters::LLC_MISSES, PerfCounters::BRANCH_MISSES
+    };
+}
+
+BenchStats BenchStats::of(const std::vector<double>& samples) {
+    BenchStats s;
+    if (samples.empty()) {
+        return s;
+    }
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    s.min = sorted.front();
+    s.max = sorted.back();
+    s.median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += sorted[i];
+    }
+    s.mean = sum / n;
+    if (n > 1) {
+        double sq = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sq += (sorted[i] - s.mean) * (sorted[i] - s.mean);
+        }
+        s.stddev = std::sqrt(sq / (n - 1));
+    }
+    return s;
+}
+
+std::string BenchResult::key() const {
+    return name + "/" + Bench::formatSize(size);
+}
+
+BenchRunner::BenchRunner(const BenchOptions& options, std::ostream& o)
+    : opts(options), out(o) {
+    if (opts.counters && !perf.open()) {
+        out << "硬件计数器不可用，只报告耗时：" << perf.reason() << "\n";
+    }
+}
+
+bool BenchRunner::selected(const std::string& name) const {
+    return opts.filter.empty() || name.find(opts.filter) != std::string::npos;
+}
+
+void BenchRunner::printHeader() const {
+    out << Bench::pad("基准", 24, true) << Bench::pad("规模", 8, true)
+        << Bench::pad("中位数", 12, false) << Bench::pad("最小", 12, false)
+        << Bench::pad("波动", 9, false) << Bench::pad("每条目", 14, false)
+        << Bench::pad("条目/秒", 16, false);
+    if (countersActive()) {
+        out << Bench::pad("IPC", 7, false) << Bench::pad("L1缺失/条", 12, false)
+            << Bench::pad("LLC缺失/条", 12, false) << Bench::pad("分支失误/条", 13, false);
+    }
+    out << "\n";
+}
+
+void BenchRunner::run(const std::string& name, size_t size, size_t items,
+                      const std::function<void()>& setup, const std::function<void()>& body) {
+    if (!selected(name)) {
+        return;
+    }
+    
+    BenchResult result;
+    result.name = name;
+    result.size = size;
+    result.items = items;
+    
+    // 预热；没有 setup 时顺便校准每个样本的执行次数
+    size_t iterations = 1;
+    for (unsigned w = 0; w < opts.warmup; ++w) {
+        if (setup) setup();
+        double ns = timeBody(body, 1);
+        if (!setup && ns > 0) {
+            double target = opts.minSampleMs * 1e6;
+            iterations = std::max<size_t>(1, static_cast<size_t>(target / ns));
+        }
+    }
+    result.iterations = iterations;
+    
+    bool counting = countersActive();
+    for (unsigned r = 0; r < opts.repetitions; ++r) {
+        if (setup) setup();
+        if (counting) perf.start();
+        result.samples.push_back(timeBody(body, iterations) / iterations);
+        if (counting) {
+            perf.stop();
+            PerfCounters::Reading reading = perf.read();
+            if (r == 0) {
+                result.counters = reading;
+            } else {
+                result.counters.add(reading);
+            }
+        }
+    }
+    result.stats = BenchStats::of(result.samples);
+    if (counting) {
+        double executions = static_cast<double>(opts.repetitions) * iterations;
+        for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+            result.counters.values[e] /= executions;
+        }
+    }
+    
+    char cv[16];
+    char rate[32];
+    std::snprintf(cv, sizeof(cv), "%.1f%%", result.stats.cv() * 100);
+    std::snprintf(rate, sizeof(rate), "%.0f", result.itemsPerSecond());
+    out << Bench::pad(name, 24, true) << Bench::pad(Bench::formatSize(size), 8, true)
+        << Bench::pad(Bench::formatNanos(result.stats.median), 12, false)
+        << Bench::pad(Bench::formatNanos(result.stats.min), 12, false)
+        << Bench::pad(cv, 9, false)
+        << Bench::pad(Bench::formatNanos(result.nsPerItem()), 14, false)
+        << Bench::pad(rate, 16, false);
+    if (counting) {
+        double ipc = result.counters.ipc();
+        out << Bench::pad(counterCell(ipc > 0 ? ipc : -1.0, "%.2f"), 7, false);
+        for (size_t i = 0; i < sizeof(MISS_COLUMNS) / sizeof(MISS_COLUMNS[0]); ++i) {
+            out << Bench::pad(counterCell(result.perItem(MISS_COLUMNS[i]), "%.3f"),
+                              i == 2 ? 13 : 12, false);
+        }
+    }
+    out << "\n";
+    out.flush();
+    all.push_back(result);
+}
+
+std::vector<std::pair<std::string, std::string> > BenchRunner::context() const {
+    std::vector<std::pair<std::string, std::string> > ctx;
+    ctx.push_back(std::make_pair("seed", std::to_string(opts.seed)));
+    ctx.push_back(std::make_pair("warmup", std::to_string(opts.warmup)));
+    ctx.push_back(std::make_pair("repetitions", std::to_string(opts.repetitions)));
+    std::vector<std::pair<std::string, std::string> > env = Bench::environment();
+    ctx.insert(ctx.end(), env.begin(), env.end());
+    return ctx;
+}
+
+std::string BenchRunner::toJson() const {
+    std::vector<std::pair<std::string, std::string> > ctx = context();
+    std::string json = "{\n  \"context\": {";
+    for (size_t i = 0; i < ctx.size(); ++i) {
+        json += i ? ",\n    \"" : "\n    \"";
+        json += ctx[i].first + "\": ";
+        // 纯数字写成数值，其余写成字符串
+        const std::string& value = ctx[i].second;
+        if (!value.empty() && value.find_first_not_of("0123456789") == std::string::npos) {
+            json += value;
+        } else {
+            json += '"';
+            appendEscaped(json, value);
+            json += '"';
+        }
+    }
+    json += "\n  },\n";
+    json += "  \"benchmarks\": [";
+    for (size_t i = 0; i < all.size(); ++i) {
+        const BenchResult& r = all[i];
+        json += i ? ",\n    {" : "\n    {";
+        json += "\"name\": \"";
+        appendEscaped(json, r.name);
+        json += "\", \"size\": " + std::to_string(r.size);
+        json += ", \"items\": " + std::to_string(r.items);
+        json += ", \"iterations\": " + std::to_string(r.iterations);
+        json += ", \"median_ns\": " + number(r.stats.median);
+        json += ", \"mean_ns\": " + number(r.stats.mean);
+        json += ", \"min_ns\": " + number(r.stats.min);
+        json += ", \"max_ns\": " + number(r.stats.max);
+        json += ", \"stddev_ns\": " + number(r.stats.stddev);
+        json += ", \"ns_per_item\": " + number(r.nsPerItem());
+        json += ", \"samples_ns\": [";
+        for (size_t j = 0; j < r.samples.size(); ++j) {
+            if (j) json += ", ";
+            json += number(r.samples[j]);
+        }
+        json += "]";
+        if (r.counters.any()) {
+            // 每次执行的事件数、每条目的事件数与 IPC；无效的事件不输出
+            json += ", \"counters\": {";
+            bool first = true;
+            for (int e = 0; e < PerfCounters::EVENT_COUNT; ++e) {
+                PerfCounters::Event ev = static_cast<PerfCounters::Event>(e);
+                if (!r.counters.valid[e]) {
+                    continue;
+                }
+                json += first ? "\"" : ", \"";
+                json += PerfCounters::name(ev);
+                json += "\": " + number(r.counters.values[e]);
+                json += ", \"" + std::string(PerfCounters::name(ev)) + "_per_item\": " +
+                        number(r.perItem(ev));
+                first = false;
+            }
+            if (r.counters.ipc() > 0) {
+                json += ", \"ipc\": " + number(r.counters.ipc());
+            }
+            json += "}";
+        }
+        json += "}";
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+bool BenchRunner::writeJson(const std::string& filename) const {
+    std::ofstream fout(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!fout) {
+        std::cerr << "无法创建结果文件：" << filename << std::endl;
+        return false;
+    }
+    fout << toJson();
+    return static_cast<bool>(fout);
+}
+
+namespace Bench {
+    std::string pad(const std::string& text, size_t width, bool left) {
+        size_t shown = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c < 0x80) {
+                shown += 1;
+            } else if (c >= 0xE0) {
+                shown += 2;     // 三字节及以上的 UTF-8 序列按全角计
+            } else if (c >= 0xC0) {
+                shown += 1;
+            }
+        }
+        std::string fill(shown < width ? width - shown : 0, ' ');
+        return left ? text + fill : fill + text;
+    }
+    
+    std::vector<std::pair<std::string, std::string> > environment() {
+        std::vector<std::pair<std::string, std::string> > env;
+        
+        std::string host = "unknown";
+        std::string os = "unknown";
+#ifdef __unix__
+        char name[256] = {0};
+        if (gethostname(name, sizeof(name) - 1) == 0) {
+            host = name;
+        }
+        struct utsname uts;
+        if (uname(&uts) == 0) {
+            os = std::string(uts.sysname) + " " + uts.release + " " + uts.machine;
+        }
+#endif
+        env.push_back(std::make_pair("host", host));
+        
+        std::string cpu = "unknown";
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 10, "model name") == 0) {
+                size_t colon = line.find(':');
+                if (colon != std::string::npos) {
+                    cpu = line.substr(line.find_first_not_of(' ', colon + 1));
+                }
+                break;
+            }
+        }
+        env.push_back(std::make_pair("cpu", cpu));
+        env.push_back(std::make_pair("cores", std::to_string(std::thread::hardware_concurrency())));
+        env.push_back(std::make_pair("os", os));
+        
+#if defined(__clang__)
+        env.push_back(std::make_pair("compiler", std::string("clang ") + __clang_version__));
+#elif defined(__GNUC__)
+        env.push_back(std::make_pair("compiler", std::string("gcc ") + __VERSION__));
+#elif defined(_MSC_VER)
+        env.push_back(std::make_pair("compiler", "msvc " + std::to_string(_MSC_VER)));
+#else
+        env.push_back(std::make_pair("compiler", std::string("unknown")));
+#endif
+        
+        std::string build = PLATE_BENCH_BUILD_TYPE;
+        if (build.empty()) {
+            build = "unspecified";
+        }
+#ifdef NDEBUG
+        build += " (NDEBUG)";
+#endif
+        env.push_back(std::make_pair("build", build));
+#ifdef PLATE_TRACE_DISABLED
+        env.push_back(std::make_pair("trace", std::string("off")));
+#else
+        env.push_back(std::make_pair("trace", std::string("on")));
+#endif
+        env.push_back(std::make_pair("commit", std::string(PLATE_BENCH_GIT_COMMIT)));
+        
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        env.push_back(std::make_pair("date", std::string(date)));
+        return env;
+    }
+    
+    void keep(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(p) : "memory");
+#else
+        static const void* volatile sink;
+        sink = p;
+#endif
+    }
+    
+    size_t parseSize(const std::string& text) {
+        if (text.empty()) {
+            return 0;
+        }
+        char* end = nullptr;
+        double value = std::strtod(text.c_str(), &end);
+        double scale = 1;
+        if (*end == 'k' || *end == 'K') {
+            scale = 1e3;
+            ++end;
+        } else if (*end == 'm' || *end == 'M') {
+            scale = 1e6;
+            ++end;
+        }
+        if (*end != '\0' || value <= 0) {
+            return 0;
+        }
+        return static_cast<size_t>(value * scale + 0.5);
+    }
+    
+    std::vector<size_t> parseSizes(const std::string& text) {
+        std::vector<size_t> sizes;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            size_t n = parseSize(item);
+            if (n == 0) {
+                return std::vector<size_t>();
+            }
+            sizes.push_back(n);
+        }
+        return sizes;
+    }
+    
+    std::string formatSize(size_t size) {
+        if (size >= 1000000 && size % 1000000 == 0) {
+            return std::to_string(size / 1000000) + "M";
+        }
+        if (size >= 1000 && size % 1000 == 0) {
+            return std::to_string(size / 1000) + "K";
+        }
+        return std::to_string(size);
+    }
+    
+    std::string formatNanos(double nanos) {
+        char buf[32];
+        if (nanos < 1e3) {
+            std::snprintf(buf, sizeof(buf), "%.1f ns", nanos);
+        } else if (nanos < 1e6) {
+            std::snprintf(buf, sizeof(buf), "%.2f us", nanos / 1e3);
+        } else if (nanos < 1e9) {
+            std::snprintf(buf, sizeof(buf), "%.2f ms", nanos / 1e6);
+        } else {
+            std::snprintf(buf, sizeof(buf), "%.2f s", nanos / 1e9);
+        }
+        return buf;
+    }
+}
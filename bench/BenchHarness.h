@@ -0,0 +1,156 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include "PerfCounters.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * 一组耗时样本的统计量（纳秒）
+ */
+struct BenchStats {
+    double min;
+    double median;
+    double mean;
+    double stddev;
+    double max;
+    
+    BenchStats() : min(0), median(0), mean(0), stddev(0), max(0) {}
+    
+    static BenchStats of(const std::vector<double>& samples);
+    
+    // 变异系数（标准差 / 均值）
+    double cv() const { return mean > 0 ? stddev / mean : 0.0; }
+};
+
+/**
+ * 单个基准在某个数据规模下的结果
+ * 每个样本是一次测量中被测代码单次执行的平均耗时
+ */
+struct BenchResult {
+    std::string name;               // 基准名，如 "radix_sort"
+    size_t size;                    // 数据规模（记录数）
+    size_t items;                   // 单次执行处理的条目数（记录数或查询数）
+    size_t iterations;              // 每个样本内连续执行的次数
+    std::vector<double> samples;    // 各次重复的耗时（纳秒 / 次）
+    BenchStats stats;
+    PerfCounters::Reading counters; // 各次重复平均到单次执行的硬件计数（未开启时全部无效）
+    
+    BenchResult() : size(0), items(0), iterations(1) {}
+    
+    // 以中位数计的每条目耗时与吞吐
+    double nsPerItem() const { return items ? stats.median / items : 0.0; }
+    double itemsPerSecond() const { return stats.median > 0 ? items * 1e9 / stats.median : 0.0; }
+    
+    // 每条目的事件数（如每条记录的缓存缺失）；事件无效时返回负数
+    double perItem(PerfCounters::Event e) const {
+        return counters.valid[e] && items ? counters.values[e] / items : -1.0;
+    }
+    
+    // 基准的唯一键 "name/size"，用于跨版本对比
+    std::string key() const;
+};
+
+/**
+ * 运行参数
+ */
+struct BenchOptions {
+    unsigned warmup;                // 预热次数（不计入结果）
+    unsigned repetitions;           // 计入结果的重复次数
+    double minSampleMs;             // 无需准备的基准每个样本至少运行的毫秒数
+    std::vector<size_t> sizes;      // 数据规模
+    std::string filter;             // 只运行名称包含该子串的基准（为空时全部运行）
+    std::string jsonPath;           // 结果 JSON 输出路径（为空时不输出）
+    std::uint64_t seed;             // 数据与查询的种子，跨版本固定才有可比性
+    bool counters;                  // 在测量区间读取硬件性能计数器
+    
+    BenchOptions()
+        : warmup(1), repetitions(5), minSampleMs(5.0), seed(20240601), counters(false) {}
+};
+
+/**
+ * 无依赖的基准测试执行器
+ * 每个基准先预热，再重复测量若干次；setup 在每次执行前运行且不计时
+ * （用于恢复被测代码会修改的输入，如待排序的数组）。没有 setup 的基准
+ * 在预热时按 minSampleMs 校准每个样本内的执行次数，避免计时器精度淹没短操作。
+ * 开启 counters 时每次测量前后启停 PerfCounters（不含 setup），结果表追加 IPC 与
+ * 每条目的缓存缺失、分支预测失误；计数器不可用时打印一次原因，只报告耗时。
+ */
+class BenchRunner {
+public:
+    BenchRunner(const BenchOptions& options, std::ostream& out);
+    
+    const BenchOptions& options() const { return opts; }
+    
+    // 硬件计数器是否在工作
+    bool countersActive() const { return opts.counters && perf.available(); }
+    
+    // 名称是否匹配过滤条件
+    bool selected(const std::string& name) const;
+    
+    /**
+     * 运行一个基准并打印一行结果
+     * @param items 单次执行处理的条目数，用于计算每条目耗时与吞吐
+     */
+    void run(const std::string& name, size_t size, size_t items,
+             const std::function<void()>& setup, const std::function<void()>& body);
+    
+    const std::vector<BenchResult>& results() const { return all; }
+    
+    // 运行参数与 Bench::environment()，写入结果 JSON 的 context
+    std::vector<std::pair<std::string, std::string> > context() const;
+    
+    // 打印表头（run 之前调用一次）
+    void printHeader() const;
+    
+    /**
+     * 结果 JSON：{"context": {...}, "benchmarks": [{name, size, items, iterations,
+     * samples_ns, median_ns, ..., counters: {cycles, ..., ipc}}]}
+     */
+    std::string toJson() const;
+    bool writeJson(const std::string& filename) const;
+
+private:
+    BenchOptions opts;
+    std::ostream& out;
+    std::vector<BenchResult> all;
+    PerfCounters perf;
+};
+
+namespace Bench {
+    // 阻止编译器把结果未被使用的被测代码优化掉
+    void keep(const void* p);
+    
+    template <typename T>
+    inline void keep(const T& value) {
+        keep(static_cast<const void*>(&value));
+    }
+    
+    // 解析 "1K"、"10k"、"2M"、"500" 形式的规模，失败时返回 0
+    size_t parseSize(const std::string& text);
+    
+    // 逗号分隔的规模列表
+    std::vector<size_t> parseSizes(const std::string& text);
+    
+    // 规模的简写（1000 → "1K"，50000000 → "50M"）
+    std::string formatSize(size_t size);
+    
+    // 纳秒的带单位文本
+    std::string formatNanos(double nanos);
+    
+    // 按显示宽度左 / 右对齐（中文字符占两列）
+    std::string pad(const std::string& text, size_t width, bool left);
+    
+    /**
+     * 运行环境：主机、CPU、核数、系统、编译器、构建类型、追踪开关、
+     * 配置时的 git 提交和运行时间（UTC），用于判断两次结果是否可比
+     */
+    std::vector<std::pair<std::string, std::string> > environment();
+}
+
+#endif // BENCH_HARNESS_H
@@ -0,0 +1,442 @@
+#include "LoadDriver.h"
+#include "BenchHarness.h"
+#include "../include/DataGenerator.h"
+#include "../include/PlateDatabase.h"
+#include "../include/Utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+    
+    const char* const OP_NAMES[LOAD_OP_COUNT] = {
+        "exact", "prefix", "city", "fuzzy", "add", "modify", "delete"
+    };
+    const char* const OP_LABELS[LOAD_OP_COUNT] = {
+        "精确查找", "前缀查找", "城市查找", "模糊查找", "新增", "修改", "删除"
+    };
+    
+    // 开环模式中发出延迟超过该值即计为积压
+    const std::uint64_t LATE_NANOS = 1000000;
+    
+    // 车牌编号可用的字符（不含 I、O）
+    const char SERIAL_CHARS[] = "0123456789ABCDEFGHJKLMNPQRSTUVWXYZ";
+    
+    std::uint64_t nanosBetween(Clock::time_point from, Clock::time_point to) {
+        return to > from
+            ? static_cast<std::uint64_t>(
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count())
+            : 0;
+    }
+    
+    void recordLatency(OperationStats& s, std::uint64_t nanos) {
+        s.calls++;
+        s.items++;
+        s.samples++;
+        s.sampledItems++;
+        s.totalNanos += nanos;
+        s.maxNanos = std::max(s.maxNanos, nanos);
+        s.histogram.add(LatencyHistogram::bucketOf(nanos), 1);
+    }
+    
+    void mergeStats(OperationStats& into, const OperationStats& from) {
+        into.calls += from.calls;
+        into.items += from.items;
+        into.samples += from.samples;
+        into.sampledItems += from.sampledItems;
+        into.totalNanos += from.totalNanos;
+        into.maxNanos = std::max(into.maxNanos, from.maxNanos);
+        for (size_t b = 0; b < LatencyHistogram::BUCKET_COUNT; ++b) {
+            if (from.histogram.bucket(b)) {
+                into.histogram.add(b, from.histogram.bucket(b));
+            }
+        }
+    }
+    
+    // 需要的参数个数（车牌 / 前缀 / 城市；新增、修改另加城市和车主）
+    size_t argumentCount(LoadOp op) {
+        return op == LOAD_ADD || op == LOAD_MODIFY ? 3 : 1;
+    }
+}
+
+struct LoadDriver::Schedule {
+    Clock::time_point start;            // 第 0 个请求的计划发出时刻
+    Clock::time_point measureStart;     // 预热结束
+    Clock::time_point end;              // 不再发出新请求
+    std::atomic<std::uint64_t> next;    // 闭环模式的共享序号
+    
+    Schedule() : next(0) {}
+};
+
+struct LoadDriver::Worker {
+    OperationStats ops[LOAD_OP_COUNT];
+    std::uint64_t failures[LOAD_OP_COUNT];
+    std::uint64_t lateStarts;
+    std::uint64_t maxLagNanos;
+    Clock::time_point lastDone;     // 最后一个计入结果的请求完成的时刻
+    
+    Worker() : lateStarts(0), maxLagNanos(0) {
+        std::fill(failures, failures + LOAD_OP_COUNT, 0);
+    }
+};
+
+LoadResult::LoadResult()
+    : elapsedSec(0.0), lateStarts(0), maxLagNanos(0), publishes(0),
+      openLoop(false), targetRate(0.0) {
+    std::fill(failures, failures + LOAD_OP_COUNT, 0);
+}
+
+std::uint64_t LoadResult::totalCalls() const {
+    std::uint64_t total = 0;
+    for (int op = 0; op < LOAD_OP_COUNT; ++op) {
+        total += ops[op].calls;
+    }
+    return total;
+}
+
+double LoadResult::qps(LoadOp op) const {
+    return elapsedSec > 0 ? ops[op].calls / elapsedSec : 0.0;
+}
+
+double LoadResult::totalQps() const {
+    return elapsedSec > 0 ? totalCalls() / elapsedSec : 0.0;
+}
+
+std::string LoadResult::toString() const {
+    std::ostringstream oss;
+    char line[160];
+    
+    oss << Bench::pad("操作", 12, true) << Bench::pad("次数", 12, false)
+        << Bench::pad("失败", 8, false) << Bench::pad("次/秒", 12, false)
+        << Bench::pad("平均", 12, false) << Bench::pad("p50", 12, false)
+        << Bench::pad("p99", 12, false) << Bench::pad("p999", 12, false)
+        << Bench::pad("最大", 12, false) << "\n";
+    
+    OperationStats all;
+    for (int op = 0; op < LOAD_OP_COUNT; ++op) {
+        mergeStats(all, ops[op]);
+    }
+    for (int op = 0; op <= LOAD_OP_COUNT; ++op) {
+        bool total = op == LOAD_OP_COUNT;
+        const OperationStats& s = total ? all : ops[op];
+        if (!total && s.calls == 0) {
+            continue;
+        }
+        std::uint64_t failed = 0;
+        for (int f = 0; f < LOAD_OP_COUNT; ++f) {
+            failed += (total || f == op) ? failures[f] : 0;
+        }
+        std::snprintf(line, sizeof(line), "%.0f",
+                      total ? totalQps() : qps(static_cast<LoadOp>(op)));
+        const char* label = total ? "合计" : LoadDriver::opLabel(static_cast<LoadOp>(op));
+        oss << Bench::pad(label, 12, true)
+            << Bench::pad(std::to_string(s.calls), 12, false)
+            << Bench::pad(std::to_string(failed), 8, false)
+            << Bench::pad(line, 12, false)
+            << Bench::pad(Bench::formatNanos(s.meanNanos()), 12, false)
+            << Bench::pad(Bench::formatNanos(s.percentile(0.50)), 12, false)
+            << Bench::pad(Bench::formatNanos(s.percentile(0.99)), 12, false)
+            << Bench::pad(Bench::formatNanos(s.percentile(0.999)), 12, false)
+            << Bench::pad(Bench::formatNanos(static_cast<double>(s.maxNanos)), 12, false)
+            << "\n";
+    }
+    
+    std::snprintf(line, sizeof(line), "计入时长 %.2f 秒，吞吐 %.0f 次/秒", elapsedSec, totalQps());
+    oss << line;
+    if (openLoop) {
+        std::snprintf(line, sizeof(line), "（目标 %.0f 次/秒）", targetRate);
+        oss << line;
+    }
+    oss << "，期间发布快照 " << publishes << " 个\n";
+    if (openLoop) {
+        oss << "发出延迟超过 1 毫秒的请求：" << lateStarts << "，最大发出延迟："
+            << Bench::formatNanos(static_cast<double>(maxLagNanos));
+        if (totalQps() < targetRate * 0.95) {
+            oss << "（跟不上目标到达率，延迟已包含排队时间）";
+        }
+        oss << "\n";
+    }
+    return oss.str();
+}
+
+LoadDriver::LoadDriver(PlateDatabase& database, const LoadOptions& options)
+    : db(database), opts(options) {
+    if (opts.threads == 0) {
+        opts.threads = 1;
+    }
+}
+
+const char* LoadDriver::opName(LoadOp op) {
+    return OP_NAMES[op];
+}
+
+const char* LoadDriver::opLabel(LoadOp op) {
+    return OP_LABELS[op];
+}
+
+bool LoadDriver::parseOp(const std::string& name, LoadOp* op) {
+    for (int i = 0; i < LOAD_OP_COUNT; ++i) {
+        if (name == OP_NAMES[i]) {
+            *op = static_cast<LoadOp>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LoadDriver::execute(const LoadRequest& req) {
+    switch (req.op) {
+        case LOAD_EXACT:
+            db.findRecord(req.key);
+            return false;
+        case LOAD_PREFIX:
+            db.prefixSearch(req.key);
+            return false;
+        case LOAD_CITY:
+            db.searchByCity(req.key);
+            return false;
+        case LOAD_FUZZY:
+            // 没有精确匹配时列出只差最后一位的候选
+            if (db.findRecord(req.key) < 0 && req.key.size() > 1) {
+                db.prefixSearch(req.key.substr(0, req.key.size() - 1));
+            }
+            return false;
+        case LOAD_ADD:
+            return !db.addRecord(req.key, req.city, req.owner);
+        case LOAD_MODIFY:
+            return !db.modifyRecord(req.key, req.city, req.owner);
+        case LOAD_DELETE:
+            return !db.deleteRecord(req.key);
+        default:
+            return false;
+    }
+}
+
+void LoadDriver::clientLoop(unsigned id, Schedule& schedule, Worker& worker) {
+    const size_t n = reqs.size();
+    std::this_thread::sleep_until(schedule.start);
+    
+    for (std::uint64_t k = 0;; ++k) {
+        std::uint64_t i;
+        Clock::time_point intended;
+        if (opts.openLoop) {
+            i = k * opts.threads + id;
+            intended = schedule.start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(i) / opts.rate));
+            if (intended >= schedule.end) {
+                break;
+            }
+            std::this_thread::sleep_until(intended);
+        } else {
+            i = schedule.next.fetch_add(1, std::memory_order_relaxed);
+            intended = Clock::now();
+            if (intended >= schedule.end) {
+                break;
+            }
+        }
+        if (opts.maxOps > 0 && i >= opts.maxOps) {
+            break;
+        }
+        
+        const LoadRequest& req = reqs[i % n];
+        Clock::time_point begin = Clock::now();
+        bool failed = execute(req);
+        Clock::time_point done = Clock::now();
+        
+        if (intended < schedule.measureStart) {
+            continue;
+        }
+        // 开环时从计划时刻算起，排队等待也计入延迟
+        recordLatency(worker.ops[req.op], nanosBetween(intended, done));
+        worker.lastDone = done;
+        if (failed) {
+            worker.failures[req.op]++;
+        }
+        if (opts.openLoop) {
+            std::uint64_t lag = nanosBetween(intended, begin);
+            worker.maxLagNanos = std::max(worker.maxLagNanos, lag);
+            if (lag > LATE_NANOS) {
+                worker.lateStarts++;
+            }
+        }
+    }
+}
+
+LoadResult LoadDriver::run() {
+    LoadResult report;
+    report.openLoop = opts.openLoop;
+    report.targetRate = opts.openLoop ? opts.rate : 0.0;
+    if (reqs.empty() || (opts.openLoop && opts.rate <= 0)) {
+        return report;
+    }
+    
+    std::uint64_t versionBefore = db.snapshot()->version;
+    
+    // 留出线程启动的时间，让各客户端同时开始
+    Schedule schedule;
+    schedule.start = Clock::now() + std::chrono::milliseconds(20);
+    schedule.measureStart = schedule.start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(opts.warmupSec));
+    schedule.end = schedule.measureStart + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(opts.durationSec));
+    
+    std::vector<Worker> workers(opts.threads);
+    std::vector<std::thread> clients;
+    clients.reserve(opts.threads);
+    for (unsigned t = 0; t < opts.threads; ++t) {
+        clients.emplace_back([this, t, &schedule, &workers]() {
+            clientLoop(t, schedule, workers[t]);
+        });
+    }
+    for (auto& c : clients) {
+        c.join();
+    }
+    
+    // 时长算到最后一个请求完成：开环时积压的请求在计划结束后才完成，
+    // 吞吐按实际完成速度计；达到 maxOps 时可能提前结束
+    Clock::time_point finished = schedule.measureStart;
+    for (const Worker& w : workers) {
+        finished = std::max(finished, w.lastDone);
+    }
+    report.elapsedSec = std::chrono::duration<double>(finished - schedule.measureStart).count();
+    for (const Worker& w : workers) {
+        for (int op = 0; op < LOAD_OP_COUNT; ++op) {
+            mergeStats(report.ops[op], w.ops[op]);
+            report.failures[op] += w.failures[op];
+        }
+        report.lateStarts += w.lateStarts;
+        report.maxLagNanos = std::max(report.maxLagNanos, w.maxLagNanos);
+    }
+    report.publishes = db.snapshot()->version - versionBefore;
+    return report;
+}
+
+bool LoadDriver::readLog(const std::string& filename, std::vector<LoadRequest>& out,
+                         std::string* error) {
+    std::ifstream fin(filename.c_str());
+    if (!fin) {
+        if (error) *error = "无法打开查询日志：" + filename;
+        return false;
+    }
+    
+    std::string line;
+    size_t lineNo = 0;
+    while (std::getline(fin, line)) {
+        ++lineNo;
+        std::vector<std::string> fields = Utils::split(line);
+        if (fields.empty() || fields[0][0] == '#') {
+            continue;
+        }
+        LoadRequest req;
+        if (!parseOp(fields[0], &req.op)) {
+            if (error) *error = "第 " + std::to_string(lineNo) + " 行：未知操作 " + fields[0];
+            return false;
+        }
+        if (fields.size() != 1 + argumentCount(req.op)) {
+            if (error) *error = "第 " + std::to_string(lineNo) + " 行：参数个数不对";
+            return false;
+        }
+        req.key = fields[1];
+        if (fields.size() > 2) {
+            req.city = fields[2];
+            req.owner = fields[3];
+        }
+        out.push_back(req);
+    }
+    return true;
+}
+
+bool LoadDriver::writeLog(const std::string& filename, const std::vector<LoadRequest>& requests) {
+    std::ofstream fout(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!fout) {
+        return false;
+    }
+    for (const auto& req : requests) {
+        fout << OP_NAMES[req.op] << ' ' << req.key;
+        if (argumentCount(req.op) > 1) {
+            fout << ' ' << req.city << ' ' << req.owner;
+        }
+        fout << '\n';
+    }
+    return static_cast<bool>(fout);
+}
+
+std::vector<LoadRequest> LoadDriver::synthesize(const std::vector<PlateRecord>& data,
+                                                const LoadMix& mix, std::uint64_t seed,
+                                                size_t count) {
+    std::vector<LoadRequest> out;
+    double queryWeight = mix.exact + mix.prefix + mix.city;
+    double total = queryWeight + mix.fuzzy + mix.mutate;
+    if (count == 0 || total <= 0) {
+        return out;
+    }
+    
+    // 先定每个位置的大类：0 查询（精确 / 前缀 / 城市），1 模糊，2 变更
+    Xoshiro256 rng(seed);
+    std::vector<unsigned char> kinds(count);
+    size_t counts[3] = {0, 0, 0};
+    for (size_t i = 0; i < count; ++i) {
+        double u = rng.uniform() * total;
+        kinds[i] = u < queryWeight ? 0 : u < queryWeight + mix.fuzzy ? 1 : 2;
+        counts[kinds[i]]++;
+    }
+    
+    QueryMixSpec spec;
+    spec.keyZipf = mix.keyZipf;
+    spec.hitRatio = mix.hitRatio;
+    spec.prefixShare = queryWeight > 0 ? mix.prefix / queryWeight : 0.0;
+    spec.cityShare = queryWeight > 0 ? mix.city / queryWeight : 0.0;
+    std::vector<WorkloadQuery> queries =
+        DataGenerator::generateQueries(data, spec, seed + 1, counts[0]);
+    
+    // 模糊查找：取热点车牌，改错最后一位
+    spec.prefixShare = 0;
+    spec.cityShare = 0;
+    spec.hitRatio = 1.0;
+    std::vector<WorkloadQuery> fuzzy =
+        DataGenerator::generateQueries(data, spec, seed + 2, counts[1]);
+    for (auto& q : fuzzy) {
+        char& last = q.key[q.key.size() - 1];
+        char replacement;
+        do {
+            replacement = SERIAL_CHARS[rng.below(sizeof(SERIAL_CHARS) - 1)];
+        } while (replacement == last);
+        last = replacement;
+    }
+    
+    // 变更：不存在的新车牌依次新增、修改、删除
+    spec.hitRatio = 0.0;
+    std::vector<WorkloadQuery> fresh =
+        DataGenerator::generateQueries(data, spec, seed + 3, (counts[2] + 2) / 3);
+    
+    out.reserve(count);
+    size_t nextQuery = 0;
+    size_t nextFuzzy = 0;
+    size_t mutation = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (kinds[i] == 0) {
+            const WorkloadQuery& q = queries[nextQuery++];
+            LoadOp op = q.type == QUERY_PREFIX ? LOAD_PREFIX
+                      : q.type == QUERY_CITY ? LOAD_CITY : LOAD_EXACT;
+            out.push_back(LoadRequest(op, q.key));
+        } else if (kinds[i] == 1) {
+            out.push_back(LoadRequest(LOAD_FUZZY, fuzzy[nextFuzzy++].key));
+        } else {
+            const std::string& plate = fresh[mutation / 3].key;
+            static const LoadOp STEPS[3] = {LOAD_ADD, LOAD_MODIFY, LOAD_DELETE};
+            LoadRequest req(STEPS[mutation % 3], plate);
+            if (req.op != LOAD_DELETE) {
+                req.city = Utils::getCityByPlateLetter(Utils::extractPlateLetter(plate));
+                req.owner = req.op == LOAD_ADD ? "压测新增" : "压测修改";
+            }
+            out.push_back(req);
+            ++mutation;
+        }
+    }
+    return out;
+}
@@ -0,0 +1,149 @@
+#ifndef LOAD_DRIVER_H
+#define LOAD_DRIVER_H
+
+#include "../include/Metrics.h"
+#include "../include/PlateRecord.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class PlateDatabase;
+
+/**
+ * 压测操作类型
+ */
+enum LoadOp {
+    LOAD_EXACT,         // 精确查找（在当前快照上查找，不触发排序）
+    LOAD_PREFIX,        // 前缀查找
+    LOAD_CITY,          // 按城市查找（未建索引时先建索引）
+    LOAD_FUZZY,         // 模糊查找：精确查找未命中时，按去掉末位的前缀找候选
+    LOAD_ADD,           // 新增
+    LOAD_MODIFY,        // 修改
+    LOAD_DELETE,        // 删除
+    LOAD_OP_COUNT
+};
+
+/**
+ * 一条压测请求
+ * 查询日志每行一条：操作名 + 参数，以空白分隔，# 开头为注释
+ *   exact 辽A12345 / prefix 辽A1 / city 沈阳 / fuzzy 辽A1234X
+ *   add 辽A12345 沈阳 张三 / modify 辽A12345 大连 李四 / delete 辽A12345
+ */
+struct LoadRequest {
+    LoadOp op;
+    std::string key;        // 车牌 / 前缀 / 城市名
+    std::string city;       // 新增、修改时的城市
+    std::string owner;      // 新增、修改时的车主
+    
+    LoadRequest() : op(LOAD_EXACT) {}
+    LoadRequest(LoadOp o, const std::string& k) : op(o), key(k) {}
+};
+
+/**
+ * 合成请求的组合（各类操作的相对权重）
+ * 变更按“新增 → 修改 → 删除”轮转同一批新车牌，数据量保持稳定。
+ * 变更使快照失去车牌顺序与城市索引：精确与前缀查找改由随快照发布的车牌读索引完成，
+ * 城市查找在快照上扫描，都不会因默认组合中的变更退化为重排整表或逐条比较车牌
+ */
+struct LoadMix {
+    double exact;
+    double prefix;
+    double city;
+    double fuzzy;
+    double mutate;
+    double hitRatio;        // 精确查找中命中的比例
+    double keyZipf;         // 被查询记录的 Zipf 指数，0 为均匀
+    
+    LoadMix()
+        : exact(85), prefix(5), city(1), fuzzy(5), mutate(4), hitRatio(0.9), keyZipf(0.99) {}
+};
+
+/**
+ * 运行参数
+ */
+struct LoadOptions {
+    unsigned threads;       // 客户端线程数
+    bool openLoop;          // true：按固定到达率发出请求；false：每个线程完成一个再发下一个
+    double rate;            // 开环模式的总到达率（次 / 秒）
+    double durationSec;     // 计入结果的时长
+    double warmupSec;       // 预热时长（不计入结果）
+    std::uint64_t maxOps;   // 最多发出的请求数（含预热），0 为不限
+    
+    LoadOptions()
+        : threads(4), openLoop(false), rate(10000), durationSec(10), warmupSec(1), maxOps(0) {}
+};
+
+/**
+ * 压测结果
+ * 开环模式的延迟从计划发出时刻算起，包含排队等待，不会因客户端被拖慢而低估尾延迟
+ */
+struct LoadResult {
+    OperationStats ops[LOAD_OP_COUNT];
+    std::uint64_t failures[LOAD_OP_COUNT];  // 变更被拒绝（车牌已存在 / 不存在）的次数
+    double elapsedSec;                      // 计入结果的实际时长
+    std::uint64_t lateStarts;               // 开环模式中晚于计划 1 毫秒以上才发出的请求数
+    std::uint64_t maxLagNanos;              // 开环模式中最大的发出延迟
+    std::uint64_t publishes;                // 期间发布的快照数（变更与排序 / 建索引）
+    bool openLoop;
+    double targetRate;
+    
+    LoadResult();
+    
+    std::uint64_t totalCalls() const;
+    
+    // 计入结果的时长内每秒完成的请求数
+    double qps(LoadOp op) const;
+    double totalQps() const;
+    
+    std::string toString() const;
+};
+
+/**
+ * 多线程压测驱动
+ * 闭环时各客户端线程从共享序号依次领取请求；开环时第 i 个请求由线程 i mod N
+ * 在计划时刻 i / rate 发出。请求序列用完后从头循环；每个线程按操作类型记录
+ * 延迟直方图，结束后汇总。
+ */
+class LoadDriver {
+public:
+    LoadDriver(PlateDatabase& db, const LoadOptions& options);
+    
+    void setRequests(const std::vector<LoadRequest>& requests) { reqs = requests; }
+    const std::vector<LoadRequest>& requests() const { return reqs; }
+    
+    LoadResult run();
+    
+    static const char* opName(LoadOp op);      // 日志中的操作名
+    static const char* opLabel(LoadOp op);     // 报告中的中文名
+    static bool parseOp(const std::string& name, LoadOp* op);
+    
+    /**
+     * 读取查询日志
+     * @return 文件无法打开或某行格式错误时返回 false，error 给出行号和原因
+     */
+    static bool readLog(const std::string& filename, std::vector<LoadRequest>& out,
+                        std::string* error);
+    static bool writeLog(const std::string& filename, const std::vector<LoadRequest>& requests);
+    
+    /**
+     * 针对 data 合成 count 条请求（固定种子可复现）
+     */
+    static std::vector<LoadRequest> synthesize(const std::vector<PlateRecord>& data,
+                                               const LoadMix& mix, std::uint64_t seed,
+                                               size_t count);
+
+private:
+    struct Schedule;
+    struct Worker;
+    
+    // 执行一条请求，返回变更是否被拒绝
+    bool execute(const LoadRequest& req);
+    void clientLoop(unsigned id, Schedule& schedule, Worker& worker);
+    
+    PlateDatabase& db;
+    LoadOptions opts;
+    std::vector<LoadRequest> reqs;
+};
+
+#endif // LOAD_DRIVER_H
@@ -0,0 +1,188 @@
+#include "PerfCounters.h"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char* const EVENT_NAMES[PerfCounters::EVENT_COUNT] = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+    };
+
+#ifdef __linux__
+    struct EventSpec {
+        std::uint32_t type;
+        std::uint64_t config;
+    };
+    
+    const EventSpec EVENT_SPECS[PerfCounters::EVENT_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                             (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+    };
+    
+    int openEvent(const EventSpec& spec) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = spec.type;
+        attr.config = spec.config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+}
+
+PerfCounters::Reading::Reading() {
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        values[e] = 0;
+        valid[e] = false;
+    }
+}
+
+void PerfCounters::Reading::add(const Reading& other) {
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        values[e] += other.values[e];
+        valid[e] = valid[e] && other.valid[e];
+    }
+}
+
+bool PerfCounters::Reading::any() const {
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (valid[e]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double PerfCounters::Reading::ipc() const {
+    if (!valid[CYCLES] || !valid[INSTRUCTIONS] || values[CYCLES] <= 0) {
+        return 0.0;
+    }
+    return values[INSTRUCTIONS] / values[CYCLES];
+}
+
+PerfCounters::PerfCounters() {
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        fds[e] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+bool PerfCounters::open() {
+    close();
+#ifdef __linux__
+    int firstError = 0;
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        fds[e] = openEvent(EVENT_SPECS[e]);
+        if (fds[e] < 0 && firstError == 0) {
+            firstError = errno;
+        }
+    }
+    if (available()) {
+        return true;
+    }
+    why = std::string("perf_event_open 失败：") + std::strerror(firstError);
+    if (firstError == EACCES || firstError == EPERM) {
+        why += "（可降低 /proc/sys/kernel/perf_event_paranoid）";
+    } else if (firstError == ENOENT || firstError == EOPNOTSUPP) {
+        why += "（当前 CPU 或虚拟机未提供硬件计数器）";
+    }
+#else
+    why = "硬件计数器仅支持 Linux";
+#endif
+    return false;
+}
+
+void PerfCounters::close() {
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+#ifdef __linux__
+        if (fds[e] >= 0) {
+            ::close(fds[e]);
+        }
+#endif
+        fds[e] = -1;
+    }
+}
+
+bool PerfCounters::available() const {
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] >= 0) {
+            ioctl(fds[e], PERF_EVENT_IOC_RESET, 0);
+        }
+    }
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] >= 0) {
+            ioctl(fds[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef __linux__
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] >= 0) {
+            ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+#endif
+}
+
+PerfCounters::Reading PerfCounters::read() const {
+    Reading r;
+#ifdef __linux__
+    for (int e = 0; e < EVENT_COUNT; ++e) {
+        if (fds[e] < 0) {
+            continue;
+        }
+        // value, time_enabled, time_running
+        std::uint64_t buf[3] = {0, 0, 0};
+        if (::read(fds[e], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) {
+            continue;
+        }
+        if (buf[2] == 0) {
+            // 区间内从未被调度到硬件计数器上，读数没有意义
+            continue;
+        }
+        double value = static_cast<double>(buf[0]);
+        if (buf[2] < buf[1]) {
+            value *= static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+        }
+        r.values[e] = value;
+        r.valid[e] = true;
+    }
+#endif
+    return r;
+}
+
+const char* PerfCounters::name(Event e) {
+    return EVENT_NAMES[e];
+}
@@ -0,0 +1,75 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * 硬件性能计数器（Linux perf_event_open）
+ * 每个事件单独打开（不成组），只统计用户态，inherit 使被测代码创建的工作线程
+ * 也计入；计数器数量不够时内核会分时复用，读数按启用 / 实际运行时间放大。
+ * 某个事件打不开（虚拟机没有 PMU、perf_event_paranoid 限制、非 Linux）时
+ * 只缺这一项，全部打不开时 available() 为 false，基准照常只报告耗时。
+ */
+class PerfCounters {
+public:
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,         // L1 数据缓存读缺失
+        LLC_MISSES,         // 末级缓存缺失
+        BRANCH_MISSES,      // 分支预测失误
+        EVENT_COUNT
+    };
+    
+    /**
+     * 一段区间内各事件的计数
+     */
+    struct Reading {
+        double values[EVENT_COUNT];
+        bool valid[EVENT_COUNT];
+        
+        Reading();
+        
+        // 累加另一段区间（两者都有效的事件才保持有效）
+        void add(const Reading& other);
+        
+        // 是否有任一事件有效
+        bool any() const;
+        
+        // 每周期指令数（IPC）；周期或指令无效时返回 0
+        double ipc() const;
+    };
+    
+    PerfCounters();
+    ~PerfCounters();
+    
+    /**
+     * 打开全部事件
+     * @return 至少一个事件可用时返回 true；否则 reason() 给出原因
+     */
+    bool open();
+    void close();
+    
+    bool available() const;
+    bool has(Event e) const { return fds[e] >= 0; }
+    const std::string& reason() const { return why; }
+    
+    // 清零并开始计数 / 停止计数
+    void start();
+    void stop();
+    
+    // 上一次 start 到 stop 之间的计数
+    Reading read() const;
+    
+    static const char* name(Event e);
+
+private:
+    PerfCounters(const PerfCounters&);
+    PerfCounters& operator=(const PerfCounters&);
+    
+    int fds[EVENT_COUNT];
+    std::string why;
+};
+
+#endif // PERF_COUNTERS_H
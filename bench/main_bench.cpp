@@ -0,0 +1,286 @@
+#include "BenchCompare.h"
+#include "BenchHarness.h"
+#include "../include/DataGenerator.h"
+#include "../include/FileIO.h"
+#include "../include/PlateDatabase.h"
+#include "../include/RadixSort.h"
+#include "../include/SearchAlgorithms.h"
+#include "../include/Utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+
+namespace {
+    // 默认规模；--full 追加 10M、50M（50M 条记录约需 15 GB 内存）
+    const size_t DEFAULT_SIZES[] = {1000, 10000, 100000, 1000000};
+    const size_t FULL_SIZES[] = {1000, 10000, 100000, 1000000, 10000000, 50000000};
+    
+    // 折半查找每次执行的查询数；顺序查找按规模缩减，使单次执行约扫描 2000 万条记录
+    const size_t LOOKUP_QUERIES = 10000;
+    const size_t LINEAR_SCAN_BUDGET = 20000000;
+    
+    // 基准名称（按运行顺序），供 --list 使用
+    const char* const BENCHMARKS[] = {
+        "radix_sort", "std_sort", "binary_search", "linear_search", "prefix_search",
+        "build_city_index", "is_valid_plate", "file_save_text", "file_load_text",
+        "file_load_parallel", "generate_random_data", "generate_data"
+    };
+    
+    // 丢弃库函数的控制台提示，避免干扰计时与结果表
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) { return n; }
+    };
+    
+    void printUsage() {
+        std::cout <<
+            "用法：platecore_bench [选项]\n"
+            "  --sizes=1K,10K,1M   数据规模（支持 K / M 后缀）\n"
+            "  --full              规模 1K 到 50M\n"
+            "  --reps=N            重复次数（默认 5）\n"
+            "  --warmup=N          预热次数（默认 1）\n"
+            "  --filter=TEXT       只运行名称包含 TEXT 的基准\n"
+            "  --json=FILE         把结果写入 JSON 文件\n"
+            "  --seed=N            数据种子（对比不同版本时保持一致）\n"
+            "  --tmp=FILE          文件读写基准使用的临时文件\n"
+            "  --counters          读取硬件性能计数器（IPC、缓存缺失、分支预测失误，仅 Linux）\n"
+            "  --baseline=FILE     与基线结果（--json 的输出）对比，有回归时退出码为 3\n"
+            "  --current=FILE      不运行，直接用该结果文件与基线对比\n"
+            "  --threshold=PCT     中位数变化超过 PCT% 且显著才算回归 / 改进（默认 5）\n"
+            "  --alpha=P           显著性水平（默认 0.05）\n"
+            "  --list              列出全部基准\n";
+    }
+    
+    bool startsWith(const char* arg, const char* prefix, const char** value) {
+        size_t len = std::strlen(prefix);
+        if (std::strncmp(arg, prefix, len) != 0) {
+            return false;
+        }
+        *value = arg + len;
+        return true;
+    }
+    
+    // 固定种子的查询：一半命中、一半不存在的合法车牌
+    std::vector<std::string> lookupKeys(const std::vector<PlateRecord>& data,
+                                        std::uint64_t seed, size_t count) {
+        QueryMixSpec mix;
+        mix.prefixShare = 0;
+        mix.cityShare = 0;
+        mix.hitRatio = 0.5;
+        mix.keyZipf = 0;
+        std::vector<WorkloadQuery> queries = DataGenerator::generateQueries(data, mix, seed, count);
+        std::vector<std::string> keys;
+        keys.reserve(queries.size());
+        for (const auto& q : queries) {
+            keys.push_back(q.key);
+        }
+        return keys;
+    }
+    
+    void runSize(BenchRunner& runner, size_t n, const std::string& tmpFile) {
+        const BenchOptions& opts = runner.options();
+        
+        // 同一种子、同一规模的数据跨版本完全一致；生成顺序即随机顺序
+        std::vector<PlateRecord> data;
+        DataGenerator::generate(opts.seed, 0, n, data);
+        std::vector<PlateRecord> sorted(data);
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<PlateRecord> work;
+        
+        auto restore = [&]() { work = data; };
+        runner.run("radix_sort", n, n, restore, [&]() { RadixSort::sort(work); });
+        runner.run("std_sort", n, n, restore, [&]() { std::sort(work.begin(), work.end()); });
+        std::vector<PlateRecord>().swap(work);
+        
+        std::vector<std::string> keys = lookupKeys(data, opts.seed + 1, LOOKUP_QUERIES);
+        runner.run("binary_search", n, keys.size(), std::function<void()>(), [&]() {
+            int found = 0;
+            for (const auto& key : keys) {
+                found += SearchAlgorithms::binarySearch(sorted, key).index >= 0;
+            }
+            Bench::keep(found);
+        });
+        
+        size_t linearQueries = std::max<size_t>(1, std::min(keys.size(), LINEAR_SCAN_BUDGET / n));
+        runner.run("linear_search", n, linearQueries, std::function<void()>(), [&]() {
+            int found = 0;
+            for (size_t i = 0; i < linearQueries; ++i) {
+                found += SearchAlgorithms::linearSearch(data, keys[i]).index >= 0;
+            }
+            Bench::keep(found);
+        });
+        
+        runner.run("prefix_search", n, n, std::function<void()>(), [&]() {
+            std::vector<PlateRecord> hits = SearchAlgorithms::prefixSearch(sorted, "辽A1");
+            Bench::keep(hits);
+        });
+        
+        if (runner.selected("build_city_index")) {
+            // 每次先按车牌排序（不计时），使建立索引的输入一致
+            PlateDatabase db;
+            db.setVerbose(false);
+            db.batchImport(data);
+            runner.run("build_city_index", n, n, [&]() { db.radixSortByPlate(); },
+                       [&]() { db.buildCityIndex(); });
+        }
+        
+        runner.run("is_valid_plate", n, n, std::function<void()>(), [&]() {
+            size_t valid = 0;
+            for (const auto& rec : data) {
+                valid += Utils::isValidPlate(rec.plate);
+            }
+            Bench::keep(valid);
+        });
+        
+        bool loadBench = runner.selected("file_load_text") || runner.selected("file_load_parallel");
+        if (loadBench || runner.selected("file_save_text")) {
+            runner.run("file_save_text", n, n, std::function<void()>(),
+                       [&]() { FileIO::saveToFile(tmpFile, data); });
+            if (loadBench && !runner.selected("file_save_text")) {
+                FileIO::saveToFile(tmpFile, data);
+            }
+            std::vector<PlateRecord> loaded;
+            auto reset = [&]() { std::vector<PlateRecord>().swap(loaded); };
+            runner.run("file_load_text", n, n, reset,
+                       [&]() { FileIO::loadFromFile(tmpFile, loaded); });
+            runner.run("file_load_parallel", n, n, reset,
+                       [&]() { FileIO::loadFromFileParallel(tmpFile, loaded); });
+            std::remove(tmpFile.c_str());
+        }
+        
+        std::unique_ptr<PlateDatabase> target;
+        runner.run("generate_random_data", n, n, [&]() {
+            target.reset(new PlateDatabase());
+            target->setVerbose(false);
+        }, [&]() { target->generateRandomData(static_cast<int>(n)); });
+        target.reset();
+        
+        std::vector<PlateRecord> generated;
+        runner.run("generate_data", n, n, [&]() { std::vector<PlateRecord>().swap(generated); },
+                   [&]() { DataGenerator::generate(opts.seed, 0, n, generated); });
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opts;
+    opts.sizes.assign(DEFAULT_SIZES, DEFAULT_SIZES + sizeof(DEFAULT_SIZES) / sizeof(DEFAULT_SIZES[0]));
+    std::string tmpFile = "platecore_bench.tmp.txt";
+    std::string baselineFile, currentFile;
+    CompareOptions compareOpts;
+    
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = nullptr;
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printUsage();
+            return 0;
+        } else if (std::strcmp(arg, "--list") == 0) {
+            for (size_t b = 0; b < sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]); ++b) {
+                std::cout << BENCHMARKS[b] << "\n";
+            }
+            return 0;
+        } else if (std::strcmp(arg, "--full") == 0) {
+            opts.sizes.assign(FULL_SIZES, FULL_SIZES + sizeof(FULL_SIZES) / sizeof(FULL_SIZES[0]));
+        } else if (startsWith(arg, "--sizes=", &value)) {
+            opts.sizes = Bench::parseSizes(value);
+            if (opts.sizes.empty()) {
+                std::cerr << "无法解析规模：" << value << std::endl;
+                return 2;
+            }
+        } else if (startsWith(arg, "--reps=", &value)) {
+            opts.repetitions = static_cast<unsigned>(std::max(1, std::atoi(value)));
+        } else if (startsWith(arg, "--warmup=", &value)) {
+            opts.warmup = static_cast<unsigned>(std::max(0, std::atoi(value)));
+        } else if (startsWith(arg, "--filter=", &value)) {
+            opts.filter = value;
+        } else if (startsWith(arg, "--json=", &value)) {
+            opts.jsonPath = value;
+        } else if (startsWith(arg, "--seed=", &value)) {
+            opts.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--counters") == 0) {
+            opts.counters = true;
+        } else if (startsWith(arg, "--baseline=", &value)) {
+            baselineFile = value;
+        } else if (startsWith(arg, "--current=", &value)) {
+            currentFile = value;
+        } else if (startsWith(arg, "--threshold=", &value)) {
+            compareOpts.thresholdPct = std::atof(value);
+        } else if (startsWith(arg, "--alpha=", &value)) {
+            compareOpts.alpha = std::atof(value);
+        } else if (startsWith(arg, "--tmp=", &value)) {
+            tmpFile = value;
+        } else {
+            std::cerr << "未知参数：" << arg << std::endl;
+            printUsage();
+            return 2;
+        }
+    }
+    
+    if (!currentFile.empty() && baselineFile.empty()) {
+        std::cerr << "--current 需要同时给出 --baseline" << std::endl;
+        return 2;
+    }
+    
+    // 先读基线，格式错误时不必白跑一遍
+    BenchRun baseline;
+    std::string error;
+    if (!baselineFile.empty() && !BenchCompare::readJson(baselineFile, baseline, &error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    
+    BenchRun current;
+    if (!currentFile.empty()) {
+        if (!BenchCompare::readJson(currentFile, current, &error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    } else {
+        // 结果表写到原来的标准输出，库内部的提示丢弃
+        std::ostream out(std::cout.rdbuf());
+        NullBuffer null;
+        std::cout.rdbuf(&null);
+        
+        BenchRunner runner(opts, out);
+        out << "重复 " << opts.repetitions << " 次，预热 " << opts.warmup << " 次，种子 " << opts.seed << "\n";
+        runner.printHeader();
+        for (size_t i = 0; i < opts.sizes.size(); ++i) {
+            runSize(runner, opts.sizes[i], tmpFile);
+        }
+        
+        std::cout.rdbuf(out.rdbuf());
+        if (!opts.jsonPath.empty()) {
+            if (!runner.writeJson(opts.jsonPath)) {
+                return 1;
+            }
+            std::cout << "结果已写入：" << opts.jsonPath << std::endl;
+        }
+        current.context = runner.context();
+        current.results = runner.results();
+    }
+    
+    if (baselineFile.empty()) {
+        return 0;
+    }
+    
+    std::cout << "\n与基线对比：" << baselineFile;
+    std::string commit = baseline.contextValue("commit");
+    if (!commit.empty()) {
+        std::cout << "（提交 " << commit << "，" << baseline.contextValue("date") << "）";
+    }
+    std::cout << "\n";
+    std::vector<std::string> diff = BenchCompare::environmentDiff(baseline, current);
+    for (size_t i = 0; i < diff.size(); ++i) {
+        std::cout << "注意，运行环境不同 " << diff[i] << "\n";
+    }
+    std::vector<BenchComparison> rows = BenchCompare::compare(baseline, current, compareOpts);
+    std::cout << BenchCompare::format(rows, compareOpts);
+    std::cout.flush();
+    
+    return BenchCompare::count(rows, BenchComparison::SLOWER) > 0 ? 3 : 0;
+}
@@ -0,0 +1,200 @@
+#include "BenchHarness.h"
+#include "LoadDriver.h"
+#include "../include/PlateDatabase.h"
+#include "../include/Parallel.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+    
+    void printUsage() {
+        std::cout <<
+            "用法：plate_loadgen [选项]\n"
+            "数据（三选一，默认生成 1M 条）：\n"
+            "  --records=1M        按种子生成记录\n"
+            "  --load=FILE         导入文本数据文件\n"
+            "  --snapshot=FILE     打开二进制快照\n"
+            "请求（默认按 --mix 合成）：\n"
+            "  --log=FILE          回放查询日志（每行：exact/prefix/city/fuzzy/add/modify/delete 及参数）\n"
+            "  --mix=exact:85,prefix:5,city:1,fuzzy:5,mutate:4\n"
+            "                      合成请求的相对权重（未列出的为 0）\n"
+            "  --requests=N        合成请求数，用完后循环（默认 1M）\n"
+            "  --hit=0.9           精确查找的命中比例\n"
+            "  --zipf=0.99         热点记录的 Zipf 指数，0 为均匀\n"
+            "  --write-log=FILE    把请求序列写成查询日志，便于原样回放\n"
+            "  --seed=N            数据与请求的种子\n"
+            "负载：\n"
+            "  --threads=N         客户端线程数（默认硬件线程数）\n"
+            "  --mode=closed|open  闭环（完成一个再发下一个）或开环（固定到达率）\n"
+            "  --rate=R            开环模式的总到达率（次/秒）\n"
+            "  --duration=S        计入结果的秒数（默认 10）\n"
+            "  --warmup=S          预热秒数（默认 1）\n"
+            "  --ops=N             最多发出的请求数（含预热）\n";
+    }
+    
+    bool startsWith(const char* arg, const char* prefix, const char** value) {
+        size_t len = std::strlen(prefix);
+        if (std::strncmp(arg, prefix, len) != 0) {
+            return false;
+        }
+        *value = arg + len;
+        return true;
+    }
+    
+    // "exact:85,prefix:5" → 权重；未列出的类别为 0
+    bool parseMix(const std::string& text, LoadMix& mix) {
+        mix.exact = mix.prefix = mix.city = mix.fuzzy = mix.mutate = 0;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            size_t colon = item.find(':');
+            if (colon == std::string::npos) {
+                return false;
+            }
+            std::string name = item.substr(0, colon);
+            double weight = std::atof(item.c_str() + colon + 1);
+            if (weight < 0) {
+                return false;
+            }
+            if (name == "exact") mix.exact = weight;
+            else if (name == "prefix") mix.prefix = weight;
+            else if (name == "city") mix.city = weight;
+            else if (name == "fuzzy") mix.fuzzy = weight;
+            else if (name == "mutate") mix.mutate = weight;
+            else return false;
+        }
+        return mix.exact + mix.prefix + mix.city + mix.fuzzy + mix.mutate > 0;
+    }
+    
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions opts;
+    opts.threads = Parallel::defaultThreads();
+    LoadMix mix;
+    size_t records = 1000000;
+    size_t requestCount = 1000000;
+    std::uint64_t seed = 20240601;
+    std::string loadFile, snapshotFile, logFile, writeLogFile;
+    
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = nullptr;
+        if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            printUsage();
+            return 0;
+        } else if (startsWith(arg, "--records=", &value)) {
+            records = Bench::parseSize(value);
+        } else if (startsWith(arg, "--load=", &value)) {
+            loadFile = value;
+        } else if (startsWith(arg, "--snapshot=", &value)) {
+            snapshotFile = value;
+        } else if (startsWith(arg, "--log=", &value)) {
+            logFile = value;
+        } else if (startsWith(arg, "--write-log=", &value)) {
+            writeLogFile = value;
+        } else if (startsWith(arg, "--mix=", &value)) {
+            if (!parseMix(value, mix)) {
+                std::cerr << "无法解析请求组合：" << value << std::endl;
+                return 2;
+            }
+        } else if (startsWith(arg, "--requests=", &value)) {
+            requestCount = Bench::parseSize(value);
+        } else if (startsWith(arg, "--hit=", &value)) {
+            mix.hitRatio = std::atof(value);
+        } else if (startsWith(arg, "--zipf=", &value)) {
+            mix.keyZipf = std::atof(value);
+        } else if (startsWith(arg, "--seed=", &value)) {
+            seed = std::strtoull(value, nullptr, 10);
+        } else if (startsWith(arg, "--threads=", &value)) {
+            opts.threads = static_cast<unsigned>(std::max(1, std::atoi(value)));
+        } else if (startsWith(arg, "--mode=", &value)) {
+            if (std::strcmp(value, "open") == 0) {
+                opts.openLoop = true;
+            } else if (std::strcmp(value, "closed") == 0) {
+                opts.openLoop = false;
+            } else {
+                std::cerr << "未知模式：" << value << std::endl;
+                return 2;
+            }
+        } else if (startsWith(arg, "--rate=", &value)) {
+            opts.rate = std::atof(value);
+        } else if (startsWith(arg, "--duration=", &value)) {
+            opts.durationSec = std::atof(value);
+        } else if (startsWith(arg, "--warmup=", &value)) {
+            opts.warmupSec = std::atof(value);
+        } else if (startsWith(arg, "--ops=", &value)) {
+            opts.maxOps = std::strtoull(value, nullptr, 10);
+        } else {
+            std::cerr << "未知参数：" << arg << std::endl;
+            printUsage();
+            return 2;
+        }
+    }
+    if (opts.openLoop && opts.rate <= 0) {
+        std::cerr << "开环模式需要正的 --rate" << std::endl;
+        return 2;
+    }
+    
+    PlateDatabase db;
+    db.setVerbose(false);
+    
+    Clock::time_point start = Clock::now();
+    bool loaded;
+    if (!snapshotFile.empty()) {
+        loaded = db.openSnapshot(snapshotFile);
+    } else if (!loadFile.empty()) {
+        loaded = db.loadFromFile(loadFile);
+    } else {
+        loaded = records > 0 && db.generateData(records, seed);
+    }
+    if (!loaded || db.getRecordCount() == 0) {
+        std::cerr << "没有可用的数据" << std::endl;
+        return 1;
+    }
+    if (!db.isSorted()) {
+        db.radixSortByPlate();
+    }
+    std::cout << "数据：" << db.getRecordCount() << " 条，准备耗时 "
+              << secondsSince(start) << " 秒" << std::endl;
+    
+    std::vector<LoadRequest> requests;
+    if (!logFile.empty()) {
+        std::string error;
+        if (!LoadDriver::readLog(logFile, requests, &error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    } else {
+        requests = LoadDriver::synthesize(db.getAllRecords(), mix, seed, requestCount);
+    }
+    if (requests.empty()) {
+        std::cerr << "没有可发出的请求" << std::endl;
+        return 1;
+    }
+    if (!writeLogFile.empty() && !LoadDriver::writeLog(writeLogFile, requests)) {
+        std::cerr << "无法写入查询日志：" << writeLogFile << std::endl;
+        return 1;
+    }
+    
+    std::cout << "请求：" << requests.size() << " 条，" << opts.threads << " 个客户端线程，"
+              << (opts.openLoop ? "开环" : "闭环");
+    if (opts.openLoop) {
+        std::cout << "（" << opts.rate << " 次/秒）";
+    }
+    std::cout << "，预热 " << opts.warmupSec << " 秒，计入 " << opts.durationSec << " 秒"
+              << std::endl;
+    
+    LoadDriver driver(db, opts);
+    driver.setRequests(requests);
+    LoadResult report = driver.run();
+    std::cout << report.toString();
+    return 0;
+}
@@ -4,12 +4,16 @@
 #include <QInputDialog>
 #include <QDateTime>
 #include <QAbstractItemView>
+#include <QItemSelectionModel>
 #include <QApplication>
 #include <sstream>
 #include <iomanip>
+#include <utility>
+#include <cstdlib>
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), database(new PlateDatabase())
+    : QMainWindow(parent), database(new PlateDatabase()), importCancel(false),
+      metricsExporter(nullptr)
 {
     setupUI();
     setupMenuBar();
@@ -17,11 +21,53 @@ MainWindow::MainWindow(QWidget *parent)
     refreshTable();
     updateStatusBar("系统就绪");
     updateActionStates();
+    startMetricsExport();
+    
+    // PLATE_TRACE_FILE 非空时记录各阶段耗时，退出时写出 Chrome trace 文件
+    const char* trace = std::getenv("PLATE_TRACE_FILE");
+    if (trace && *trace && Trace::start()) {
+        Trace::setThreadName("界面线程");
+        traceFile = trace;
+    }
 }
 
 MainWindow::~MainWindow()
 {
+    importCancel = true;
+    if (importThread.joinable()) {
+        importThread.join();
+    }
+    delete metricsExporter;
     delete database;
+    if (!traceFile.empty()) {
+        Trace::stop();
+        Trace::writeJson(traceFile);
+    }
+}
+
+void MainWindow::startMetricsExport()
+{
+    // 通过环境变量开启：PLATE_METRICS_FILE 定时写文件，PLATE_METRICS_PORT 开本机端点
+    const char* file = std::getenv("PLATE_METRICS_FILE");
+    const char* port = std::getenv("PLATE_METRICS_PORT");
+    const char* interval = std::getenv("PLATE_METRICS_INTERVAL");
+    if ((!file || !*file) && (!port || !*port)) {
+        return;
+    }
+    
+    metricsExporter = new MetricsExporter(*database);
+    if (file && *file) {
+        unsigned ms = interval ? static_cast<unsigned>(std::strtoul(interval, nullptr, 10)) : 0;
+        metricsExporter->startFileExport(file, ms ? ms : 15000);
+    }
+    if (port && *port) {
+        unsigned long value = std::strtoul(port, nullptr, 10);
+        if (value > 0 && value <= 65535 &&
+            metricsExporter->startHttp(static_cast<unsigned short>(value))) {
+            updateStatusBar(QString("指标端点：http://127.0.0.1:%1/metrics")
+                            .arg(metricsExporter->httpPort()));
+        }
+    }
 }
 
 void MainWindow::setupUI()
@@ -29,7 +75,7 @@ void MainWindow::setupUI()
     setWindowTitle("辽宁省汽车牌照快速查询系统 v2.0");
     setMinimumSize(1200, 800);
     resize(1400, 900);
-
+    
     // 全局样式美化
     setStyleSheet(R"(
         QWidget {
@@ -134,7 +180,7 @@ void MainWindow::setupUI()
             border: 1px solid #cfd6e1;
             box-shadow: none;
         }
-        QTableWidget {
+        QTableView {
             background: #ffffff;
             alternate-background-color: #f6f8fb;
             gridline-color: #e1e6ee;
@@ -335,22 +381,24 @@ void MainWindow::setupUI()
     tableLabel->setStyleSheet("font-size: 15px; font-weight: bold; color:#1f4b99;");
     centerLayout->addWidget(tableLabel);
     
-    tableWidget = new QTableWidget(this);
-    tableWidget->setColumnCount(5);
-    tableWidget->setHorizontalHeaderLabels(QStringList() << "序号" << "车牌号" << "城市" << "车主" << "类别");
-    tableWidget->horizontalHeader()->setStretchLastSection(true);
-    tableWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
-    tableWidget->horizontalHeader()->setDefaultSectionSize(130);
-    tableWidget->setColumnWidth(0, 50); // 序号列宽度较小
-    tableWidget->horizontalHeader()->setStyleSheet("QHeaderView::section{background:#F2F4F7;font-weight:800;font-size:13.5px;color:#1f2328;}");
-    tableWidget->verticalHeader()->setVisible(false);
-    tableWidget->verticalHeader()->setDefaultSectionSize(34);
-    tableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
-    tableWidget->setSelectionMode(QAbstractItemView::SingleSelection);
-    tableWidget->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    tableWidget->setAlternatingRowColors(true);
-    tableWidget->setShowGrid(false);
-    tableWidget->setFrameShape(QFrame::NoFrame);
+    // 模型按需读取可见行，行高固定，视图不必逐行测量
+    tableModel = new PlateTableModel(this);
+    tableView = new QTableView(this);
+    tableView->setModel(tableModel);
+    tableView->horizontalHeader()->setStretchLastSection(true);
+    tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    tableView->horizontalHeader()->setDefaultSectionSize(130);
+    tableView->setColumnWidth(0, 50); // 序号列宽度较小
+    tableView->horizontalHeader()->setStyleSheet("QHeaderView::section{background:#F2F4F7;font-weight:800;font-size:13.5px;color:#1f2328;}");
+    tableView->verticalHeader()->setVisible(false);
+    tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    tableView->verticalHeader()->setDefaultSectionSize(34);
+    tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    tableView->setSelectionMode(QAbstractItemView::SingleSelection);
+    tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    tableView->setAlternatingRowColors(true);
+    tableView->setShowGrid(false);
+    tableView->setFrameShape(QFrame::NoFrame);
     
     emptyStateLabel = new QLabel("暂无车辆数据\n请在左侧添加记录或导入文件", this);
     emptyStateLabel->setAlignment(Qt::AlignCenter);
@@ -362,7 +410,7 @@ void MainWindow::setupUI()
     QWidget* tableContainer = new QWidget(this);
     QVBoxLayout* tableContainerLayout = new QVBoxLayout(tableContainer);
     tableContainerLayout->setContentsMargins(0,0,0,0);
-    tableContainerLayout->addWidget(tableWidget);
+    tableContainerLayout->addWidget(tableView);
     QWidget* emptyWrapper = new QWidget(this);
     QVBoxLayout* emptyLayout = new QVBoxLayout(emptyWrapper);
     emptyLayout->setContentsMargins(0,0,0,0);
@@ -401,9 +449,18 @@ void MainWindow::setupUI()
     connect(perfBtn, &QPushButton::clicked, this, &MainWindow::onPerformanceStats);
     connect(validateBtn, &QPushButton::clicked, this, &MainWindow::onValidateData);
     connect(saveFileBtn, &QPushButton::clicked, this, &MainWindow::onSaveToFile);
+    connect(this, &MainWindow::saveProgressChanged, this, &MainWindow::onSaveProgress,
+            Qt::QueuedConnection);
+    connect(this, &MainWindow::saveFinished, this, &MainWindow::onSaveDone,
+            Qt::QueuedConnection);
+    connect(this, &MainWindow::importProgressChanged, this, &MainWindow::onImportProgress,
+            Qt::QueuedConnection);
+    connect(this, &MainWindow::importFinished, this, &MainWindow::onImportDone,
+            Qt::QueuedConnection);
     connect(clearBtn, &QPushButton::clicked, this, &MainWindow::onClearAll);
-    connect(tableWidget, &QTableWidget::cellDoubleClicked, this, &MainWindow::onTableDoubleClick);
-    connect(tableWidget, &QTableWidget::itemSelectionChanged, this, &MainWindow::onTableSelectionChanged);
+    connect(tableView, &QTableView::doubleClicked, this, &MainWindow::onTableDoubleClick);
+    connect(tableView->selectionModel(), &QItemSelectionModel::selectionChanged,
+            this, &MainWindow::onTableSelectionChanged);
     connect(plateEdit, &QLineEdit::textChanged, this, &MainWindow::onPlateTextChanged);
     connect(cityEdit, &QLineEdit::textChanged, this, &MainWindow::onCityTextChanged);
     
@@ -420,11 +477,15 @@ void MainWindow::setupMenuBar()
     QMenu* fileMenu = menuBar->addMenu("文件(&F)");
     QAction* loadAction = fileMenu->addAction("导入文件(&I)");
     QAction* saveAction = fileMenu->addAction("保存文件(&S)");
+    QAction* saveDeltaAction = fileMenu->addAction("增量保存(&D)");
+    QAction* compactAction = fileMenu->addAction("合并增量(&M)");
     fileMenu->addSeparator();
     QAction* exitAction = fileMenu->addAction("退出(&X)");
     
     connect(loadAction, &QAction::triggered, this, &MainWindow::onLoadFromFile);
     connect(saveAction, &QAction::triggered, this, &MainWindow::onSaveToFile);
+    connect(saveDeltaAction, &QAction::triggered, this, &MainWindow::onSaveDelta);
+    connect(compactAction, &QAction::triggered, this, &MainWindow::onCompactDeltas);
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
     
     QMenu* editMenu = menuBar->addMenu("编辑(&E)");
@@ -483,6 +544,12 @@ void MainWindow::setupStatusBar()
     progressBar->setVisible(false);
     statusBar()->addPermanentWidget(progressBar);
     
+    cancelImportBtn = new QPushButton("取消导入", this);
+    cancelImportBtn->setProperty("btnRole", "neutral");
+    cancelImportBtn->setVisible(false);
+    statusBar()->addPermanentWidget(cancelImportBtn);
+    connect(cancelImportBtn, &QPushButton::clicked, this, &MainWindow::onCancelImport);
+    
     // 字体调节按钮
     QWidget* fontWidget = new QWidget(this);
     QHBoxLayout* fontLayout = new QHBoxLayout(fontWidget);
@@ -508,32 +575,27 @@ void MainWindow::setupStatusBar()
 
 void MainWindow::refreshTable()
 {
-    auto records = database->getAllRecords();
-    showRecordInTable(records);
+    // 直接显示当前快照，不复制记录
+    tableModel->setSnapshot(database->snapshot());
+    updateTableState();
 }
 
-void MainWindow::showRecordInTable(const std::vector<PlateRecord>& records)
+void MainWindow::showRecordInTable(std::vector<PlateRecord> records)
 {
-    tableWidget->setRowCount(0);
-    tableWidget->setRowCount(static_cast<int>(records.size()));
-    
-    for (size_t i = 0; i < records.size(); ++i) {
-        // 序号列（从1开始）
-        tableWidget->setItem(static_cast<int>(i), 0, new QTableWidgetItem(QString::number(i + 1)));
-        // 数据列
-        tableWidget->setItem(static_cast<int>(i), 1, new QTableWidgetItem(QString::fromStdString(records[i].plate)));
-        tableWidget->setItem(static_cast<int>(i), 2, new QTableWidgetItem(QString::fromStdString(records[i].city)));
-        tableWidget->setItem(static_cast<int>(i), 3, new QTableWidgetItem(QString::fromStdString(records[i].owner)));
-        tableWidget->setItem(static_cast<int>(i), 4, new QTableWidgetItem(QString::fromStdString(records[i].category)));
-    }
-    
-    bool hasData = !records.empty();
+    tableModel->setRecords(std::move(records));
+    updateTableState();
+}
+
+void MainWindow::updateTableState()
+{
+    size_t count = tableModel->recordCount();
+    bool hasData = count > 0;
     emptyStateLabel->setVisible(!hasData);
     if (stackedLayout) {
         stackedLayout->setCurrentIndex(hasData ? 0 : 1);
     }
     updateActionStates();
-    updateStatusBar(QString("显示 %1 条记录").arg(records.size()));
+    updateStatusBar(QString("显示 %1 条记录").arg(count));
 }
 
 void MainWindow::showMessage(const QString& message, bool isError)
@@ -553,7 +615,7 @@ void MainWindow::updateStatusBar(const QString& message)
 
 void MainWindow::updateActionStates()
 {
-    bool hasSelection = tableWidget->selectionModel() && tableWidget->selectionModel()->hasSelection();
+    bool hasSelection = tableView->selectionModel() && tableView->selectionModel()->hasSelection();
     bool hasData = database->getRecordCount() > 0;
     
     modifyBtn->setEnabled(hasSelection);
@@ -574,8 +636,8 @@ void MainWindow::applyFontScale(double scale)
     QApplication::setFont(f);
     
     // 调整表格行高
-    tableWidget->verticalHeader()->setDefaultSectionSize(static_cast<int>(34 * fontScale));
-    tableWidget->horizontalHeader()->setDefaultSectionSize(static_cast<int>(130 * fontScale));
+    tableView->verticalHeader()->setDefaultSectionSize(static_cast<int>(34 * fontScale));
+    tableView->horizontalHeader()->setDefaultSectionSize(static_cast<int>(130 * fontScale));
 }
 
 // 槽函数实现
@@ -634,49 +696,129 @@ void MainWindow::onAddRecord()
 
 void MainWindow::onLoadFromFile()
 {
+    if (importThread.joinable()) {
+        showMessage("正在导入，请稍候...", true);
+        return;
+    }
+    
     QString filename = QFileDialog::getOpenFileName(
         this,
         "选择文件",
         ".",
-        "数据文件 (*.txt *.csv);;文本文件 (*.txt);;CSV 文件 (*.csv);;所有文件 (*)");
-    if (!filename.isEmpty()) {
-        if (database->loadFromFile(filename.toStdString())) {
+        "数据文件 (*.txt *.csv *.psnap);;文本文件 (*.txt);;CSV 文件 (*.csv);;二进制快照 (*.psnap);;所有文件 (*)");
+    if (filename.isEmpty()) {
+        return;
+    }
+    
+    if (filename.toLower().endsWith(".psnap")) {
+        if (database->openSnapshot(filename.toStdString())) {
             showMessage("导入成功！");
             refreshTable();
         } else {
             showMessage("导入失败！", true);
         }
+        return;
     }
+    
+    // 文本/CSV 在后台线程流式导入，进度按已处理字节数显示，可随时取消
+    importCancel = false;
+    loadFileBtn->setEnabled(false);
+    cancelImportBtn->setVisible(true);
+    cancelImportBtn->setEnabled(true);
+    progressBar->setVisible(true);
+    progressBar->setRange(0, 100);
+    progressBar->setValue(0);
+    updateStatusBar("正在导入...");
+    
+    std::string path = filename.toStdString();
+    importThread = std::thread([this, path]() {
+        LoadReport report;
+        bool ok = database->importFile(path,
+            [this](size_t bytesDone, size_t bytesTotal, size_t rows) {
+                emit importProgressChanged(static_cast<qint64>(bytesDone),
+                                           static_cast<qint64>(bytesTotal),
+                                           static_cast<qint64>(rows));
+                return !importCancel;
+            }, &report);
+        emit importFinished(ok, report.cancelled);
+    });
+}
+
+void MainWindow::onImportProgress(qint64 bytesDone, qint64 bytesTotal, qint64 rows)
+{
+    progressBar->setValue(bytesTotal > 0 ? static_cast<int>(bytesDone * 100 / bytesTotal) : 100);
+    updateStatusBar(QString("正在导入... 已读取 %1 条记录").arg(rows));
+}
+
+void MainWindow::onImportDone(bool ok, bool cancelled)
+{
+    if (importThread.joinable()) {
+        importThread.join();
+    }
+    progressBar->setVisible(false);
+    cancelImportBtn->setVisible(false);
+    loadFileBtn->setEnabled(true);
+    
+    if (ok) {
+        showMessage("导入成功！");
+        refreshTable();
+    } else if (cancelled) {
+        showMessage("导入已取消，已导入的部分保留。");
+        refreshTable();
+    } else {
+        showMessage("导入失败！", true);
+    }
+}
+
+void MainWindow::onCancelImport()
+{
+    importCancel = true;
+    cancelImportBtn->setEnabled(false);
 }
 
 void MainWindow::onGenerateRandom()
 {
     bool ok;
-    int count = QInputDialog::getInt(this, "随机生成", "请输入要生成的记录数:", 100, 1, 10000, 1, &ok);
-    if (ok) {
-        database->generateRandomData(count);
-        showMessage(QString("成功生成 %1 条记录！").arg(count));
+    int count = QInputDialog::getInt(this, "随机生成", "请输入要生成的记录数:", 100, 1, 100000000, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    // 默认种子取当前时间，填入相同种子可在空库上复现同一批数据
+    QString seedText = QInputDialog::getText(this, "随机生成", "随机种子:", QLineEdit::Normal,
+                                             QString::number(QDateTime::currentMSecsSinceEpoch()), &ok);
+    if (!ok) {
+        return;
+    }
+    qulonglong seed = seedText.trimmed().toULongLong(&ok);
+    if (!ok) {
+        showMessage("随机种子必须是非负整数！", true);
+        return;
+    }
+    
+    if (database->generateData(static_cast<size_t>(count), seed)) {
+        showMessage(QString("成功生成 %1 条记录（种子 %2）！").arg(count).arg(seed));
         refreshTable();
+    } else {
+        showMessage("生成失败！", true);
     }
 }
 
 void MainWindow::onShowAllRecords()
 {
-    auto records = database->getAllRecords();
-    showRecordInTable(records);
+    refreshTable();
 }
 
 void MainWindow::onModifyRecord()
 {
     // 检查是否有选中的行
-    QList<QTableWidgetItem*> items = tableWidget->selectedItems();
-    if (items.isEmpty()) {
+    QModelIndexList rows = tableView->selectionModel()->selectedRows();
+    if (rows.isEmpty()) {
         showMessage("请先在表格中选中要修改的记录！", true);
         return;
     }
     
-    int row = items.first()->row();
-    QString originalPlate = tableWidget->item(row, 1)->text();  // 原始车牌号
+    int row = rows.first().row();
+    QString originalPlate = QString::fromStdString(tableModel->recordAt(row).plate);  // 原始车牌号
     
     QString plate = plateEdit->text().trimmed();
     if (plate.isEmpty()) {
@@ -783,8 +925,8 @@ void MainWindow::onBinarySearch()
     if (idx != -1) {
         // 高亮显示找到的记录
         refreshTable();
-        tableWidget->selectRow(idx);
-        tableWidget->scrollToItem(tableWidget->item(idx, 0));
+        tableView->selectRow(idx);
+        tableView->scrollTo(tableModel->index(idx, 0));
         showMessage(QString("找到记录，位于第 %1 行").arg(idx + 1));
     } else {
         showMessage("未找到该车牌！", true);
@@ -803,8 +945,9 @@ void MainWindow::onCitySearch()
     if (results.empty()) {
         showMessage("未找到该城市的记录！", true);
     } else {
-        showRecordInTable(results);
-        showMessage(QString("找到 %1 条记录").arg(results.size()));
+        size_t found = results.size();
+        showRecordInTable(std::move(results));
+        showMessage(QString("找到 %1 条记录").arg(found));
     }
 }
 
@@ -880,13 +1023,14 @@ void MainWindow::onPrefixSearch()
                           "• 辽B72\n"
                           "• 辽B7238").arg(prefix), true);
     } else {
-        showRecordInTable(results);
+        size_t found = results.size();
+        showRecordInTable(std::move(results));
         QString message = QString("前缀查找成功！\n\n"
                                 "查找前缀：%1\n"
                                 "找到 %2 条记录\n\n"
-                                "说明：前缀查找会匹配所有以输入前缀开头的车牌号。").arg(prefix).arg(results.size());
+                                "说明：前缀查找会匹配所有以输入前缀开头的车牌号。").arg(prefix).arg(found);
         showMessage(message);
-        updateStatusBar(QString("前缀查找: %1，找到 %2 条记录").arg(prefix).arg(results.size()));
+        updateStatusBar(QString("前缀查找: %1，找到 %2 条记录").arg(prefix).arg(found));
     }
 }
 
@@ -901,6 +1045,10 @@ void MainWindow::onStatistics()
     oss << "========== 统计信息 ==========\n";
     oss << "当前共有记录条数：" << database->getRecordCount() << "\n";
     oss << "城市数量：" << database->getCityCount() << "\n";
+    MemoryUsage memory = database->memoryUsage();
+    oss << "内存占用：" << MemoryTracker::formatBytes(static_cast<double>(memory.total()))
+        << "（每条记录 " << static_cast<long long>(memory.bytesPerRecord() + 0.5) << " 字节）\n";
+    oss << "观测峰值：" << MemoryTracker::formatBytes(static_cast<double>(memory.observedPeak())) << "\n";
     oss << "=============================\n";
     
     QString statsText = QString::fromStdString(oss.str());
@@ -950,7 +1098,9 @@ void MainWindow::onPerformanceStats()
 
 void MainWindow::onValidateData()
 {
-    std::string result = database->getValidateDataResult();
+    // 一次验证得到报告，文字结果与是否通过都取自同一份报告
+    ValidationReport report = database->validate();
+    std::string result = report.toString();
     infoText->append(QString::fromStdString(result));
     infoText->append("\n");
     
@@ -958,7 +1108,7 @@ void MainWindow::onValidateData()
     QString resultQStr = QString::fromStdString(result);
     
     // 判断验证是否通过
-    bool isValid = database->validateData();
+    bool isValid = report.passed();
     if (isValid) {
         QMessageBox::information(this, "数据验证", resultQStr);
         updateStatusBar("数据验证完成：✓ 数据完整性通过");
@@ -970,26 +1120,96 @@ void MainWindow::onValidateData()
 
 void MainWindow::onSaveToFile()
 {
+    if (database->isSaving()) {
+        showMessage("正在后台保存，请稍候...", true);
+        return;
+    }
+    
     QString filename = QFileDialog::getSaveFileName(
         this,
         "保存数据文件",
         ".",
-        "数据文件 (*.txt *.csv);;文本文件 (*.txt);;CSV 文件 (*.csv);;所有文件 (*)");
+        "数据文件 (*.txt *.csv *.psnap);;文本文件 (*.txt);;CSV 文件 (*.csv);;二进制快照 (*.psnap);;所有文件 (*)");
     if (!filename.isEmpty()) {
         QString lower = filename.toLower();
-        bool ok = false;
+        SaveFormat format = SAVE_TEXT;
         if (lower.endsWith(".csv")) {
-            ok = database->exportToCSV(filename.toStdString());
-        } else {
-            ok = database->saveToFile(filename.toStdString());
+            format = SAVE_CSV;
+        } else if (lower.endsWith(".psnap")) {
+            format = SAVE_SNAPSHOT;
         }
         
-        if (ok) {
-            showMessage("保存成功！");
+        // 在后台线程写文件，界面保持响应；进度与结果通过信号回到界面线程
+        bool started = database->saveInBackground(
+            filename.toStdString(), format,
+            [this](size_t done, size_t total) {
+                emit saveProgressChanged(static_cast<qint64>(done), static_cast<qint64>(total));
+                return true;
+            },
+            [this](bool ok) {
+                emit saveFinished(ok);
+            });
+        
+        if (started) {
+            saveFileBtn->setEnabled(false);
+            progressBar->setVisible(true);
+            progressBar->setRange(0, 100);
+            progressBar->setValue(0);
+            updateStatusBar("正在后台保存...");
         } else {
-            showMessage("保存失败！", true);
+            showMessage("正在后台保存，请稍候...", true);
+        }
+    }
+}
+
+void MainWindow::onSaveProgress(qint64 done, qint64 total)
+{
+    progressBar->setValue(total > 0 ? static_cast<int>(done * 100 / total) : 100);
+}
+
+void MainWindow::onSaveDone(bool ok)
+{
+    progressBar->setVisible(false);
+    saveFileBtn->setEnabled(true);
+    if (ok) {
+        showMessage("保存成功！");
+    } else {
+        showMessage("保存失败！", true);
+    }
+}
+
+void MainWindow::onSaveDelta()
+{
+    // 已打开或保存过基准快照时直接追加增量，否则先选择基准文件
+    QString base = QString::fromStdString(database->deltaBasePath());
+    if (base.isEmpty()) {
+        base = QFileDialog::getSaveFileName(this, "选择基准快照", ".", "二进制快照 (*.psnap)");
+        if (base.isEmpty()) {
+            return;
         }
     }
+    
+    size_t pending = database->pendingChangeCount();
+    if (database->saveDelta(base.toStdString())) {
+        showMessage(QString("增量保存成功（%1 条变化）").arg(pending));
+    } else {
+        showMessage("增量保存失败！", true);
+    }
+}
+
+void MainWindow::onCompactDeltas()
+{
+    QString base = QString::fromStdString(database->deltaBasePath());
+    if (base.isEmpty()) {
+        showMessage("当前没有基准快照，请先打开或增量保存一个 .psnap 文件。", true);
+        return;
+    }
+    
+    if (database->compactDeltas(base.toStdString())) {
+        showMessage("已合并增量，生成新的基准快照。");
+    } else {
+        showMessage("合并增量失败！", true);
+    }
 }
 
 void MainWindow::onClearAll()
@@ -1005,12 +1225,12 @@ void MainWindow::onClearAll()
 
 void MainWindow::onTableSelectionChanged()
 {
-    QList<QTableWidgetItem*> items = tableWidget->selectedItems();
-    if (!items.isEmpty()) {
-        int row = items.first()->row();
-        plateEdit->setText(tableWidget->item(row, 1)->text());  // 车牌号在第1列
-        cityEdit->setText(tableWidget->item(row, 2)->text());   // 城市在第2列
-        ownerEdit->setText(tableWidget->item(row, 3)->text());  // 车主在第3列
+    QModelIndexList rows = tableView->selectionModel()->selectedRows();
+    if (!rows.isEmpty()) {
+        PlateRecord rec = tableModel->recordAt(rows.first().row());
+        plateEdit->setText(QString::fromStdString(rec.plate));
+        cityEdit->setText(QString::fromStdString(rec.city));
+        ownerEdit->setText(QString::fromStdString(rec.owner));
     }
     updateActionStates();
 }
@@ -1030,12 +1250,15 @@ void MainWindow::onFontReset()
     applyFontScale(1.0);
 }
 
-void MainWindow::onTableDoubleClick(int row, int column)
+void MainWindow::onTableDoubleClick(const QModelIndex& index)
 {
-    Q_UNUSED(column);
-    plateEdit->setText(tableWidget->item(row, 1)->text());  // 车牌号在第1列
-    cityEdit->setText(tableWidget->item(row, 2)->text());   // 城市在第2列
-    ownerEdit->setText(tableWidget->item(row, 3)->text());  // 车主在第3列
+    if (!index.isValid()) {
+        return;
+    }
+    PlateRecord rec = tableModel->recordAt(index.row());
+    plateEdit->setText(QString::fromStdString(rec.plate));
+    cityEdit->setText(QString::fromStdString(rec.city));
+    ownerEdit->setText(QString::fromStdString(rec.owner));
 }
 
 void MainWindow::onAbout()
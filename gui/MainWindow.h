@@ -2,7 +2,7 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QTableWidget>
+#include <QTableView>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QTextEdit>
@@ -22,6 +22,11 @@
 #include <QAction>
 #include <QStackedLayout>
 #include "../include/PlateDatabase.h"
+#include "PlateTableModel.h"
+#include "../include/MetricsExporter.h"
+#include "../include/Trace.h"
+#include <thread>
+#include <atomic>
 
 class MainWindow : public QMainWindow
 {
@@ -31,10 +36,20 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+signals:
+    // 后台保存线程发出，经队列连接在界面线程处理
+    void saveProgressChanged(qint64 done, qint64 total);
+    void saveFinished(bool ok);
+    void importProgressChanged(qint64 bytesDone, qint64 bytesTotal, qint64 rows);
+    void importFinished(bool ok, bool cancelled);
+
 private slots:
     // 数据录入
     void onAddRecord();
     void onLoadFromFile();
+    void onImportProgress(qint64 bytesDone, qint64 bytesTotal, qint64 rows);
+    void onImportDone(bool ok, bool cancelled);
+    void onCancelImport();
     void onGenerateRandom();
     
     // 数据管理
@@ -56,13 +71,17 @@ private slots:
     
     // 文件操作
     void onSaveToFile();
+    void onSaveProgress(qint64 done, qint64 total);
+    void onSaveDone(bool ok);
+    void onSaveDelta();
+    void onCompactDeltas();
     
     // 系统维护
     void onClearAll();
     
     // 表格相关
     void onTableSelectionChanged();
-    void onTableDoubleClick(int row, int column);
+    void onTableDoubleClick(const QModelIndex& index);
     
     // 车牌输入相关
     void onPlateTextChanged();
@@ -81,15 +100,18 @@ private:
     void setupUI();
     void setupMenuBar();
     void setupStatusBar();
+    void startMetricsExport();
     void refreshTable();
-    void showRecordInTable(const std::vector<PlateRecord>& records);
+    void showRecordInTable(std::vector<PlateRecord> records);
+    void updateTableState();
     void showMessage(const QString& message, bool isError = false);
     void updateStatusBar(const QString& message);
     void updateActionStates();
     void applyFontScale(double scale);
     
     // UI组件
-    QTableWidget* tableWidget;
+    QTableView* tableView;
+    PlateTableModel* tableModel;
     QLineEdit* plateEdit;
     QLineEdit* cityEdit;
     QLineEdit* ownerEdit;
@@ -99,6 +121,7 @@ private:
     QTextEdit* infoText;
     QLabel* statusLabel;
     QProgressBar* progressBar;
+    QPushButton* cancelImportBtn;
     
     // 按钮
     QPushButton* addBtn;
@@ -119,6 +142,10 @@ private:
     
     // 数据
     PlateDatabase* database;
+    std::thread importThread;               // 后台导入线程
+    std::atomic<bool> importCancel;         // 请求取消导入
+    MetricsExporter* metricsExporter;       // Prometheus 指标导出（未配置时为空）
+    std::string traceFile;                  // 退出时写出的追踪文件（未开启时为空）
     QLabel* emptyStateLabel;
     QStackedLayout* stackedLayout;
     QFont baseFont;
@@ -0,0 +1,125 @@
+#include "PlateTableModel.h"
+#include <limits>
+#include <utility>
+
+namespace {
+    // 缓存槽数：远大于一屏行数，来回滚动时不必重复转换
+    const size_t CACHE_SLOTS = 4096;
+}
+
+PlateTableModel::PlateTableModel(QObject* parent)
+    : QAbstractTableModel(parent), showingResults(false), cache(CACHE_SLOTS)
+{
+}
+
+void PlateTableModel::setSnapshot(const SnapshotPtr& snapshot)
+{
+    beginResetModel();
+    snap = snapshot;
+    std::vector<PlateRecord>().swap(results);
+    showingResults = false;
+    clearCache();
+    endResetModel();
+}
+
+void PlateTableModel::setRecords(std::vector<PlateRecord> records)
+{
+    beginResetModel();
+    results.swap(records);
+    snap.reset();
+    showingResults = true;
+    clearCache();
+    endResetModel();
+}
+
+size_t PlateTableModel::recordCount() const
+{
+    if (showingResults) {
+        return results.size();
+    }
+    return snap ? snap->size() : 0;
+}
+
+PlateRecord PlateTableModel::recordAt(int row) const
+{
+    size_t i = static_cast<size_t>(row);
+    if (showingResults) {
+        return results[i];
+    }
+    // 按行取记录：映射快照不触发整表解码，改动过的记录表不触发拼接
+    return snap->recordAt(i);
+}
+
+int PlateTableModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    size_t n = recordCount();
+    size_t limit = static_cast<size_t>(std::numeric_limits<int>::max());
+    return static_cast<int>(n < limit ? n : limit);
+}
+
+int PlateTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : COL_COUNT;
+}
+
+QVariant PlateTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    int row = index.row();
+    if (index.column() == COL_INDEX) {
+        return QString::number(row + 1);   // 序号从1开始
+    }
+    
+    const CachedRow& cached = cachedRow(row);
+    switch (index.column()) {
+        case COL_PLATE:    return cached.plate;
+        case COL_CITY:     return cached.city;
+        case COL_OWNER:    return cached.owner;
+        case COL_CATEGORY: return cached.category;
+        default:           return QVariant();
+    }
+}
+
+QVariant PlateTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Vertical) {
+        return QString::number(section + 1);
+    }
+    switch (section) {
+        case COL_INDEX:    return QStringLiteral("序号");
+        case COL_PLATE:    return QStringLiteral("车牌号");
+        case COL_CITY:     return QStringLiteral("城市");
+        case COL_OWNER:    return QStringLiteral("车主");
+        case COL_CATEGORY: return QStringLiteral("类别");
+        default:           return QVariant();
+    }
+}
+
+const PlateTableModel::CachedRow& PlateTableModel::cachedRow(int row) const
+{
+    CachedRow& slot = cache[static_cast<size_t>(row) % cache.size()];
+    if (slot.row != row) {
+        PlateRecord rec = recordAt(row);
+        slot.row = row;
+        slot.plate = QString::fromStdString(rec.plate);
+        slot.city = QString::fromStdString(rec.city);
+        slot.owner = QString::fromStdString(rec.owner);
+        slot.category = QString::fromStdString(rec.category);
+    }
+    return slot;
+}
+
+void PlateTableModel::clearCache()
+{
+    for (size_t i = 0; i < cache.size(); ++i) {
+        cache[i] = CachedRow();
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef PLATETABLEMODEL_H
+#define PLATETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QString>
+#include "../include/PlateDatabase.h"
+#include <vector>
+
+/**
+ * 车牌记录表格模型
+ * 全部记录时直接持有数据库快照，查找结果时持有结果向量；视图只对可见行调用 data()，
+ * 按需取出单行并转换为 QString，转换结果放入按行号直接映射的小缓存，
+ * 显示千万级记录也不需要复制记录或逐行创建表格项。
+ */
+class PlateTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        COL_INDEX,          // 序号
+        COL_PLATE,          // 车牌号
+        COL_CITY,           // 城市
+        COL_OWNER,          // 车主
+        COL_CATEGORY,       // 类别
+        COL_COUNT
+    };
+    
+    explicit PlateTableModel(QObject* parent = nullptr);
+    
+    // 显示快照中的全部记录（只持有快照指针，O(1)）
+    void setSnapshot(const SnapshotPtr& snapshot);
+    
+    // 显示查找结果
+    void setRecords(std::vector<PlateRecord> records);
+    
+    // 第 row 行的完整记录
+    PlateRecord recordAt(int row) const;
+    
+    // 当前显示的记录数
+    size_t recordCount() const;
+    
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+private:
+    // 一行已转换的文本
+    struct CachedRow {
+        qint64 row;         // -1 表示空槽
+        QString plate;
+        QString city;
+        QString owner;
+        QString category;
+        
+        CachedRow() : row(-1) {}
+    };
+    
+    const CachedRow& cachedRow(int row) const;
+    void clearCache();
+    
+    SnapshotPtr snap;                       // 全部记录模式下的快照
+    std::vector<PlateRecord> results;       // 查找结果模式下的记录
+    bool showingResults;
+    mutable std::vector<CachedRow> cache;   // 按 row % 槽数直接映射
+};
+
+#endif // PLATETABLEMODEL_H
@@ -0,0 +1,110 @@
+#ifndef BINARY_CODEC_H
+#define BINARY_CODEC_H
+
+#include "PlateRecord.h"
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 二进制编码工具
+ * 小端定长整数、变长整数、带长度前缀的字符串与 CRC32，
+ * 供预写日志、增量文件等只追加的二进制格式共用
+ */
+namespace BinaryCodec {
+    // CRC-32（IEEE 802.3 多项式），crc 为上一段的结果，可分段计算
+    std::uint32_t crc32(const char* data, size_t n, std::uint32_t crc = 0);
+    
+    inline void putU32(std::string& out, std::uint32_t v) {
+        for (int i = 0; i < 4; i++) out.push_back(static_cast<char>(v >> (8 * i)));
+    }
+    
+    inline void putU64(std::string& out, std::uint64_t v) {
+        for (int i = 0; i < 8; i++) out.push_back(static_cast<char>(v >> (8 * i)));
+    }
+    
+    inline std::uint32_t getU32(const char* p) {
+        std::uint32_t v = 0;
+        for (int i = 0; i < 4; i++) v |= static_cast<std::uint32_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        return v;
+    }
+    
+    inline std::uint64_t getU64(const char* p) {
+        std::uint64_t v = 0;
+        for (int i = 0; i < 8; i++) v |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        return v;
+    }
+    
+    inline void putVarint(std::string& out, std::uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+    
+    inline void putString(std::string& out, const std::string& s) {
+        putVarint(out, s.size());
+        out.append(s);
+    }
+    
+    // 车牌、城市、车主、类别依次编码
+    inline void putRecord(std::string& out, const PlateRecord& r) {
+        putString(out, r.plate);
+        putString(out, r.city);
+        putString(out, r.owner);
+        putString(out, r.category);
+    }
+    
+    /**
+     * 顺序读取器，越界或格式错误时 ok 置为 false，之后的读取均返回空值
+     */
+    struct Reader {
+        const char* p;
+        const char* end;
+        bool ok;
+        
+        Reader(const char* b, const char* e) : p(b), end(e), ok(true) {}
+        
+        bool atEnd() const { return p == end; }
+        
+        unsigned char byte() {
+            if (p >= end) { ok = false; return 0; }
+            return static_cast<unsigned char>(*p++);
+        }
+        
+        std::uint64_t varint() {
+            std::uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (p >= end) { ok = false; return 0; }
+                unsigned char c = static_cast<unsigned char>(*p++);
+                v |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+                if (!(c & 0x80)) return v;
+            }
+            ok = false;
+            return 0;
+        }
+        
+        std::string str() {
+            std::uint64_t n = varint();
+            if (!ok || n > static_cast<std::uint64_t>(end - p)) {
+                ok = false;
+                return std::string();
+            }
+            std::string s(p, static_cast<size_t>(n));
+            p += n;
+            return s;
+        }
+        
+        PlateRecord record() {
+            PlateRecord r;
+            r.plate = str();
+            r.city = str();
+            r.owner = str();
+            r.category = str();
+            return r;
+        }
+    };
+}
+
+#endif // BINARY_CODEC_H
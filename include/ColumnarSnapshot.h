@@ -0,0 +1,145 @@
+#ifndef COLUMNAR_SNAPSHOT_H
+#define COLUMNAR_SNAPSHOT_H
+
+#include "PlateRecord.h"
+#include "RecordTable.h"
+#include "PlateKey.h"
+#include "MappedFile.h"
+#include "SearchAlgorithms.h"
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * 二进制列式快照（.psnap）
+ *
+ * 文件布局（小端，各列按 8 字节对齐）：
+ *   文件头      魔数 "PLATESNP"、版本号、排序/索引标志、行数、各段偏移、日志序号与快照标识
+ *   车牌列      uint64 PlateKey × 行数（保持保存时的记录顺序）
+ *   城市列      uint16 城市编号 × 行数
+ *   类别位图    每行 1 位，置位表示“电车”
+ *   车主偏移    uint64 × (行数 + 1)，指向车主字符串堆
+ *   车主字符串堆
+ *   城市字典    uint32 偏移 × (城市数 + 1) + 城市名字节
+ *   城市分块    {城市编号, 起始行, 行数} × 块数
+ *
+ * 打开时只映射文件并校验文件头，查询直接在映射的列上进行，无需解析；
+ * 需要完整记录向量时（写入、全表遍历）才按需解码一次并缓存。
+ */
+class ColumnarSnapshot {
+public:
+    // 当前格式版本
+    static const std::uint32_t FORMAT_VERSION = 2;
+    
+    ColumnarSnapshot();
+    
+    ColumnarSnapshot(const ColumnarSnapshot&) = delete;
+    ColumnarSnapshot& operator=(const ColumnarSnapshot&) = delete;
+    
+    /**
+     * 写入快照文件（先写临时文件再改名，保证文件完整）
+     * 返回 true 时文件内容与改名都已落盘
+     * @param walSequence 快照已包含的最后一条预写日志序号（未启用日志时为 0）
+     * @param snapshotId 快照标识，增量文件据此确认基准；为 0 时随机生成
+     * @return 是否成功
+     */
+    static bool write(const std::string& filename,
+                      const std::vector<PlateRecord>& records,
+                      const std::vector<CityBlock>& cityIndex,
+                      bool sortedByPlate, bool cityIndexBuilt,
+                      std::uint64_t walSequence = 0,
+                      std::uint64_t snapshotId = 0);
+    
+    // 同上，逐块读取分块记录表，不拼接整表
+    static bool write(const std::string& filename,
+                      const RecordTable& records,
+                      const std::vector<CityBlock>& cityIndex,
+                      bool sortedByPlate, bool cityIndexBuilt,
+                      std::uint64_t walSequence = 0,
+                      std::uint64_t snapshotId = 0);
+    
+    /**
+     * 生成新的快照标识（非 0 随机数）
+     */
+    static std::uint64_t newSnapshotId();
+    
+    /**
+     * 映射并校验快照文件
+     */
+    bool open(const std::string& filename);
+    
+    size_t size() const { return rowCount; }
+    bool isSortedByPlate() const { return sortedByPlate; }
+    bool isCityIndexBuilt() const { return cityIndexBuilt; }
+    std::uint64_t walSequence() const { return walSeq; }
+    std::uint64_t snapshotId() const { return id; }
+    
+    // ========== 按列访问 ==========
+    
+    PlateKey keyAt(size_t row) const { return keys[row]; }
+    const std::string& cityAt(size_t row) const;
+    std::string ownerAt(size_t row) const;
+    bool isNewEnergyAt(size_t row) const { return (categoryBits[row >> 3] >> (row & 7)) & 1; }
+    
+    /**
+     * 解码一行为完整记录
+     */
+    PlateRecord recordAt(size_t row) const;
+    
+    /**
+     * 城市分块索引（未持久化索引时为空）
+     */
+    const std::vector<CityBlock>& cityIndex() const { return blocks; }
+    
+    /**
+     * 城市数：字典只收录出现过的城市且互不重复，条目数即城市数，无需解码
+     */
+    size_t cityCount() const { return cities.size(); }
+    
+    // ========== 直接在列上查询 ==========
+    
+    /**
+     * 精确查找：已排序时在车牌列上折半查找，否则顺序扫描车牌列
+     */
+    SearchResult find(const std::string& plate) const;
+    
+    /**
+     * 前缀查找：把前缀换算为编码区间后在车牌列上筛选
+     */
+    std::vector<PlateRecord> prefixSearch(const std::string& prefix) const;
+    
+    /**
+     * 解码全部记录（首次调用时并行解码并缓存，线程安全）
+     */
+    const std::vector<PlateRecord>& records() const;
+    
+    // 是否已解码过全部记录（解码缓存占用堆内存）
+    bool isDecoded() const { return decodedReady.load(); }
+    
+    // 映射的文件字节数（按需调页，不占堆内存）
+    size_t mappedBytes() const { return file.size(); }
+
+private:
+    MappedFile file;
+    size_t rowCount;
+    bool sortedByPlate;
+    bool cityIndexBuilt;
+    std::uint64_t walSeq;
+    std::uint64_t id;
+    
+    const std::uint64_t* keys;
+    const std::uint16_t* cityIds;
+    const std::uint8_t* categoryBits;
+    const std::uint64_t* ownerOffsets;
+    const char* ownerHeap;
+    std::vector<std::string> cities;    // 城市字典（条目很少，打开时展开）
+    std::vector<CityBlock> blocks;
+    
+    mutable std::once_flag decodeOnce;
+    mutable std::vector<PlateRecord> decoded;
+    mutable std::atomic<bool> decodedReady;
+};
+
+#endif // COLUMNAR_SNAPSHOT_H
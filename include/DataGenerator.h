@@ -0,0 +1,249 @@
+#ifndef DATA_GENERATOR_H
+#define DATA_GENERATOR_H
+
+#include "PlateRecord.h"
+#include "FileIO.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+/**
+ * xoshiro256** 伪随机数发生器
+ * 状态 256 位，每个输出只需几次移位、旋转与乘法，统计质量远好于线性同余；
+ * 64 位种子经 SplitMix64 扩展为内部状态，相同种子得到相同序列。
+ */
+class Xoshiro256 {
+public:
+    explicit Xoshiro256(std::uint64_t seed = 0) {
+        std::uint64_t x = seed;
+        for (int i = 0; i < 4; ++i) {
+            s[i] = splitMix64(x);
+        }
+    }
+    
+    std::uint64_t next() {
+        std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+    
+    // [0, bound) 内的整数（取高 32 位乘法映射，不做除法）
+    std::uint32_t below(std::uint32_t bound) {
+        return static_cast<std::uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+    
+    // [0, 1) 内的浮点数
+    double uniform() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+    
+    // SplitMix64：推进 state 并返回一个充分混合的 64 位值
+    static std::uint64_t splitMix64(std::uint64_t& state) {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    
+private:
+    std::uint64_t s[4];
+    
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+/**
+ * Zipf 分布采样（Hörmann–Derflinger 拒绝-反演法）
+ * 返回 [1, n] 中的整数，P(k) ∝ 1 / k^exponent；构造为 O(1)，n 可达数十亿。
+ * exponent 为 0 时退化为均匀分布。
+ */
+class ZipfSampler {
+public:
+    ZipfSampler(std::uint64_t n, double exponent)
+        : n(n == 0 ? 1 : n), s(exponent), hX1(0.0), hN(0.0), threshold(0.0) {
+        if (s > 0.0) {
+            hX1 = hIntegral(1.5) - 1.0;
+            hN = hIntegral(static_cast<double>(this->n) + 0.5);
+            threshold = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+        }
+    }
+    
+    std::uint64_t sample(Xoshiro256& rng) const {
+        if (s <= 0.0) {
+            return 1 + static_cast<std::uint64_t>(rng.uniform() * static_cast<double>(n));
+        }
+        for (;;) {
+            double u = hN + rng.uniform() * (hX1 - hN);
+            double x = hIntegralInverse(u);
+            double k = std::floor(x + 0.5);
+            if (k < 1.0) k = 1.0;
+            if (k > static_cast<double>(n)) k = static_cast<double>(n);
+            if (k - x <= threshold || u >= hIntegral(k + 0.5) - h(k)) {
+                return static_cast<std::uint64_t>(k);
+            }
+        }
+    }
+    
+private:
+    std::uint64_t n;
+    double s;
+    double hX1;
+    double hN;
+    double threshold;
+    
+    double h(double x) const { return std::exp(-s * std::log(x)); }
+    
+    double hIntegral(double x) const {
+        double logX = std::log(x);
+        return helper2((1.0 - s) * logX) * logX;
+    }
+    
+    double hIntegralInverse(double x) const {
+        double t = x * (1.0 - s);
+        if (t < -1.0) t = -1.0;
+        return std::exp(helper1(t) * x);
+    }
+    
+    // log1p(x) / x 与 expm1(x) / x，在 0 附近用级数避免相消
+    static double helper1(double x) {
+        return std::fabs(x) > 1e-8 ? std::log1p(x) / x
+                                   : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+    static double helper2(double x) {
+        return std::fabs(x) > 1e-8 ? std::expm1(x) / x
+                                   : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+    }
+};
+
+/**
+ * 数据分布参数
+ * 默认值近似真实流量：沈阳、大连占大头，约三成新能源，部分号段明显更密，部分车主名下多辆车
+ */
+struct WorkloadSpec {
+    double cityZipf;                    // 城市按 沈阳、大连、鞍山…… 的顺序服从 Zipf 分布的指数，0 为均匀
+    std::vector<double> cityWeights;    // 各城市权重（按同一顺序，14 个）；非空时代替 cityZipf
+    double evShare;                     // 新能源占比，纯电 D 与插混 F 各半
+    unsigned clusterCount;              // 每个号段中的热点编号区间数
+    std::uint32_t clusterWidth;         // 每个热点区间的编号数
+    double clusterShare;                // 落在热点区间内的车牌比例
+    double vehiclesPerOwner;            // 每位车主平均车辆数（≥ 1），车主编号附在姓名后
+    
+    WorkloadSpec()
+        : cityZipf(1.0), evShare(0.3), clusterCount(8), clusterWidth(39304),
+          clusterShare(0.6), vehiclesPerOwner(1.5) {}
+};
+
+/**
+ * 查询类型
+ */
+enum QueryType {
+    QUERY_LOOKUP,       // 精确查找
+    QUERY_PREFIX,       // 前缀查找
+    QUERY_CITY          // 城市查找
+};
+
+/**
+ * 一条查询
+ */
+struct WorkloadQuery {
+    QueryType type;
+    std::string key;        // 车牌 / 前缀 / 城市名
+    bool expectHit;         // 精确查找时表示车牌是否存在
+    
+    WorkloadQuery() : type(QUERY_LOOKUP), expectHit(false) {}
+};
+
+/**
+ * 查询组合参数
+ */
+struct QueryMixSpec {
+    double prefixShare;     // 前缀查询比例
+    double cityShare;       // 城市查询比例（其余为精确查找）
+    double hitRatio;        // 精确查找中命中的比例
+    unsigned minPrefix;     // 前缀长度（“辽”之后的字符数）下限
+    unsigned maxPrefix;     // 前缀长度上限
+    double keyZipf;         // 被查询记录的 Zipf 指数（热点记录），0 为均匀
+    
+    QueryMixSpec()
+        : prefixShare(0.1), cityShare(0.05), hitRatio(0.9),
+          minPrefix(1), maxPrefix(4), keyZipf(0.99) {}
+};
+
+/**
+ * 合成数据生成器（压测用）
+ *
+ * 第 i 行的车牌由以种子为密钥的 Feistel 置换把 i 映射到全部号段
+ * （14 个城市字母 × 燃油/D/F × 34^5 个编号，约 19 亿）中的一个位置，
+ * 置换是双射，因此任意行号互不相同的行车牌必然不同，无需查重。
+ * 车主姓名由 xoshiro256** 生成；每 STREAM_ROWS 行使用一个由种子和段号派生的独立随机数流，
+ * 同一种子、同一行号区间的输出与线程数无关，跨运行完全可复现。
+ */
+class DataGenerator {
+public:
+    // 每个随机数流覆盖的行数，也是并行生成的任务粒度
+    static const size_t STREAM_ROWS = 65536;
+    
+    /**
+     * 可生成的不重复车牌总数
+     */
+    static std::uint64_t capacity();
+    
+    /**
+     * 第 row 行的车牌（不生成整行）
+     */
+    static std::string plateAt(std::uint64_t seed, std::uint64_t row);
+    
+    /**
+     * 生成第 [first, first + count) 行并追加到 records
+     * @param threads 线程数，0 表示使用硬件线程数
+     * @return 行号超出 capacity() 时返回 false，records 不变
+     */
+    static bool generate(std::uint64_t seed, std::uint64_t first, size_t count,
+                         std::vector<PlateRecord>& records, unsigned threads = 0);
+    
+    /**
+     * 把第 [0, count) 行直接写入文本（csv 为 true 时为 CSV）文件，不在内存中保留记录
+     * 文件格式与 FileIO::saveToFile / exportToCSV 相同
+     */
+    static bool writeFile(const std::string& filename, std::uint64_t seed, size_t count,
+                          bool csv = false, const ProgressFn& progress = ProgressFn(),
+                          SaveReport* report = nullptr, unsigned threads = 0);
+    
+    /**
+     * 按分布参数生成第 [0, count) 行并追加到 records
+     * 每行先按城市权重与新能源占比选定号段，再取该号段中的下一个序号；
+     * 序号经“热点区间优先”的双射映射为编号，因此车牌仍互不重复。
+     * 两遍生成：第一遍并行统计每段各号段的行数，第二遍据此得到每行的序号。
+     * @return 参数非法或某号段容量不足时返回 false，records 不变
+     */
+    static bool generate(const WorkloadSpec& spec, std::uint64_t seed, size_t count,
+                         std::vector<PlateRecord>& records, unsigned threads = 0);
+    
+    /**
+     * 按分布参数把第 [0, count) 行直接写入文件
+     */
+    static bool writeFile(const std::string& filename, const WorkloadSpec& spec,
+                          std::uint64_t seed, size_t count, bool csv = false,
+                          const ProgressFn& progress = ProgressFn(),
+                          SaveReport* report = nullptr, unsigned threads = 0);
+    
+    /**
+     * 针对 data 生成 count 条查询
+     * 命中查询按 keyZipf 偏向少数热点记录，未命中查询是 data 中不存在的合法车牌，
+     * 前缀与城市查询取自同样偏斜的记录
+     */
+    static std::vector<WorkloadQuery> generateQueries(const std::vector<PlateRecord>& data,
+                                                      const QueryMixSpec& mix,
+                                                      std::uint64_t seed, size_t count);
+};
+
+#endif // DATA_GENERATOR_H
@@ -0,0 +1,60 @@
+#ifndef DATA_VALIDATOR_H
+#define DATA_VALIDATOR_H
+
+#include "PlateRecord.h"
+#include "RecordTable.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+/**
+ * 数据验证报告
+ * 计数覆盖全部记录，明细只保留前 maxSamples 条（非法与不匹配按记录顺序，重复按车牌顺序）
+ */
+struct ValidationReport {
+    size_t total;                   // 总记录数
+    size_t invalid;                 // 非法车牌数
+    size_t duplicates;              // 重复车牌数（多出的副本数）
+    size_t mismatches;              // 车牌字母与城市不匹配的合法记录数
+    size_t maxSamples;              // 明细上限
+    std::vector<std::string> invalidSamples;                        // 非法车牌
+    std::vector<std::pair<std::string, size_t>> duplicateSamples;   // 重复车牌与出现次数
+    size_t duplicatePlates;         // 出现多次的不同车牌数
+    std::vector<std::pair<std::string, std::string>> mismatchSamples; // 车牌与城市
+    double timeMs;                  // 耗时（毫秒）
+    unsigned threads;               // 使用的线程数
+    
+    ValidationReport()
+        : total(0), invalid(0), duplicates(0), mismatches(0), maxSamples(10),
+          duplicatePlates(0), timeMs(0.0), threads(1) {}
+    
+    // 是否通过完整性检查（无非法、无重复）
+    bool passed() const { return invalid == 0 && duplicates == 0; }
+    
+    // 生成文字版报告
+    std::string toString() const;
+};
+
+/**
+ * 数据验证引擎
+ *
+ * 单遍扫描：各线程处理相邻的一段记录，逐条完成车牌校验与编码、
+ * 按字母直接查表比对城市，并把合法车牌的编码按散列值分到若干分区；
+ * 随后各分区并行排序、比较相邻编码得出重复车牌。
+ * 各线程的计数与明细按记录顺序合并为一个报告。
+ */
+class DataValidator {
+public:
+    /**
+     * 验证全部记录
+     * @param threads 线程数，0 表示使用硬件线程数
+     */
+    static ValidationReport validate(const std::vector<PlateRecord>& records,
+                                     unsigned threads = 0);
+    
+    // 同上，各线程逐块扫描分块记录表中相邻的一段，不拼接整表
+    static ValidationReport validate(const RecordTable& records, unsigned threads = 0);
+};
+
+#endif // DATA_VALIDATOR_H
@@ -0,0 +1,61 @@
+#ifndef DELTA_FILE_H
+#define DELTA_FILE_H
+
+#include "PlateRecord.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * 一条记录的变化
+ */
+struct DeltaChange {
+    bool removed;           // true 表示删除，false 表示插入或更新
+    PlateRecord record;     // 删除时只有车牌
+    
+    DeltaChange() : removed(false) {}
+    DeltaChange(bool r, const PlateRecord& rec) : removed(r), record(rec) {}
+};
+
+/**
+ * 增量文件（base.psnap.N.delta）
+ *
+ * 记录基准快照之后第 N 次增量保存时的变化，按序号依次叠加到基准快照上：
+ *   魔数 "PLATEDLT" | uint32 版本 | uint32 标志 | uint64 基准快照标识 | uint64 序号
+ *   | uint64 条数 | 条目 × 条数 | uint32 CRC32
+ * 标志位 1 表示应用本文件前先清空数据。条目为 uint8 类型（1 插入或更新，2 删除）
+ * 加上完整记录或车牌，字符串以变长整数长度为前缀。
+ */
+class DeltaFile {
+public:
+    static const std::uint32_t FORMAT_VERSION = 1;
+    
+    /**
+     * 基准快照的第 sequence 个增量文件路径
+     */
+    static std::string pathFor(const std::string& baseFile, std::uint64_t sequence);
+    
+    /**
+     * 写入增量文件（先写临时文件再改名）
+     * 返回 true 时文件内容与改名都已落盘
+     * @param cleared 变化之前是否执行过清空
+     */
+    static bool write(const std::string& filename, std::uint64_t baseId,
+                      std::uint64_t sequence, bool cleared,
+                      const std::vector<DeltaChange>& changes);
+    
+    /**
+     * 读取并校验增量文件
+     * @return 文件完整且格式正确时返回 true
+     */
+    static bool read(const std::string& filename, std::uint64_t* baseId,
+                     std::uint64_t* sequence, bool* cleared,
+                     std::vector<DeltaChange>& changes);
+    
+    /**
+     * 删除基准快照的全部增量文件（从序号 1 开始直到第一个不存在的文件）
+     */
+    static void removeAll(const std::string& baseFile);
+};
+
+#endif // DELTA_FILE_H
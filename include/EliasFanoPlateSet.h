@@ -0,0 +1,118 @@
+#ifndef ELIAS_FANO_PLATE_SET_H
+#define ELIAS_FANO_PLATE_SET_H
+
+#include "PlateRecord.h"
+#include "PlateKey.h"
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Elias–Fano 压缩的有序车牌集合
+ *
+ * 把排好序的 PlateKey 序列拆成低 l 位与高位两部分：
+ *   低位    每个元素 l 位，紧密排列
+ *   高位    一元编码的位向量，第 i 个元素在 (key >> l) + i 处置 1
+ * 编码先减去最小值再拆分，其中 l = floor(log2(取值跨度 / 元素数))，每个元素约占 l + 2 位。
+ * 高位向量每 256 个 1 和每 256 个 0 各记录一个采样位置，
+ * select（取第 i 个）与 rank（小于给定编码的个数）只需从采样点扫描少量机器字。
+ *
+ * 集合构建后只读；查找、前缀区间、按序遍历都直接在压缩形式上进行。
+ * 用于只读归档：按车牌排序后的快照中，集合下标与记录行号一致。
+ */
+class EliasFanoPlateSet {
+public:
+    /**
+     * 顺序遍历器，逐个解码，无需逐次 select
+     */
+    class Iterator {
+    public:
+        /**
+         * 取下一个编码
+         * @return 已到末尾时返回 false
+         */
+        bool next(PlateKey& key);
+        
+    private:
+        friend class EliasFanoPlateSet;
+        Iterator(const EliasFanoPlateSet* set, size_t index);
+        
+        const EliasFanoPlateSet* set;
+        size_t index;       // 下一个元素的下标
+        size_t pos;         // 下一个元素在高位向量中的位置
+    };
+    
+    EliasFanoPlateSet();
+    
+    /**
+     * 由非降序排列的编码构建
+     */
+    void build(const std::vector<PlateKey>& sortedKeys);
+    
+    /**
+     * 由记录构建（非法车牌跳过，编码后排序）
+     */
+    void build(const std::vector<PlateRecord>& records);
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    
+    /**
+     * 第 i 个编码（0 ≤ i < size()）
+     */
+    PlateKey select(size_t i) const;
+    
+    /**
+     * 第 i 个车牌
+     */
+    std::string plateAt(size_t i) const { return PlateCodec::decode(select(i)); }
+    
+    /**
+     * 小于 key 的元素个数（即 key 的下界位置）
+     */
+    size_t rank(PlateKey key) const;
+    
+    /**
+     * 精确查找
+     * @return 车牌所在下标，未找到返回 -1
+     */
+    long long find(const std::string& plate) const;
+    
+    /**
+     * 以 prefix 开头的车牌所在的下标区间 [first, last)
+     */
+    std::pair<size_t, size_t> prefixRange(const std::string& prefix) const;
+    
+    /**
+     * 从第 from 个元素开始遍历
+     */
+    Iterator iterate(size_t from = 0) const { return Iterator(this, from); }
+    
+    /**
+     * 占用的内存字节数
+     */
+    size_t memoryBytes() const;
+
+private:
+    size_t count;                       // 元素个数
+    PlateKey base;                      // 最小编码，各元素存储与它的差
+    unsigned lowWidth;                  // 低位宽度 l
+    std::uint64_t lowMask;
+    std::uint64_t maxHigh;              // 最大高位值
+    size_t highLength;                  // 高位向量位数
+    std::vector<std::uint64_t> low;     // 低位数组
+    std::vector<std::uint64_t> high;    // 高位向量
+    std::vector<size_t> oneSamples;     // 第 k*256 个 1 的位置
+    std::vector<size_t> zeroSamples;    // 第 k*256 个 0 的位置
+    
+    std::uint64_t lowAt(size_t i) const;
+    bool highBit(size_t pos) const { return (high[pos >> 6] >> (pos & 63)) & 1; }
+    
+    // 第 i 个 1 / 第 i 个 0 在高位向量中的位置（均从 0 计）
+    size_t select1(size_t i) const;
+    size_t select0(size_t i) const;
+};
+
+#endif // ELIAS_FANO_PLATE_SET_H
@@ -2,8 +2,86 @@
 #define FILE_IO_H
 
 #include "PlateRecord.h"
+#include "RecordTable.h"
 #include <string>
 #include <vector>
+#include <cstddef>
+#include <functional>
+
+/**
+ * 导入时被跳过的一行
+ */
+struct LoadError {
+    size_t line;            // 行号（从 1 开始）
+    std::string text;       // 出错字段内容
+    std::string reason;     // 原因说明
+    
+    LoadError() : line(0) {}
+    LoadError(size_t l, const std::string& t, const std::string& r)
+        : line(l), text(t), reason(r) {}
+};
+
+/**
+ * 导入报告
+ * 非法行只保留前 maxErrors 条明细，其余只计数
+ */
+struct LoadReport {
+    size_t bytesRead;               // 读取字节数
+    size_t linesRead;               // 读取行数（含空行与表头）
+    size_t imported;                // 成功导入记录数
+    size_t skipped;                 // 跳过的非法记录数
+    size_t cityMismatches;          // 车牌字母与城市不匹配的记录数（照常导入）
+    size_t maxErrors;               // 明细上限
+    std::vector<LoadError> errors;  // 非法记录明细
+    double timeMs;                  // 耗时（毫秒）
+    bool cancelled;                 // 是否被进度回调取消
+    
+    LoadReport()
+        : bytesRead(0), linesRead(0), imported(0), skipped(0),
+          cityMismatches(0), maxErrors(100), timeMs(0.0), cancelled(false) {}
+    
+    // 记录一条非法行（超过上限时只计数）
+    void addError(size_t line, const char* text, size_t len, const char* reason);
+    
+    // 生成文字版报告
+    std::string toString() const;
+};
+
+/**
+ * 保存报告
+ */
+struct SaveReport {
+    size_t records;                 // 写出记录数
+    size_t bytesWritten;            // 写出字节数
+    double timeMs;                  // 耗时（毫秒）
+    
+    SaveReport() : records(0), bytesWritten(0), timeMs(0.0) {}
+    
+    // 写出速度（字节/秒）
+    double bytesPerSecond() const {
+        return timeMs > 0.0 ? bytesWritten * 1000.0 / timeMs : 0.0;
+    }
+};
+
+/**
+ * 进度回调：done 为已处理记录数，total 为总数；返回 false 表示取消
+ */
+typedef std::function<bool(size_t done, size_t total)> ProgressFn;
+
+/**
+ * 导入进度回调：已处理字节数、文件总字节数、已导入记录数；返回 false 表示取消
+ */
+typedef std::function<bool(size_t bytesDone, size_t bytesTotal, size_t rows)> ImportProgressFn;
+
+/**
+ * 导入批次回调：batch 为一批已校验的记录，可直接移走；返回 false 表示取消
+ */
+typedef std::function<bool(std::vector<PlateRecord>& batch)> ImportBatchFn;
+
+/**
+ * 块格式化回调：把第 [first, last) 行格式化后写入 out（覆盖原内容，缓冲区跨块复用）
+ */
+typedef std::function<void(size_t first, size_t last, std::string& out)> ChunkFormatFn;
 
 /**
  * 文件IO模块
@@ -13,30 +91,98 @@ class FileIO {
 public:
     /**
      * 从文件加载记录
+     * 文件通过内存映射读入，逐行原地切分字段，车牌校验与编码不产生临时字符串，
+     * 合法记录直接追加到 records 末尾
      * @param filename 文件名
-     * @param records 输出参数，加载的记录
+     * @param records 输出参数，加载的记录（追加）
+     * @param report 导入报告（可为空）
      * @return 是否成功
      */
     static bool loadFromFile(const std::string& filename, 
-                            std::vector<PlateRecord>& records);
+                            std::vector<PlateRecord>& records,
+                            LoadReport* report = nullptr);
+    
+    /**
+     * 多线程并行加载
+     * 在换行处把文件切分为若干块，各线程独立完成切分、校验和编码，
+     * 结果按块顺序拼接，记录顺序与单线程加载一致
+     * @param threads 线程数，0 表示使用硬件线程数
+     */
+    static bool loadFromFileParallel(const std::string& filename,
+                                    std::vector<PlateRecord>& records,
+                                    LoadReport* report = nullptr,
+                                    unsigned threads = 0);
+    
+    /**
+     * 流式导入
+     * 逐批（每批 batchRows 行）切分、校验文件内容并交给 sink，批次缓冲区复用，
+     * 已处理部分的映射页随即释放，导入额外占用的内存与文件大小无关。
+     * 每批之后调用 progress；sink 或 progress 返回 false 时停止并置 report->cancelled
+     * @return 文件无法打开或被取消时返回 false
+     */
+    static bool importStreaming(const std::string& filename,
+                               const ImportBatchFn& sink,
+                               const ImportProgressFn& progress = ImportProgressFn(),
+                               LoadReport* report = nullptr,
+                               size_t batchRows = 65536);
     
     /**
      * 保存记录到文件
+     * 记录按块格式化到可复用的大缓冲区，每块一次 write；
+     * 多线程时各线程格式化不同的块，再按顺序写出，文件内容与单线程一致
      * @param filename 文件名
      * @param records 要保存的记录
+     * @param progress 进度回调（可为空），取消时删除未写完的文件
+     * @param report 保存报告（可为空）
+     * @param threads 格式化线程数，0 表示使用硬件线程数
      * @return 是否成功
      */
     static bool saveToFile(const std::string& filename,
-                          const std::vector<PlateRecord>& records);
+                          const std::vector<PlateRecord>& records,
+                          const ProgressFn& progress = ProgressFn(),
+                          SaveReport* report = nullptr,
+                          unsigned threads = 0);
+    
+    // 同上，逐块读取分块记录表，不拼接整表
+    static bool saveToFile(const std::string& filename,
+                          const RecordTable& records,
+                          const ProgressFn& progress = ProgressFn(),
+                          SaveReport* report = nullptr,
+                          unsigned threads = 0);
     
     /**
-     * 导出为CSV格式
+     * 导出为CSV格式（写出方式同 saveToFile）
      * @param filename 文件名
      * @param records 要保存的记录
+     * @param progress 进度回调（可为空），取消时删除未写完的文件
+     * @param report 保存报告（可为空）
+     * @param threads 格式化线程数，0 表示使用硬件线程数
      * @return 是否成功
      */
     static bool exportToCSV(const std::string& filename,
-                           const std::vector<PlateRecord>& records);
+                           const std::vector<PlateRecord>& records,
+                           const ProgressFn& progress = ProgressFn(),
+                           SaveReport* report = nullptr,
+                           unsigned threads = 0);
+    
+    static bool exportToCSV(const std::string& filename,
+                           const RecordTable& records,
+                           const ProgressFn& progress = ProgressFn(),
+                           SaveReport* report = nullptr,
+                           unsigned threads = 0);
+    
+    /**
+     * 按块写出 rows 行
+     * 每轮由各线程调用 format 格式化相邻的若干块（每块 65536 行），再按块顺序写出；
+     * saveToFile / exportToCSV 与合成数据生成共用此实现
+     * @param header 表头（可为空）
+     * @param progress 进度回调（可为空），取消时删除未写完的文件
+     */
+    static bool writeChunks(const std::string& filename, size_t rows,
+                           const ChunkFormatFn& format, const char* header = nullptr,
+                           const ProgressFn& progress = ProgressFn(),
+                           SaveReport* report = nullptr,
+                           unsigned threads = 0);
 };
 
 #endif // FILE_IO_H
@@ -0,0 +1,30 @@
+#ifndef FILE_SYNC_H
+#define FILE_SYNC_H
+
+#include <string>
+
+/**
+ * 落盘工具
+ * 快照、增量文件先写临时文件再改名；改名前临时文件须已落盘，
+ * 改名后还须把所在目录落盘，目录项才能在崩溃后保留
+ */
+namespace FileSync {
+    /**
+     * 把文件内容刷到磁盘
+     * @return fsync 成功时返回 true（不支持的平台直接返回 true）
+     */
+    bool syncFile(const std::string& filename);
+    
+    /**
+     * 把 path 所在目录刷到磁盘，使其中的新建、改名、删除在崩溃后仍然有效
+     */
+    bool syncParentDirectory(const std::string& path);
+    
+    /**
+     * 用已写完的临时文件原子替换目标文件：临时文件落盘 → 改名 → 目录落盘
+     * 失败时删除临时文件并在 stderr 给出原因
+     */
+    bool commitReplace(const std::string& tmpName, const std::string& filename);
+}
+
+#endif // FILE_SYNC_H
@@ -0,0 +1,53 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * 只读文件映射
+ * POSIX 平台使用 mmap 把整个文件映射进内存，按需由操作系统分页读入；
+ * 其他平台退化为一次性读入缓冲区。对象析构时自动解除映射。
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    /**
+     * 打开并映射文件
+     * @param sequential 提示内核按顺序预读
+     * @return 是否成功
+     */
+    bool open(const std::string& filename, bool sequential = true);
+    
+    /**
+     * 解除映射
+     */
+    void close();
+    
+    /**
+     * 提示不再访问 [offset, offset + len) 范围，已读入的页可被立即回收
+     * 流式处理大文件时用于限制常驻内存；无 mmap 的平台上不做任何事
+     */
+    void release(size_t offset, size_t len);
+    
+    bool isOpen() const { return opened; }
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+    const char* begin() const { return base; }
+    const char* end() const { return base + length; }
+
+private:
+    const char* base;
+    size_t length;
+    bool opened;
+    bool mapped;                // true 表示 base 来自 mmap
+    std::vector<char> buffer;   // 无 mmap 时的读入缓冲
+};
+
+#endif // MAPPED_FILE_H
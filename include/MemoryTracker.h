@@ -0,0 +1,114 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/**
+ * 临时缓冲区内存计数
+ * 排序、导入、验证过程中的临时缓冲经 TrackingAllocator 分配（类型固定、无法换分配器的
+ * 缓冲用 Hold 登记），按类别累计当前字节数与峰值，另记各类别同时占用之和的峰值
+ * （观测到的最高水位，而非各类峰值相加）。计数全进程共享，只做原子累加；
+ * 多个数据库（如分片）同时工作时峰值是它们的合计。
+ */
+class MemoryTracker {
+public:
+    enum Category {
+        SORT,           // 基数排序的静态链表与重排缓冲
+        IMPORT,         // 并行导入各线程的私有记录缓冲、流式导入的批缓冲
+        VALIDATE,       // 数据验证的编码分区
+        REWRITE,        // 排序、建索引、回放时整表复制出的新记录（发布前与旧快照并存）
+        CATEGORY_COUNT
+    };
+    
+    static const char* label(Category c);
+    
+    // 英文标识（指标标签等机器可读的场合）
+    static const char* name(Category c);
+    
+    static void allocated(Category c, size_t bytes);
+    static void released(Category c, size_t bytes);
+    
+    static size_t current(Category c);
+    static size_t peak(Category c);
+    
+    // 全部类别合计的当前字节数与峰值
+    static size_t totalCurrent();
+    static size_t totalPeak();
+    
+    // 把各类别及合计的峰值重置为当前值
+    static void resetPeaks();
+    
+    // 字符串单独占用的堆字节数（内容在短字符串缓冲内时为 0）
+    static size_t heapBytes(const std::string& s) {
+        const char* p = s.data();
+        const char* self = reinterpret_cast<const char*>(&s);
+        return (p >= self && p < self + sizeof(s)) ? 0 : s.capacity() + 1;
+    }
+    
+    // 把字节数格式化为带单位的文本（B / KB / MB / GB）
+    static std::string formatBytes(double bytes);
+    
+    /**
+     * 作用域登记：构造时计入 bytes，析构时扣除；set 调整登记的字节数
+     */
+    class Hold {
+    public:
+        Hold(Category c, size_t bytes = 0) : category(c), held(0) { set(bytes); }
+        ~Hold() { set(0); }
+        
+        void set(size_t bytes) {
+            if (bytes > held) {
+                allocated(category, bytes - held);
+            } else if (bytes < held) {
+                released(category, held - bytes);
+            }
+            held = bytes;
+        }
+    
+    private:
+        Hold(const Hold&);
+        Hold& operator=(const Hold&);
+        
+        Category category;
+        size_t held;
+    };
+};
+
+/**
+ * 计数分配器：按 std::allocator 分配，同时把字节数计入 MemoryTracker 的类别 C
+ */
+template <typename T, MemoryTracker::Category C>
+class TrackingAllocator {
+public:
+    typedef T value_type;
+    
+    template <typename U>
+    struct rebind {
+        typedef TrackingAllocator<U, C> other;
+    };
+    
+    TrackingAllocator() {}
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U, C>&) {}
+    
+    T* allocate(size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        MemoryTracker::allocated(C, n * sizeof(T));
+        return p;
+    }
+    
+    void deallocate(T* p, size_t n) {
+        MemoryTracker::released(C, n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+};
+
+template <typename T, typename U, MemoryTracker::Category C>
+bool operator==(const TrackingAllocator<T, C>&, const TrackingAllocator<U, C>&) { return true; }
+
+template <typename T, typename U, MemoryTracker::Category C>
+bool operator!=(const TrackingAllocator<T, C>&, const TrackingAllocator<U, C>&) { return false; }
+
+#endif // MEMORY_TRACKER_H
@@ -0,0 +1,188 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * 对数-线性延迟直方图（HDR 风格，单位纳秒）
+ * 小于 32 ns 的值每 1 ns 一格；之后每个 2 的幂区间等分为 16 格，
+ * 相对误差不超过 1/16。上限约 2^40 ns（18 分钟），更大的值计入最后一格。
+ * 本类不做同步，用于汇总后的只读结果。
+ */
+class LatencyHistogram {
+public:
+    static const unsigned SUB_BITS = 4;
+    static const unsigned MAX_BITS = 40;
+    static const size_t BUCKET_COUNT = (MAX_BITS - SUB_BITS + 1) * (1u << SUB_BITS);
+    
+    LatencyHistogram();
+    
+    static size_t bucketOf(std::uint64_t nanos);
+    // 第 index 格的取值区间 [lowerBound, upperBound)
+    static std::uint64_t lowerBound(size_t index);
+    static std::uint64_t upperBound(size_t index);
+    
+    void add(size_t index, std::uint64_t count);
+    std::uint64_t count() const { return total; }
+    std::uint64_t bucket(size_t index) const { return counts[index]; }
+    
+    // 取值不超过 nanos 的样本数（按格计，跨越 nanos 的格不计入）
+    std::uint64_t countAtMost(std::uint64_t nanos) const;
+    
+    /**
+     * 分位数（q ∈ [0, 1]），返回所在格的中点（纳秒）
+     * 没有样本时返回 0
+     */
+    double percentile(double q) const;
+
+private:
+    std::uint64_t counts[BUCKET_COUNT];
+    std::uint64_t total;
+};
+
+/**
+ * 单个操作的汇总统计
+ */
+struct OperationStats {
+    std::uint64_t calls;            // 调用次数（含未计时的调用）
+    std::uint64_t items;            // 处理的条目数（查找为次数，排序 / 导入等为记录数）
+    std::uint64_t samples;          // 计时样本数
+    std::uint64_t sampledItems;     // 计时样本覆盖的条目数
+    std::uint64_t bytes;            // 写出的字节数（目前只有保存 / 导出记录）
+    std::uint64_t sampledBytes;     // 计时样本覆盖的字节数
+    std::uint64_t totalNanos;       // 计时样本总耗时
+    std::uint64_t maxNanos;         // 最大单次耗时
+    LatencyHistogram histogram;
+    
+    OperationStats()
+        : calls(0), items(0), samples(0), sampledItems(0), bytes(0), sampledBytes(0),
+          totalNanos(0), maxNanos(0) {}
+    
+    // 分位数（纳秒），不超过实测最大值
+    double percentile(double q) const {
+        double v = histogram.percentile(q);
+        return v > static_cast<double>(maxNanos) ? static_cast<double>(maxNanos) : v;
+    }
+    double meanNanos() const { return samples ? static_cast<double>(totalNanos) / samples : 0.0; }
+    // 吞吐：计时期间每秒处理的条目数
+    double throughput() const {
+        return totalNanos ? sampledItems * 1e9 / static_cast<double>(totalNanos) : 0.0;
+    }
+    // 字节吞吐：计时期间每秒写出的字节数
+    double bytesPerSecond() const {
+        return totalNanos ? sampledBytes * 1e9 / static_cast<double>(totalNanos) : 0.0;
+    }
+};
+
+/**
+ * 操作指标登记表
+ * 每个操作一组计数器和延迟直方图。写入按线程分散到若干分片，
+ * 只做无竞争的原子累加，读取时再汇总；高频操作按间隔抽样计时，
+ * 避免每次调用都读两次时钟。
+ */
+class Metrics {
+public:
+    enum Operation {
+        OP_FIND,        // 精确查找
+        OP_PREFIX,      // 前缀查找
+        OP_CITY,        // 按城市查找
+        OP_SORT,        // 排序
+        OP_IMPORT,      // 导入
+        OP_SAVE,        // 保存 / 导出
+        OP_VALIDATE,    // 数据验证
+        OPERATION_COUNT
+    };
+    
+    // 写入分片数，线程按首次使用的顺序轮流分配；分片在首次写入时才分配
+    static const size_t SHARD_COUNT = 8;
+    
+    Metrics();
+    ~Metrics();
+    
+    // 英文标识（用于导出）与中文名称（用于报告）
+    static const char* operationName(Operation op);
+    static const char* operationLabel(Operation op);
+    
+    /**
+     * 每 every 次调用计时一次（1 表示每次都计时）
+     * 默认精确查找为 16，其余为 1
+     */
+    void setSampleInterval(Operation op, unsigned every);
+    unsigned sampleInterval(Operation op) const;
+    
+    // 本线程的这次调用是否需要计时（每线程独立计数）
+    bool shouldSample(Operation op) const;
+    
+    // 记录一次计时调用 / 一次未计时调用
+    void record(Operation op, std::uint64_t nanos, std::uint64_t items = 1,
+                std::uint64_t bytes = 0);
+    void count(Operation op, std::uint64_t items = 1, std::uint64_t bytes = 0);
+    
+    // 汇总各分片
+    OperationStats stats(Operation op) const;
+    
+    void reset();
+    
+    /**
+     * 作用域计时：构造时按采样间隔决定是否读时钟，析构时记录
+     */
+    class Timer {
+    public:
+        Timer(Metrics& metrics, Operation op, std::uint64_t items = 1);
+        ~Timer();
+        
+        // 条目数在操作结束时才知道（如导入的记录数）时在析构前设置
+        void setItems(std::uint64_t n) { items = n; }
+        // 写出的字节数同样在操作结束时设置
+        void setBytes(std::uint64_t n) { bytes = n; }
+    
+    private:
+        Timer(const Timer&);
+        Timer& operator=(const Timer&);
+        
+        Metrics& metrics;
+        Operation op;
+        std::uint64_t items;
+        std::uint64_t bytes;
+        bool sampled;
+        std::chrono::steady_clock::time_point start;
+    };
+    
+    // 把纳秒格式化为带单位的文本（ns / µs / ms / s）
+    static std::string formatNanos(double nanos);
+
+private:
+    Metrics(const Metrics&);
+    Metrics& operator=(const Metrics&);
+    
+    struct Counters {
+        std::atomic<std::uint64_t> calls;
+        std::atomic<std::uint64_t> items;
+        std::atomic<std::uint64_t> samples;
+        std::atomic<std::uint64_t> sampledItems;
+        std::atomic<std::uint64_t> bytes;
+        std::atomic<std::uint64_t> sampledBytes;
+        std::atomic<std::uint64_t> totalNanos;
+        std::atomic<std::uint64_t> maxNanos;
+        std::atomic<std::uint64_t> buckets[LatencyHistogram::BUCKET_COUNT];
+        
+        void clear();
+    };
+    
+    struct Shard {
+        Counters ops[OPERATION_COUNT];
+        
+        Shard();
+    };
+    
+    Counters& local(Operation op);
+    
+    std::atomic<Shard*> shards[SHARD_COUNT];
+    std::atomic<unsigned> intervals[OPERATION_COUNT];
+};
+
+#endif // METRICS_H
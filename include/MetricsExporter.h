@@ -0,0 +1,84 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include "Metrics.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class PlateDatabase;
+
+/**
+ * Prometheus 指标导出
+ * 把数据库状态（记录数、城市数、索引状态、快照版本）、各操作的调用计数 /
+ * 记录数 / 延迟直方图 / 吞吐、按组成部分（component 标签）划分的内存占用
+ * 以及进程常驻内存按 Prometheus 文本格式（0.0.4）输出，
+ * 可定时写入文件（供 node_exporter 的 textfile 采集器读取），
+ * 也可在后台线程上提供仅监听 127.0.0.1 的 HTTP 端点 /metrics。
+ *
+ * 采集只读取当前快照和按分片累计的计数器，不获取写锁，不会阻塞查询；
+ * 城市数与字符串堆占用按快照版本缓存，数据未变化时不重复统计。
+ * 导出器必须先于所监控的数据库销毁。
+ */
+class MetricsExporter {
+public:
+    explicit MetricsExporter(const PlateDatabase& db);
+    ~MetricsExporter();
+    
+    /**
+     * 生成一次完整的指标文本
+     */
+    std::string render();
+    
+    /**
+     * 启动文件导出：立即写一次，之后每 intervalMs 毫秒写一次
+     * 先写临时文件再改名，读取方不会看到写了一半的文件
+     * @return 首次写入是否成功（已在导出时返回 false）
+     */
+    bool startFileExport(const std::string& path, unsigned intervalMs = 15000);
+    
+    /**
+     * 启动 HTTP 端点，只绑定 127.0.0.1
+     * @param port 端口，0 表示由系统分配（用 httpPort() 查询）
+     * @return 是否成功监听（不支持套接字的平台返回 false）
+     */
+    bool startHttp(unsigned short port);
+    unsigned short httpPort() const { return boundPort; }
+    
+    /**
+     * 停止全部后台线程（析构时自动调用）
+     */
+    void stop();
+
+private:
+    MetricsExporter(const MetricsExporter&);
+    MetricsExporter& operator=(const MetricsExporter&);
+    
+    bool writeFile();
+    void fileLoop();
+    void httpLoop();
+    void serveClient(int client);
+    
+    const PlateDatabase& database;
+    
+    std::mutex renderMutex;                 // 串行化渲染（文件线程与 HTTP 线程共用缓存）
+    std::uint64_t cachedVersion;
+    long long cachedCities;
+    
+    std::mutex stopMutex;
+    std::condition_variable stopSignal;
+    std::atomic<bool> stopping;
+    
+    std::string filePath;
+    unsigned fileInterval;
+    std::thread fileThread;
+    
+    int listenFd;
+    std::atomic<unsigned short> boundPort;
+    std::thread httpThread;
+};
+
+#endif // METRICS_EXPORTER_H
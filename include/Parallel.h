@@ -0,0 +1,50 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <functional>
+#include <cstddef>
+
+/**
+ * 简单并行工具
+ * 把 [0, count) 的任务编号分给常驻工作线程执行，供分片、导入、验证等模块复用
+ */
+namespace Parallel {
+    // 默认工作线程数（硬件线程数，至少为 1）
+    inline unsigned defaultThreads() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+    
+    /**
+     * 在常驻线程池上并行执行 task(i)，i ∈ [0, count)，返回时全部任务已完成
+     * 调用线程也参与执行；各线程用原子计数器逐个领取任务编号，
+     * 先做完的线程继续领取，耗时不均的任务也能均衡分配。
+     * 最多 threads 个线程同时执行同一批任务；任务内可以再次调用（嵌套时不会死锁）。
+     * 任务抛出的第一个异常在全部任务结束后由调用线程重新抛出。
+     */
+    void run(size_t count, const std::function<void(size_t)>& task, unsigned threads);
+    
+    /**
+     * 并行执行 fn(i)，i ∈ [0, count)
+     * threads 为 0 时使用硬件线程数；只有一个任务或一个线程时直接在调用线程执行。
+     */
+    template <typename Fn>
+    void forEach(size_t count, Fn fn, unsigned threads = 0) {
+        if (threads == 0) {
+            threads = defaultThreads();
+        }
+        if (threads > count) {
+            threads = static_cast<unsigned>(count);
+        }
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                fn(i);
+            }
+            return;
+        }
+        run(count, std::function<void(size_t)>(std::ref(fn)), threads);
+    }
+}
+
+#endif // PARALLEL_H
@@ -0,0 +1,76 @@
+#ifndef PLATE_BATCH_H
+#define PLATE_BATCH_H
+
+#include "PlateKey.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 批量车牌规范化与校验
+ * 车牌按固定 16 字节槽位连续存放（不足补 0），一次处理整批：
+ *   小写字母原地转为大写，校验“辽”前缀、发牌机关字母、D/F 标识与编号字符，
+ *   并为每个车牌输出一个标志字节（合法 / 新能源 / 含小写）和 PlateCodec 编码。
+ * x86 上按 CPU 能力选用 AVX2（每次 2 个车牌）或 SSSE3（每次 1 个车牌），
+ * 用半字节查找表 + 字节重排（pshufb）完成字符分类，乘加指令完成编码，不再逐字符分支；
+ * 其他平台退回到逐字节查表的标量实现，结果完全一致。
+ */
+class PlateBatch {
+public:
+    // 每个车牌占用的槽位字节数
+    static const size_t SLOT_BYTES = 16;
+    
+    // 结果标志位
+    enum Flag {
+        FLAG_VALID = 1,         // 合法车牌（忽略大小写）
+        FLAG_NEW_ENERGY = 2,    // 新能源车牌（仅在合法时设置）
+        FLAG_LOWERCASE = 4      // 原始车牌含小写字母，已转为大写
+    };
+    
+    explicit PlateBatch(size_t capacity = 1024);
+    
+    void clear();
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    bool full() const { return count >= cap; }
+    
+    // 加入一个车牌（超过槽位长度的车牌必然非法，只记录长度；已满时自动扩容）
+    void add(const char* data, size_t len);
+    void add(const std::string& plate) { add(plate.data(), plate.size()); }
+    
+    // 规范化并校验已加入的全部车牌
+    void classify();
+    
+    std::uint8_t flags(size_t i) const { return results[i]; }
+    bool isValid(size_t i) const { return (results[i] & FLAG_VALID) != 0; }
+    bool isNewEnergy(size_t i) const { return (results[i] & FLAG_NEW_ENERGY) != 0; }
+    bool hasLowercase(size_t i) const { return (results[i] & FLAG_LOWERCASE) != 0; }
+    
+    // 规范化（大写）后的车牌，classify 之前为原始内容
+    const char* plate(size_t i) const { return &slots[i * SLOT_BYTES]; }
+    size_t length(size_t i) const { return lengths[i]; }
+    
+    // 车牌编码（与 PlateCodec::encode 一致，非法车牌为 INVALID_KEY）
+    PlateKey key(size_t i) const { return keys[i]; }
+    
+    /**
+     * 底层批处理核：slots 为 count 个连续槽位，lengths[i] 为车牌字节数
+     * （大于 SLOT_BYTES 的长度视为非法），结果写入 flags[i] 与 keys[i]
+     */
+    static void classify(char* slots, const std::uint8_t* lengths,
+                         size_t count, std::uint8_t* flags, PlateKey* keys);
+    
+    // 当前使用的实现："avx2"、"ssse3" 或 "scalar"
+    static const char* implementation();
+
+private:
+    size_t cap;
+    size_t count;
+    std::vector<char> slots;
+    std::vector<std::uint8_t> lengths;
+    std::vector<std::uint8_t> results;
+    std::vector<PlateKey> keys;
+};
+
+#endif // PLATE_BATCH_H
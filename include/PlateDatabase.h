@@ -4,27 +4,266 @@
 #include "PlateRecord.h"
 #include "RadixSort.h"
 #include "SearchAlgorithms.h"
+#include "FileIO.h"
+#include "ColumnarSnapshot.h"
+#include "WriteAheadLog.h"
+#include "DeltaFile.h"
+#include "DataGenerator.h"
+#include "DataValidator.h"
+#include "EliasFanoPlateSet.h"
+#include "PlateOccupancy.h"
+#include "Metrics.h"
+#include "MemoryTracker.h"
+#include "RecordTable.h"
+#include "PlateKeyIndex.h"
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <random>
 
 /**
- * 车牌数据库核心类
- * 管理车牌记录的增删改查、排序、统计等功能
+ * 数据库快照
+ * 记录与索引的一个只读版本。快照一经发布便不再修改，
+ * 读者持有引用计数指针即可在不加锁的情况下安全访问。
+ * 记录按块写时复制，相邻版本共享未改动的块。
+ * 从二进制快照文件打开时，记录保存在 mapped 的映射列中，records 为空。
+ * 未按车牌排序的内存快照随附车牌读索引 keyIndex，精确与前缀查找不必逐条比较。
  */
-class PlateDatabase {
-private:
-    std::vector<PlateRecord> records;      // 顺序表存储
+struct PlateSnapshot {
+    RecordTable records;                   // 顺序表存储（分块共享）
     std::vector<CityBlock> cityIndex;      // 城市分块索引
     bool sortedByPlate;                    // 是否按车牌排序
     bool cityIndexBuilt;                   // 城市索引是否已建立
+    unsigned long long version;            // 版本号，每次发布加一
+    std::shared_ptr<const ColumnarSnapshot> mapped; // 映射的列式快照（可为空）
+    std::shared_ptr<const PlateKeyIndex> keyIndex;  // 车牌读索引（已排序或映射快照为空，发布时维护）
+    
+    PlateSnapshot() : sortedByPlate(false), cityIndexBuilt(false), version(0) {}
+    
+    // 记录数
+    size_t size() const { return mapped ? mapped->size() : records.size(); }
+    
+    // 按段依次访问全部记录：fn(首行指针, 行数, 首行下标)
+    // 内存快照逐块访问不拼接；映射快照解码后作为一整段
+    template <typename Fn>
+    void forEachRun(Fn fn) const {
+        if (mapped) {
+            const std::vector<PlateRecord>& all = mapped->records();
+            if (!all.empty()) fn(all.data(), all.size(), static_cast<size_t>(0));
+        } else {
+            records.forEachRun(fn);
+        }
+    }
+    
+    // 第 i 行记录副本（不触发解码）
+    PlateRecord recordAt(size_t i) const {
+        return mapped ? mapped->recordAt(i) : records[i];
+    }
+};
+
+typedef std::shared_ptr<const PlateSnapshot> SnapshotPtr;
+
+/**
+ * 保存格式
+ */
+enum SaveFormat {
+    SAVE_TEXT,          // 空格分隔的文本文件
+    SAVE_CSV,           // CSV 文件
+    SAVE_SNAPSHOT       // 二进制列式快照
+};
+
+/**
+ * 内存占用明细（字节）
+ * 顺序表与索引按容量计；字符串只计超出短字符串缓冲、单独分配在堆上的部分
+ * （不含分配器自身的管理开销）。临时缓冲为全进程计数，见 MemoryTracker。
+ */
+struct MemoryUsage {
+    size_t recordCount;             // 记录数
+    size_t records;                 // 顺序表（记录本体，含内嵌的短字符串缓冲）
+    size_t stringHeap;              // 记录中字符串的堆分配
+    size_t cityIndex;               // 城市分块索引（含城市名）
+    size_t occupancy;               // 号段占用位图
+    size_t plateIndex;              // 写者车牌索引
+    size_t keyIndex;                // 随快照发布的车牌读索引
+    size_t changeTracking;          // 增量保存跟踪的变化表
+    size_t walBuffer;               // 预写日志尚未落盘的追加缓冲
+    size_t mappedFile;              // 映射的列式快照文件（按需调页，不计入合计）
+    size_t transientCurrent[MemoryTracker::CATEGORY_COUNT];     // 临时缓冲当前占用
+    size_t transientPeak[MemoryTracker::CATEGORY_COUNT];        // 临时缓冲峰值
+    size_t transientPeakTotal;      // 各类临时缓冲同时占用之和的峰值（观测值）
+    
+    MemoryUsage();
+    
+    // 常驻合计：记录、字符串、索引、位图、两种车牌索引、变化表与日志缓冲
+    size_t total() const;
     
-    // 性能统计
-    mutable int totalOperations;
-    mutable int totalSearches;
+    /**
+     * 观测峰值：常驻合计加上临时缓冲（含整表改写时新旧两份记录并存的副本）
+     * 实际同时占用的最高水位
+     */
+    size_t observedPeak() const;
+    
+    // 每条记录平均字节数
+    double bytesPerRecord() const {
+        return recordCount ? static_cast<double>(total()) / recordCount : 0.0;
+    }
+    
+    // 生成文字版报告
+    std::string toString() const;
+};
+
+/**
+ * 车牌数据库核心类
+ * 管理车牌记录的增删改查、排序、统计等功能
+ *
+ * 并发模型（RCU 风格）：
+ *   - 读操作获取当前快照后在其上完成查询，可任意多线程并发；
+ *   - 写操作由 writeMutex 串行化，复制当前快照、修改副本后原子发布；
+ *   - 旧快照在最后一个读者释放后自动回收。
+ *
+ * 持久化：openDurable 之后每次修改先追加一条预写日志再发布快照，
+ * 释放写锁后等待日志落盘（组提交）再返回；checkpoint 在写锁外写出快照，
+ * 再短暂取得写锁截去快照已包含的日志，写出期间追加的日志保留。
+ * 日志刷盘失败后数据库转为只读，之后的修改与检查点都被拒绝。
+ */
+class PlateDatabase {
+private:
+    mutable SnapshotPtr current;           // 当前快照，仅通过 std::atomic_load/atomic_store 访问
+    mutable std::mutex writeMutex;         // 写者互斥锁
+    
+    // 性能统计：各操作的调用次数与延迟直方图由 metrics 按线程分片累计
+    mutable std::atomic<long long> totalOperations;
+    mutable Metrics metrics;
+    
+    std::atomic<bool> verbose;             // 是否输出操作提示到控制台
+    
+    // 预写日志（未启用时为空）：写者持有 writeMutex 时使用与替换，替换通过 std::atomic_store，
+    // 统计等只读访问通过 std::atomic_load 取得，不占写锁
+    std::shared_ptr<WriteAheadLog> wal;
+    std::atomic<bool> durable;             // 是否已启用预写日志（无锁读取）
+    std::string durableSnapshotPath;       // 检查点快照路径
+    std::mutex checkpointMutex;            // 串行化检查点与重新打开日志（先于 writeMutex 获取）
+    
+    // 后台保存：线程持有发起时的快照，与后续读写互不影响
+    std::mutex saveMutex;                  // 保护 saveThread
+    std::thread saveThread;
+    std::atomic<bool> saving;
+    std::atomic<bool> lastSaveOk;
+    
+    // 附属状态锁：保护下面的变化跟踪、占用位图与写者车牌索引。
+    // 写者修改这些成员时在 writeMutex 之内再短暂持有它，只读访问（内存统计、占用查询等）
+    // 只取这把锁，不必等待长时间持有写锁的导入、排序或日志落盘
+    mutable std::mutex stateMutex;
+    
+    // 增量保存：自上次保存以来变化的记录（车牌 → 最新变化），修改须同时持有 writeMutex 与 stateMutex
+    std::unordered_map<std::string, DeltaChange> changes;
+    bool changesCleared;                   // 期间执行过清空
+    bool changesOverflow;                  // 变化过多或上次完整写入失败，下次改写完整基准
+    std::uint64_t clearEpoch;              // 清空次数，增量写出后据此判断期间是否又清空过
+    std::string deltaBase;                 // 基准快照路径（为空表示未跟踪变化）
+    std::uint64_t deltaBaseId;             // 基准快照标识
+    std::uint64_t deltaSeq;                // 已写出的增量文件序号
+    std::mutex deltaMutex;                 // 串行化增量保存与合并
+    
+    // 号段占用位图（任何访问都须持有 stateMutex，只读查询也可能建立它）：
+    // 首次使用时由当前数据建立，之后随修改增量维护；数据被整体替换时作废，下次使用时重建
+    mutable PlateOccupancy occupancy;
+    mutable bool occupancyBuilt;
+    
+    // 写者车牌索引（修改须同时持有 writeMutex 与 stateMutex）：车牌编码 → 当前快照中的行号，
+    // 增删改据此 O(1) 定位记录。首次写入时建立，行序整体改变（排序、建城市索引、打开文件）时作废；
+    // 导入的数据可能含重复车牌，因此允许一个编码对应多行
+    mutable std::unordered_multimap<PlateKey, size_t> plateIndex;
+    mutable bool plateIndexBuilt;
+    
+    // 字符串堆占用需要扫描全部记录，按快照版本缓存
+    mutable std::mutex memoryMutex;
+    mutable unsigned long long memoryVersion;
+    mutable bool memoryDecoded;            // 缓存时映射快照是否已解码
+    mutable size_t memoryStringHeap;       // 缓存的字符串堆字节数（SIZE_MAX 表示无效）
+    
+    std::mt19937 randomEngine;             // generateRandomData 的种子来源（每个实例一个，受 writeMutex 保护）
+    
+    // 发布新快照（调用者须持有 writeMutex）；
+    // 未排序的内存快照沿用写者增量维护的读索引，没有或覆盖层过大时由记录重建
+    void publish(const std::shared_ptr<PlateSnapshot>& next) const;
+    
+    // 确保存在已按车牌排序的快照，返回该快照
+    SnapshotPtr ensureSorted() const;
+    
+    // 确保存在已建立城市索引的快照，返回该快照
+    SnapshotPtr ensureCityIndex() const;
+    
+    // 在指定快照上查找并记录统计（plate 须已转为大写，内存与映射快照结果一致）
+    SearchResult lookupIn(const PlateSnapshot& snap, const std::string& plate) const;
+    
+    // 等待日志序号 lsn 落盘（log 为空时直接成功）
+    bool waitDurable(const std::shared_ptr<WriteAheadLog>& log, std::uint64_t lsn) const;
+    
+    // 写出检查点快照并截去其已包含的日志，written 非空时给出快照路径（调用者不得持有 writeMutex）
+    bool writeCheckpoint(std::string* written = nullptr);
+    
+    // 记录变化（调用者须持有 writeMutex 与 stateMutex；未跟踪时不做任何事）
+    void trackUpsert(const PlateRecord& rec);
+    void trackRemove(const std::string& plate);
+    void trackBatch(std::vector<PlateRecord>::const_iterator first,
+                    std::vector<PlateRecord>::const_iterator last);
+    void trackClear();
+    
+    // 确保占用位图与当前数据一致（调用者须持有 stateMutex）
+    void ensureOccupancy() const;
+    
+    // 写者车牌索引的建立、作废与增量维护（调用者须持有 writeMutex 与 stateMutex）
+    void ensurePlateIndex() const;
+    void invalidatePlateIndex() const;
+    void unindexRow(PlateKey key, size_t row);
+    void moveIndexedRow(PlateKey key, size_t from, size_t to);
+    
+    // 写者按车牌定位当前快照 base 中的行，未找到返回 -1（调用者须持有 writeMutex）
+    int locateForWrite(const PlateSnapshot& base, const std::string& plate);
+    
+    // 以指定基准重新开始跟踪（调用者须持有 writeMutex 与 stateMutex）
+    void resetTracking(const std::string& base, std::uint64_t baseId, std::uint64_t seq);
+    
+    // 把 added 追加到 next 末尾后发布，记录变化与日志后释放 lock 并等待落盘（added 被移空）；
+    // 日志拒绝追加时不发布、added 原样保留，调用者可据此撤销为它预留的资源
+    bool publishAppended(const std::shared_ptr<PlateSnapshot>& next,
+                         std::vector<PlateRecord>& added,
+                         std::unique_lock<std::mutex>& lock);
+    
+    // 由 fill 生成记录后追加发布（generateData 的公共实现）
+    bool generateWith(const std::function<bool(std::vector<PlateRecord>&)>& fill,
+                      std::uint64_t seed);
+    
+    // 增量保存的公共实现，forceFull 为 true 时改写完整基准
+    bool saveIncremental(const std::string& baseFile, bool forceFull);
+    
+    // 把指定快照按格式写入文件
+    bool writeTo(const PlateSnapshot& snap, const std::string& filename,
+                 SaveFormat format, const ProgressFn& progress) const;
     
 public:
     PlateDatabase();
+    ~PlateDatabase();
+    
+    PlateDatabase(const PlateDatabase&) = delete;
+    PlateDatabase& operator=(const PlateDatabase&) = delete;
+    
+    /**
+     * 获取当前快照
+     * 在同一快照上执行的多次读取彼此一致，不受并发写入影响
+     */
+    SnapshotPtr snapshot() const;
+    
+    /**
+     * 设置是否在控制台输出操作提示（默认输出；作为分片等内部组件时关闭）
+     */
+    void setVerbose(bool on) { verbose = on; }
     
     // ========== 基本操作：增删改查 ==========
     
@@ -46,12 +285,24 @@ public:
     bool deleteRecord(const std::string& plate);
     
     /**
-     * 查找记录（自动选择最优算法）
+     * 查找记录（自动选择最优算法，车牌不区分大小写）
+     * 返回的下标对应调用时的当前快照
      */
     int findRecord(const std::string& plate) const;
     
     /**
-     * 折半查找车牌
+     * 查找记录并返回本次查找的统计信息
+     */
+    SearchResult lookup(const std::string& plate) const;
+    
+    /**
+     * 查找记录并在同一快照上取出记录副本
+     * @return 是否找到
+     */
+    bool getRecord(const std::string& plate, PlateRecord* out) const;
+    
+    /**
+     * 折半查找车牌（未排序时先发布排序后的快照）
      */
     int binarySearchPlate(const std::string& plate) const;
     
@@ -59,32 +310,60 @@ public:
     
     /**
      * 从文件导入
+     * @param report 导入报告（可为空），包含跳过的非法记录明细
+     * @param threads 解析线程数，1 为单线程，0 表示使用硬件线程数
+     */
+    bool loadFromFile(const std::string& filename, LoadReport* report = nullptr,
+                      unsigned threads = 1);
+    
+    /**
+     * 流式导入文件
+     * 文件按批切分校验，每批写入日志后立即发布，导入过程不保留整份中间副本，
+     * 写锁只在发布每一批时持有。progress 在每批之后调用（调用线程中），返回 false 取消导入，
+     * 取消或失败时已发布的批次保留
      */
-    bool loadFromFile(const std::string& filename);
+    bool importFile(const std::string& filename,
+                    const ImportProgressFn& progress = ImportProgressFn(),
+                    LoadReport* report = nullptr);
     
     /**
-     * 随机生成数据
+     * 随机生成数据：以本实例随机数引擎取得的种子调用 generateData
      */
     void generateRandomData(int count);
     
+    /**
+     * 按种子生成可复现的合成数据，多线程生成后追加发布
+     * 生成的车牌互不重复；与库中已有记录相同的车牌在发布前改取同一号段中其后的空闲编号，
+     * 因此在空库上结果只由种子决定
+     * @param threads 线程数，0 表示使用硬件线程数
+     */
+    bool generateData(size_t count, std::uint64_t seed, unsigned threads = 0);
+    
+    /**
+     * 按分布参数生成可复现的偏斜数据（城市 Zipf、新能源占比、热点号段、一人多车）
+     */
+    bool generateData(size_t count, std::uint64_t seed, const WorkloadSpec& spec,
+                      unsigned threads = 0);
+    
     // ========== 排序操作 ==========
     
     /**
      * 使用链式基数排序对车牌排序
      */
-    void radixSortByPlate();
+    SortResult radixSortByPlate();
     
     /**
      * 检查是否已排序
      */
-    bool isSorted() const { return sortedByPlate; }
+    bool isSorted() const { return snapshot()->sortedByPlate; }
     
     // ========== 查找操作 ==========
     
     /**
      * 按城市分块索引查找
+     * 内存数据的索引未建立或已随修改失效时直接扫描当前快照，不在查询中重建索引
      */
-    std::vector<PlateRecord> searchByCity(const std::string& city);
+    std::vector<PlateRecord> searchByCity(const std::string& city) const;
     
     /**
      * 建立城市分块索引
@@ -116,15 +395,19 @@ public:
     /**
      * 获取记录总数
      */
-    size_t getRecordCount() const { return records.size(); }
+    size_t getRecordCount() const { return snapshot()->size(); }
     
     /**
      * 获取所有记录（用于GUI显示）
      */
-    std::vector<PlateRecord> getAllRecords() const { return records; }
+    std::vector<PlateRecord> getAllRecords() const {
+        SnapshotPtr snap = snapshot();
+        return snap->mapped ? snap->mapped->records() : snap->records.toVector();
+    }
     
     /**
      * 获取城市数量
+     * 映射快照取城市字典条目数、已建城市索引时取块数，都不扫描记录
      */
     int getCityCount() const;
     
@@ -140,6 +423,104 @@ public:
      */
     bool exportToCSV(const std::string& filename) const;
     
+    /**
+     * 保存为二进制列式快照（含排序状态与城市索引）
+     */
+    bool saveSnapshot(const std::string& filename) const;
+    
+    /**
+     * 车牌是否已被占用（已录入或已分配），O(1)
+     */
+    bool isPlateOccupied(const std::string& plate) const;
+    
+    /**
+     * 为城市分配未使用的车牌
+     * 按编号顺序取至多 count 个空闲车牌并标记占用，之后的分配不会再给出；
+     * 分配只是预留，录入仍需调用 addRecord。数据被整体替换后预留失效。
+     * @param kind 燃油 / 纯电 D / 插混 F
+     * @param pattern 5 位靓号模式，'?' 匹配任意字符（如 "8?8?8"），为空表示不限
+     */
+    std::vector<std::string> allocatePlates(const std::string& city, size_t count,
+                                            PlateOccupancy::Kind kind = PlateOccupancy::KIND_FUEL,
+                                            const std::string& pattern = std::string());
+    
+    /**
+     * 构建当前数据的压缩车牌集合（Elias–Fano 编码）
+     * 供只读归档使用：车牌列内存约为原来的 1/5，仍支持查找、前缀区间与顺序遍历。
+     * 数据已按车牌排序且车牌均合法时，集合下标即记录行号
+     */
+    std::shared_ptr<const EliasFanoPlateSet> buildPlateSet() const;
+    
+    /**
+     * 打开二进制列式快照，替换当前数据
+     * 文件被映射后立即可查询，记录在首次写入或全表访问时才解码。
+     * 存在 filename.N.delta 增量文件时按序号依次叠加，并以该快照为基准继续跟踪变化
+     */
+    bool openSnapshot(const std::string& filename);
+    
+    /**
+     * 增量保存
+     * 只把自上次保存以来插入、修改、删除的记录写入 baseFile.N.delta；
+     * 基准快照不存在、已被其他保存覆盖或变化过多时改写完整基准快照
+     */
+    bool saveDelta(const std::string& baseFile);
+    
+    /**
+     * 合并增量：把当前数据写成新的基准快照并删除全部增量文件
+     */
+    bool compactDeltas(const std::string& baseFile);
+    
+    /**
+     * 当前跟踪的基准快照路径（未跟踪时为空）
+     */
+    std::string deltaBasePath() const;
+    
+    /**
+     * 自上次保存以来变化的记录数
+     */
+    size_t pendingChangeCount() const;
+    
+    /**
+     * 后台保存
+     * 立即取得当前快照并在后台线程写出，调用线程与其他读写者不受阻塞；
+     * 保存的是调用时刻的数据，之后的修改不影响本次保存。
+     * progress 与 done 在后台线程中调用；progress 返回 false 可取消保存。
+     * @return 已有保存任务在进行时返回 false
+     */
+    bool saveInBackground(const std::string& filename, SaveFormat format,
+                          const ProgressFn& progress = ProgressFn(),
+                          const std::function<void(bool)>& done = std::function<void(bool)>());
+    
+    /**
+     * 是否有后台保存在进行
+     */
+    bool isSaving() const { return saving; }
+    
+    /**
+     * 等待后台保存结束，返回其结果（没有后台保存时返回上一次的结果）
+     */
+    bool waitForSave();
+    
+    // ========== 持久化 ==========
+    
+    /**
+     * 以持久化模式打开数据库
+     * 先打开检查点快照（不存在则从空库开始），再回放日志中快照之后的修改，
+     * 日志尾部因崩溃而残缺的记录被丢弃。此后的修改都会先写入日志。
+     */
+    bool openDurable(const std::string& snapshotPath, const std::string& walPath);
+    
+    /**
+     * 检查点：把当前数据写入快照并截去快照已包含的日志
+     * 快照与日志位置在写锁内同时取得，写出不占写锁，期间的修改照常进行并留在日志中
+     */
+    bool checkpoint();
+    
+    /**
+     * 是否已启用预写日志（读取无锁标志，不等待写锁）
+     */
+    bool isDurable() const;
+    
     // ========== 系统维护 ==========
     
     /**
@@ -157,6 +538,18 @@ public:
      */
     void showPerformanceStats() const;
     
+    /**
+     * 操作指标（查找、排序、导入、保存、验证的次数与延迟分布）
+     * 可调整采样间隔；汇总读取不阻塞查询
+     */
+    Metrics& operationMetrics() const { return metrics; }
+    
+    /**
+     * 内存占用明细：记录、字符串堆、各索引与临时缓冲（含峰值）
+     * 字符串堆按快照版本缓存，数据未变化时不重复扫描
+     */
+    MemoryUsage memoryUsage() const;
+    
     // ========== 高级功能 ==========
     
     /**
@@ -164,11 +557,23 @@ public:
      */
     bool batchImport(const std::vector<PlateRecord>& newRecords);
     
+    /**
+     * 批量导入（移入记录，避免再次复制字符串）
+     * @param imported 非空时写入本次发布的记录数（在写锁内确定，不受并发写者影响）
+     */
+    bool batchImport(std::vector<PlateRecord>&& newRecords, size_t* imported = nullptr);
+    
     /**
      * 按城市统计并排序
      */
     std::vector<std::pair<std::string, int>> getCityStatistics() const;
     
+    /**
+     * 验证数据完整性：单遍多线程完成车牌校验、重复检测与城市匹配
+     * @param threads 线程数，0 表示使用硬件线程数
+     */
+    ValidationReport validate(unsigned threads = 0) const;
+    
     /**
      * 验证数据完整性（返回验证结果字符串）
      */
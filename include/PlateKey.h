@@ -0,0 +1,58 @@
+#ifndef PLATE_KEY_H
+#define PLATE_KEY_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 车牌整数编码
+ * 将“辽”之后的 6 位（燃油）或 7 位（新能源）字符按 37 进制编码为一个整数：
+ *   每位字符取 Utils::charToBucketIndex + 1（1-36），不足 7 位的末位补 0。
+ * 编码保持与车牌字符串字典序一致，可直接用于排序、折半查找和紧凑存储。
+ * 0 不对应任何合法车牌，用作非法值。
+ */
+typedef std::uint64_t PlateKey;
+
+namespace PlateCodec {
+    // 非法车牌的编码值
+    const PlateKey INVALID_KEY = 0;
+    
+    // 车牌最大字节数（新能源：“辽”3 字节 + 7 位）
+    const size_t MAX_PLATE_BYTES = 10;
+    
+    // 编码上界（37^7），所有合法编码均小于该值
+    const PlateKey KEY_LIMIT = 94931877133ULL;
+    
+    /**
+     * 校验并编码车牌（字母不区分大小写，不产生临时字符串）
+     * @return 合法时返回编码，非法返回 INVALID_KEY
+     */
+    PlateKey encode(const char* data, size_t len);
+    PlateKey encode(const std::string& plate);
+    
+    /**
+     * 解码到调用者提供的缓冲区（至少 MAX_PLATE_BYTES 字节）
+     * @return 写入的字节数
+     */
+    size_t decode(PlateKey key, char* out);
+    std::string decode(PlateKey key);
+    
+    // 是否为新能源车牌
+    bool isNewEnergy(PlateKey key);
+    
+    // 发牌机关代码字母
+    char letterOf(PlateKey key);
+    
+    // 车辆类别："油车" 或 "电车"
+    const char* categoryOf(PlateKey key);
+    
+    /**
+     * 把车牌前缀换算为编码区间 [lo, hi)，以该前缀开头的合法车牌编码都落在区间内
+     * （字母不区分大小写；空前缀或只有部分“辽”字节时为全部区间）
+     * @return 前缀不可能匹配任何车牌时返回 false
+     */
+    bool prefixRange(const std::string& prefix, PlateKey& lo, PlateKey& hi);
+}
+
+#endif // PLATE_KEY_H
@@ -0,0 +1,98 @@
+#ifndef PLATE_KEY_INDEX_H
+#define PLATE_KEY_INDEX_H
+
+#include "PlateKey.h"
+#include "RecordTable.h"
+#include "SearchAlgorithms.h"
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 随快照发布的车牌读索引：车牌编码 → 行号
+ *
+ * 由两层有序数组组成：按 (编码, 行号) 排序的基底，以及记录此后变化的覆盖层。
+ * 覆盖层中出现的编码以覆盖层为准（行号为 NO_ROW 表示该车牌已无记录），
+ * 其余编码查基底。写者每次修改只复制覆盖层，基底在各版本之间共享；
+ * 覆盖层超过上限时由记录整体重建。索引一经发布便不再修改，读者可并发访问。
+ *
+ * 无法编码的车牌（来自未经校验的导入数据）不进索引，只计数；
+ * 有这类记录时，索引未命中的查找须由调用者退回逐条比较。
+ */
+class PlateKeyIndex {
+public:
+    typedef std::uint32_t Row;
+    
+    // 覆盖层中表示“该编码已无记录”的行号
+    static const Row NO_ROW = 0xFFFFFFFFu;
+    
+    struct Entry {
+        PlateKey key;
+        Row row;
+    };
+    
+    /**
+     * 在已有索引之上累积修改，commit 生成新索引（原索引不变）
+     * 行号是修改完成后记录表中的行号
+     */
+    class Editor {
+    public:
+        explicit Editor(const PlateKeyIndex& from);
+        
+        void insert(PlateKey key, Row row);
+        void erase(PlateKey key, Row row);
+        
+        // 同一车牌的记录从 from 行移到 to 行
+        void move(PlateKey key, Row from, Row to);
+        
+        std::shared_ptr<const PlateKeyIndex> commit() const;
+    
+    private:
+        std::vector<Row>& rowsFor(PlateKey key);
+        
+        const PlateKeyIndex& source;
+        std::unordered_map<PlateKey, std::vector<Row>> touched;
+        long long unindexedDelta;
+    };
+    
+    PlateKeyIndex();
+    
+    /**
+     * 由记录整体建立（只有基底，覆盖层为空）
+     */
+    static std::shared_ptr<const PlateKeyIndex> build(const RecordTable& records);
+    
+    /**
+     * 精确查找，返回任一匹配行；比较次数为两层折半查找的步数之和
+     */
+    SearchResult find(PlateKey key) const;
+    
+    /**
+     * 编码区间 [lo, hi) 内全部记录的行号，按编码顺序追加到 out
+     */
+    void rowsInRange(PlateKey lo, PlateKey hi, std::vector<Row>& out) const;
+    
+    // 某编码的全部行号追加到 out
+    void rowsOf(PlateKey key, std::vector<Row>& out) const;
+    
+    // 无法编码、未进索引的记录数
+    size_t unindexedRows() const { return unindexed; }
+    
+    // 覆盖层已超过上限，应由记录整体重建
+    bool needsRebuild() const;
+    
+    // 再改动 n 个车牌后覆盖层仍不超过上限（大批量追加时据此直接重建）
+    bool canAbsorb(size_t n) const;
+    
+    // 基底与覆盖层按容量计的字节数（基底与其他版本共享的部分也计入）
+    size_t memoryBytes() const;
+
+private:
+    std::shared_ptr<const std::vector<Entry>> base;
+    std::vector<Entry> overlay;
+    size_t unindexed;
+};
+
+#endif // PLATE_KEY_INDEX_H
@@ -0,0 +1,127 @@
+#ifndef PLATE_OCCUPANCY_H
+#define PLATE_OCCUPANCY_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * 车牌号段占用位图
+ *
+ * 同一发牌机关字母、同一类型（燃油 / 纯电 D / 插混 F）的 5 位编号
+ * 共 34^5（约 4543 万）个，每个编号占 1 位，整段约 5.4 MB。
+ * 号段按 64K 位分页，页在首次占用时才分配，并记录每页的占用数，
+ * 查询占用为 O(1)，寻找空闲编号时逐字取反、用 ctz 定位，整页占满时直接跳过。
+ *
+ * 编号按字符 ASCII 顺序（0-9、A-H、J-N、P-Z）转为 34 进制整数，
+ * 因此编号顺序与车牌字典序一致。本类不加锁，由调用者负责同步。
+ */
+class PlateOccupancy {
+public:
+    /**
+     * 车牌类型
+     */
+    enum Kind {
+        KIND_FUEL = 0,          // 燃油车
+        KIND_ELECTRIC = 1,      // 新能源纯电（D）
+        KIND_HYBRID = 2         // 新能源插混（F）
+    };
+    
+    // 每个号段的编号数（34^5）
+    static const std::uint32_t SERIAL_COUNT = 45435424;
+    
+    // 编号位数
+    static const size_t SERIAL_LENGTH = 5;
+    
+    PlateOccupancy();
+    
+    /**
+     * 车牌是否已被占用（非法车牌返回 false）
+     */
+    bool test(const std::string& plate) const;
+    
+    /**
+     * 标记占用
+     * @return 原先空闲时返回 true；已占用或车牌非法返回 false
+     */
+    bool set(const std::string& plate);
+    
+    /**
+     * 释放占用
+     * @return 原先占用时返回 true
+     */
+    bool reset(const std::string& plate);
+    
+    /**
+     * 释放全部号段
+     */
+    void clear();
+    
+    /**
+     * 已占用的车牌数
+     */
+    size_t count() const { return occupied; }
+    
+    /**
+     * 已分配页占用的内存字节数
+     */
+    size_t memoryBytes() const;
+    
+    /**
+     * 从编号 start 开始向后（到末尾后回绕）寻找第一个空闲编号并占用
+     * @return 分配到的车牌；号段已满或参数非法时返回空字符串
+     */
+    std::string allocateFrom(char letter, Kind kind, std::uint32_t start);
+    
+    /**
+     * 按编号顺序分配至多 n 个匹配靓号模式的空闲车牌并占用
+     * @param pattern 5 位编号模式，'?' 匹配任意字符，其余字符须完全相同（不区分大小写）；
+     *                为空表示不限
+     * @return 分配到的车牌（可能少于 n 个；模式非法时为空）
+     */
+    std::vector<std::string> allocate(char letter, Kind kind, size_t n,
+                                      const std::string& pattern = std::string());
+    
+    /**
+     * 由字母、类型与编号组成车牌
+     */
+    static std::string makePlate(char letter, Kind kind, std::uint32_t serial);
+    
+    /**
+     * 同上，写入调用者提供的缓冲区（至少 10 字节），返回写入的字节数
+     */
+    static size_t formatPlate(char letter, Kind kind, std::uint32_t serial, char* out);
+    
+    /**
+     * 拆分车牌（字母不区分大小写）
+     * @return 车牌非法时返回 false
+     */
+    static bool parse(const std::string& plate, char& letter, Kind& kind, std::uint32_t& serial);
+
+private:
+    // 每页位数与字数
+    static const std::uint32_t PAGE_BITS = 1u << 16;
+    static const std::uint32_t PAGE_WORDS = PAGE_BITS / 64;
+    
+    /**
+     * 一个号段：未分配的页视为全部空闲
+     */
+    struct Space {
+        std::vector<std::vector<std::uint64_t>> pages;
+        std::vector<std::uint32_t> pageCounts;      // 每页占用数
+    };
+    
+    // 26 个字母 × 3 种类型，按需创建
+    std::vector<Space> spaces;
+    size_t occupied;
+    
+    Space* spaceFor(char letter, Kind kind, bool create);
+    const Space* spaceFor(char letter, Kind kind) const;
+    
+    // 在编号区间 [first, last) 中按顺序占用至多 n 个空闲编号，追加到 out
+    void takeFree(Space& space, std::uint32_t first, std::uint32_t last, size_t n,
+                  std::vector<std::uint32_t>& out);
+};
+
+#endif // PLATE_OCCUPANCY_H
@@ -1,9 +1,24 @@
 #ifndef RADIX_SORT_H
 #define RADIX_SORT_H
 
+#include "MemoryTracker.h"
 #include "PlateRecord.h"
 #include <vector>
 
+/**
+ * 单次排序结果
+ */
+struct SortResult {
+    bool success;       // 排序是否成功
+    int count;          // 排序记录数
+    double timeMs;      // 耗时（毫秒）
+    
+    SortResult() : success(false), count(0), timeMs(0.0) {}
+};
+
+// 静态链表（计入 MemoryTracker 的排序缓冲）
+typedef std::vector<RadixNode, TrackingAllocator<RadixNode, MemoryTracker::SORT> > RadixNodeList;
+
 /**
  * 链式基数排序模块
  * 使用静态链表实现车牌号的基数排序
@@ -13,28 +28,19 @@ public:
     /**
      * 对车牌记录进行链式基数排序
      * @param records 要排序的记录向量（会被修改）
-     * @return 排序是否成功
+     * @return 排序结果（是否成功、记录数、耗时）
      */
-    static bool sort(std::vector<PlateRecord>& records);
-    
-    /**
-     * 获取排序统计信息
-     */
-    static int getLastSortCount() { return lastSortCount; }
-    static double getLastSortTime() { return lastSortTime; }
+    static SortResult sort(std::vector<PlateRecord>& records);
 
 private:
-    static int lastSortCount;
-    static double lastSortTime;
-    
     // 分配阶段：将链表节点分配到各个桶中
-    static void distribute(const std::vector<RadixNode>& nodes, 
+    static void distribute(const RadixNodeList& nodes, 
                           int head, int pos,
                           std::vector<int>& bucketHead, 
                           std::vector<int>& bucketTail);
     
     // 收集阶段：将各个桶的节点重新串联
-    static int collect(std::vector<RadixNode>& nodes,
+    static int collect(RadixNodeList& nodes,
                       const std::vector<int>& bucketHead,
                       const std::vector<int>& bucketTail);
 };
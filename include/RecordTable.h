@@ -0,0 +1,102 @@
+#ifndef RECORD_TABLE_H
+#define RECORD_TABLE_H
+
+#include "PlateRecord.h"
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/**
+ * 分块写时复制的记录表
+ *
+ * 记录按 CHUNK_SIZE 行分块，块通过引用计数指针在快照之间共享。
+ * 复制记录表只复制块指针目录；修改某行时只复制该行所在的块，
+ * 其余块仍与旧快照共享，单条增删改的代价与总记录数无关。
+ *
+ * 整表赋值（加载、排序、建索引后）的记录作为一整段只读基底保存，
+ * 尚未改动的块直接引用基底，不拆分、不复制。
+ * 写操作只在尚未发布的副本上进行，由调用者保证同步；发布后的记录表只读，可并发访问。
+ */
+class RecordTable {
+public:
+    // 每块行数
+    static const size_t CHUNK_SHIFT = 12;
+    static const size_t CHUNK_SIZE = static_cast<size_t>(1) << CHUNK_SHIFT;
+    
+    RecordTable();
+    RecordTable(const RecordTable& other);
+    RecordTable& operator=(const RecordTable& other);
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    
+    // 第 i 行（O(1)）
+    const PlateRecord& operator[](size_t i) const {
+        const Chunk* chunk = chunks[i >> CHUNK_SHIFT].get();
+        return chunk ? (*chunk)[i & (CHUNK_SIZE - 1)] : (*base)[i];
+    }
+    
+    // 可修改的第 i 行：所在块与其他记录表共享时先复制该块
+    PlateRecord& mutableAt(size_t i);
+    
+    // 在末尾追加
+    void push_back(const PlateRecord& rec);
+    void append(std::vector<PlateRecord>&& rows);
+    
+    /**
+     * 删除第 i 行：把最后一行移到 i 处，只改动两个块
+     * 行的先后顺序会改变，调用者须同时清除排序与城市索引标记
+     */
+    void swapRemove(size_t i);
+    
+    // 整表替换为 rows（作为只读基底，不拆分）
+    void assign(std::vector<PlateRecord>&& rows);
+    
+    // 整表引用共享的只读记录（不复制，如映射快照解码出的记录）
+    void share(const std::shared_ptr<const std::vector<PlateRecord>>& rows);
+    
+    void clear();
+    
+    // 复制出全部记录（排序、建索引等整表操作使用）；只读遍历请用 forEachRun
+    std::vector<PlateRecord> toVector() const;
+    
+    // 按块依次访问：fn(首行指针, 行数, 首行下标)
+    template <typename Fn>
+    void forEachRun(Fn fn) const {
+        forEachRun(0, count, fn);
+    }
+    
+    // 只访问 [first, last) 行，首末两段可能不足一块
+    template <typename Fn>
+    void forEachRun(size_t first, size_t last, Fn fn) const {
+        if (last > count) last = count;
+        for (size_t start = first; start < last; ) {
+            size_t c = start >> CHUNK_SHIFT;
+            size_t offset = start & (CHUNK_SIZE - 1);
+            size_t n = CHUNK_SIZE - offset;
+            if (n > last - start) n = last - start;
+            const Chunk* chunk = chunks[c].get();
+            fn(chunk ? chunk->data() + offset : base->data() + start, n, start);
+            start += n;
+        }
+    }
+    
+    // 记录本体占用的字节数（基底与各块按容量计，与其他快照共享的部分也计入）
+    size_t memoryBytes() const;
+    
+    // 单独分配（未引用基底）的块数
+    size_t ownChunkCount() const { return ownChunks; }
+
+private:
+    typedef std::vector<PlateRecord> Chunk;
+    
+    Chunk& mutableChunk(size_t c);
+    void addChunk();
+    
+    std::shared_ptr<const std::vector<PlateRecord>> base;  // 只读基底（可为空）
+    std::vector<std::shared_ptr<Chunk>> chunks;             // 为空的块取自基底
+    size_t count;
+    size_t ownChunks;
+};
+
+#endif // RECORD_TABLE_H
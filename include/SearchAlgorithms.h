@@ -2,12 +2,27 @@
 #define SEARCH_ALGORITHMS_H
 
 #include "PlateRecord.h"
+#include "RecordTable.h"
 #include <vector>
 #include <string>
 
+/**
+ * 单次查找结果
+ * 查找统计随结果返回，不再保存在静态变量中，便于多线程并发查找；
+ * 耗时由调用方按采样计入 Metrics，单次查找不再读时钟
+ */
+struct SearchResult {
+    int index;          // 找到返回下标，未找到为 -1
+    int comparisons;    // 比较次数
+    
+    SearchResult() : index(-1), comparisons(0) {}
+};
+
 /**
  * 查找算法模块
  * 包含折半查找和分块索引查找
+ * 所有函数均无共享状态，可被多个线程同时调用；
+ * 每个函数同时接受顺序表与分块记录表（快照中的存储形式）
  */
 class SearchAlgorithms {
 public:
@@ -15,18 +30,22 @@ public:
      * 折半查找车牌号（要求记录已按车牌号排序）
      * @param records 已排序的记录向量
      * @param plate 要查找的车牌号
-     * @return 找到返回下标，未找到返回-1
+     * @return 查找结果（下标、比较次数）
      */
-    static int binarySearch(const std::vector<PlateRecord>& records, 
+    static SearchResult binarySearch(const std::vector<PlateRecord>& records, 
+                           const std::string& plate);
+    static SearchResult binarySearch(const RecordTable& records,
                            const std::string& plate);
     
     /**
      * 顺序查找车牌号（用于未排序数据）
      * @param records 记录向量
      * @param plate 要查找的车牌号
-     * @return 找到返回下标，未找到返回-1
+     * @return 查找结果（下标、比较次数）
      */
-    static int linearSearch(const std::vector<PlateRecord>& records,
+    static SearchResult linearSearch(const std::vector<PlateRecord>& records,
+                           const std::string& plate);
+    static SearchResult linearSearch(const RecordTable& records,
                            const std::string& plate);
     
     /**
@@ -47,16 +66,9 @@ public:
     static std::vector<PlateRecord> prefixSearch(
         const std::vector<PlateRecord>& records,
         const std::string& prefix);
-    
-    /**
-     * 获取查找统计信息
-     */
-    static int getLastSearchCount() { return lastSearchCount; }
-    static double getLastSearchTime() { return lastSearchTime; }
-
-private:
-    static int lastSearchCount;
-    static double lastSearchTime;
+    static std::vector<PlateRecord> prefixSearch(
+        const RecordTable& records,
+        const std::string& prefix);
 };
 
 #endif // SEARCH_ALGORITHMS_H
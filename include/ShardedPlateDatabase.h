@@ -0,0 +1,128 @@
+#ifndef SHARDED_PLATE_DATABASE_H
+#define SHARDED_PLATE_DATABASE_H
+
+#include "PlateDatabase.h"
+#include <vector>
+#include <string>
+#include <memory>
+
+/**
+ * 按发牌机关代码字母分片的车牌数据库
+ * 每个有效字母（A-Z，排除 I/O，共 24 个）对应一个独立的 PlateDatabase 分片，
+ * 各分片拥有各自的记录、索引与写锁：
+ *   - 增删改按车牌字母路由到单个分片，不同城市的写入互不争用；
+ *   - 扫描、统计、前缀查询在各分片上并行执行后合并。
+ * 分片按字母顺序排列，因此各分片排序后按顺序拼接即为全局车牌序。
+ */
+class ShardedPlateDatabase {
+public:
+    ShardedPlateDatabase();
+    
+    ShardedPlateDatabase(const ShardedPlateDatabase&) = delete;
+    ShardedPlateDatabase& operator=(const ShardedPlateDatabase&) = delete;
+    
+    // ========== 分片路由 ==========
+    
+    /**
+     * 分片总数
+     */
+    static int shardCount();
+    
+    /**
+     * 根据车牌字母计算分片编号，字母无效返回 -1
+     */
+    static int shardOf(const std::string& plate);
+    
+    /**
+     * 分片编号对应的车牌字母
+     */
+    static char shardLetter(int shardId);
+    
+    /**
+     * 访问指定分片
+     */
+    PlateDatabase& shard(int shardId) { return *shards[shardId]; }
+    const PlateDatabase& shard(int shardId) const { return *shards[shardId]; }
+    
+    // ========== 基本操作：增删改查（路由到单个分片） ==========
+    
+    bool addRecord(const std::string& plate, const std::string& city,
+                   const std::string& owner);
+    
+    bool modifyRecord(const std::string& plate, const std::string& newCity,
+                      const std::string& newOwner);
+    
+    bool deleteRecord(const std::string& plate);
+    
+    /**
+     * 查找记录
+     * @param out 找到时写入记录副本（可为空）
+     * @return 是否找到
+     */
+    bool findRecord(const std::string& plate, PlateRecord* out = nullptr) const;
+    
+    // ========== 数据输入（按分片并行写入） ==========
+    
+    /**
+     * 批量导入：先按车牌字母分组，再并行导入各分片
+     * @return 成功导入的记录数
+     */
+    size_t batchImport(std::vector<PlateRecord> newRecords);
+    
+    /**
+     * 从文件导入
+     */
+    bool loadFromFile(const std::string& filename);
+    
+    // ========== 排序与查找（并行扇出） ==========
+    
+    /**
+     * 各分片并行执行链式基数排序
+     */
+    void radixSortByPlate();
+    
+    /**
+     * 各分片并行建立城市分块索引
+     */
+    void buildCityIndex();
+    
+    /**
+     * 前缀查询：前缀已包含车牌字母时只查单个分片，否则并行查询所有分片
+     */
+    std::vector<PlateRecord> prefixSearch(const std::string& prefix) const;
+    
+    /**
+     * 按城市查询（城市可能与车牌字母不匹配，需查询所有分片）
+     */
+    std::vector<PlateRecord> searchByCity(const std::string& city) const;
+    
+    // ========== 统计 ==========
+    
+    size_t getRecordCount() const;
+    
+    int getCityCount() const;
+    
+    std::vector<std::pair<std::string, int>> getCityStatistics() const;
+    
+    /**
+     * 按分片顺序拼接所有记录
+     */
+    std::vector<PlateRecord> getAllRecords() const;
+    
+    // ========== 文件与维护 ==========
+    
+    bool saveToFile(const std::string& filename) const;
+    
+    bool exportToCSV(const std::string& filename) const;
+    
+    void clearAll();
+
+private:
+    std::vector<std::unique_ptr<PlateDatabase>> shards;
+    
+    // 在各分片上并行执行查询，并按分片顺序拼接结果
+    template <typename Query>
+    std::vector<PlateRecord> gather(Query query) const;
+};
+
+#endif // SHARDED_PLATE_DATABASE_H
@@ -0,0 +1,96 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/**
+ * 阶段追踪（Chrome trace-event JSON，可直接拖入 chrome://tracing 或 ui.perfetto.dev）
+ * 用 PLATE_TRACE_SCOPE 标记一段代码，作用域结束时记录一个完整事件（名称、开始时刻、
+ * 时长、所在线程，可附带条目数）。每个线程写自己的环形缓冲区，写满后覆盖最早的事件；
+ * 线程退出后缓冲区连同其中的事件留给后来的线程复用，不随线程数增长。
+ *
+ * 运行时默认关闭，关闭时每个标记只读一次原子标志；
+ * 编译时定义 PLATE_TRACE_DISABLED（CMake 选项 PLATE_TRACE=OFF）则标记完全消失。
+ */
+class Trace {
+public:
+    // 每个线程默认保留的事件数
+    static const size_t DEFAULT_EVENTS = 1u << 16;
+    
+    /**
+     * 开始记录：清空已有事件，之后每个线程最多保留 eventsPerThread 个事件
+     * @return 编译时已去掉追踪时返回 false
+     */
+    static bool start(size_t eventsPerThread = DEFAULT_EVENTS);
+    
+    // 停止记录，已记录的事件保留到下次 start / clear
+    static void stop();
+    
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+    
+    static void clear();
+    
+    // 当前保留的事件数 / 因缓冲区写满被覆盖的事件数
+    static size_t eventCount();
+    static std::uint64_t droppedCount();
+    
+    // 为当前线程命名（显示为轨道名），未命名的线程显示为“线程 N”
+    static void setThreadName(const std::string& name);
+    
+    /**
+     * 导出全部事件（按开始时刻排序）
+     */
+    static std::string toJson();
+    static bool writeJson(const std::string& filename);
+    
+    // 自首次调用起的纳秒数
+    static std::uint64_t now();
+    
+    // 记录一个完整事件；name 必须是静态字符串，arg < 0 表示不附带条目数
+    static void record(const char* name, std::uint64_t startNs, std::uint64_t endNs,
+                       std::int64_t arg = -1);
+    
+    /**
+     * 作用域事件：构造时若已开始记录则读时钟，析构时记录
+     */
+    class Span {
+    public:
+        explicit Span(const char* n, std::int64_t a = -1)
+            : name(enabled() ? n : nullptr), arg(a), startNs(name ? now() : 0) {}
+        ~Span() {
+            if (name) {
+                record(name, startNs, now(), arg);
+            }
+        }
+    
+    private:
+        Span(const Span&);
+        Span& operator=(const Span&);
+        
+        const char* name;
+        std::int64_t arg;
+        std::uint64_t startNs;
+    };
+
+private:
+    static std::atomic<bool> active;
+};
+
+#define PLATE_TRACE_CONCAT_(a, b) a##b
+#define PLATE_TRACE_CONCAT(a, b) PLATE_TRACE_CONCAT_(a, b)
+
+#ifdef PLATE_TRACE_DISABLED
+#define PLATE_TRACE_SCOPE(name) do {} while (0)
+#define PLATE_TRACE_SCOPE_N(name, n) do {} while (0)
+#else
+// 标记到当前作用域结束；_N 版本附带条目数（记录数、行数等）
+#define PLATE_TRACE_SCOPE(name) \
+    Trace::Span PLATE_TRACE_CONCAT(traceSpan_, __LINE__)(name)
+#define PLATE_TRACE_SCOPE_N(name, n) \
+    Trace::Span PLATE_TRACE_CONCAT(traceSpan_, __LINE__)(name, static_cast<std::int64_t>(n))
+#endif
+
+#endif // TRACE_H
@@ -5,6 +5,8 @@
 #include <vector>
 #include <cctype>
 
+class PlateOccupancy;
+
 /**
  * 工具函数集合
  */
@@ -40,10 +42,13 @@ namespace Utils {
     std::string generateRandomPlate();
     
     // 根据城市生成随机车牌号（车牌字母与城市对应）
-    std::string generateRandomPlateByCity(const std::string& city);
+    // 给出 occupied 时从随机编号起取第一个空闲编号并标记占用，保证不重复；号段已满返回空字符串
+    std::string generateRandomPlateByCity(const std::string& city,
+                                          PlateOccupancy* occupied = nullptr);
     
-    // 根据城市生成随机新能源车牌号（车牌字母与城市对应，类型为 D/F）
-    std::string generateRandomNewEnergyPlateByCity(const std::string& city);
+    // 根据城市生成随机新能源车牌号（车牌字母与城市对应，类型为 D/F），occupied 含义同上
+    std::string generateRandomNewEnergyPlateByCity(const std::string& city,
+                                                   PlateOccupancy* occupied = nullptr);
     
     // 根据车牌字母获取对应城市（辽宁省）
     // 返回城市名，如果字母无效返回空字符串
@@ -0,0 +1,148 @@
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include "PlateRecord.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdio>
+#include <cstdint>
+
+/**
+ * 预写日志（WAL）
+ *
+ * 只追加的二进制日志，文件以 8 字节魔数 "PLATEWAL" 开头，之后每条记录为：
+ *   uint32 负载长度 | uint32 CRC32 | uint8 类型 | uint64 序号 | 负载
+ * 负载由若干字符串组成，每个字符串以变长整数长度为前缀。
+ *
+ * 组提交：append 只把记录追加到内存缓冲并分配序号；sync(lsn) 等待该序号落盘。
+ * 同一时刻只有一个线程执行 write + fsync，期间到达的其他写者在返回前
+ * 由下一次刷盘一并完成，多个写者共享一次 fsync。
+ */
+class WriteAheadLog {
+public:
+    // 日志记录类型
+    enum EntryType {
+        ENTRY_ADD = 1,          // 添加一条记录
+        ENTRY_MODIFY = 2,       // 修改城市与车主
+        ENTRY_DELETE = 3,       // 删除一条记录
+        ENTRY_CLEAR = 4,        // 清空全部数据
+        ENTRY_BATCH_ADD = 5     // 批量添加（导入、随机生成）
+    };
+    
+    /**
+     * 回放时解析出的一条日志
+     */
+    struct Entry {
+        EntryType type;
+        std::uint64_t lsn;
+        PlateRecord record;                 // ADD / MODIFY 的完整记录，DELETE 只有车牌
+        std::vector<PlateRecord> batch;     // BATCH_ADD
+        
+        Entry() : type(ENTRY_CLEAR), lsn(0) {}
+    };
+    
+    WriteAheadLog();
+    ~WriteAheadLog();
+    
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+    
+    /**
+     * 读取并校验日志文件，对每条完整记录调用 visit
+     * 遇到截断或校验失败的尾部记录即停止（视为崩溃时未写完的记录）
+     * @param lastLsn 输出最后一条有效记录的序号
+     * @param validBytes 输出有效部分的字节数
+     * @return 文件不存在或可读时返回 true
+     */
+    static bool replay(const std::string& path,
+                       const std::function<void(const Entry&)>& visit,
+                       std::uint64_t* lastLsn = nullptr,
+                       std::uint64_t* validBytes = nullptr);
+    
+    /**
+     * 打开日志用于追加（不存在则创建），丢弃 validBytes 之后的残缺尾部
+     * @param nextLsn 下一条记录使用的序号
+     */
+    bool open(const std::string& path, std::uint64_t validBytes, std::uint64_t nextLsn);
+    
+    void close();
+    
+    bool isOpen() const { return fp != nullptr; }
+    
+    // ========== 追加记录（只写入内存缓冲，返回分配的序号） ==========
+    // 日志已失效（此前刷盘失败）时不再追加，返回 0；调用者应据此拒绝修改
+    
+    std::uint64_t appendAdd(const PlateRecord& record);
+    std::uint64_t appendModify(const PlateRecord& record);
+    std::uint64_t appendDelete(const std::string& plate);
+    std::uint64_t appendClear();
+    
+    /**
+     * 批量添加 [first, last) 范围内的记录
+     */
+    std::uint64_t appendBatch(std::vector<PlateRecord>::const_iterator first,
+                              std::vector<PlateRecord>::const_iterator last);
+    
+    /**
+     * 等待序号不超过 lsn 的记录全部落盘（组提交）
+     */
+    bool sync(std::uint64_t lsn);
+    
+    /**
+     * 检查点完成后清空日志（保留文件头），序号继续递增
+     */
+    bool truncate();
+    
+    /**
+     * 检查点完成后删去序号不超过 lsn 的记录（保留文件头），之后追加的记录原样保留
+     * offset 是序号 lsn 之后第一条记录的位置，须与 lsn 一同由 lastLsn(&offset) 取得；
+     * 该位置的记录序号对不上（期间日志已被截断或重新打开）时不做任何修改并返回 false
+     */
+    bool truncateThrough(std::uint64_t lsn, std::uint64_t offset);
+    
+    /**
+     * 最后分配的序号
+     */
+    std::uint64_t lastLsn() const;
+    
+    // 同上，并给出下一条记录将写在日志中的位置（检查点据此只截去快照已包含的部分）
+    std::uint64_t lastLsn(std::uint64_t* endOffset) const;
+    
+    /**
+     * 是否已因刷盘失败而失效（失效后 append 返回 0、sync 均失败）
+     */
+    bool isFailed() const;
+    
+    // 统计：追加的记录数、执行的 fsync 次数、写入字节数
+    std::uint64_t entryCount() const;
+    std::uint64_t syncCount() const;
+    std::uint64_t bytesWritten() const;
+    
+    // 追加缓冲当前占用的内存字节数（按容量计）
+    size_t bufferBytes() const;
+
+private:
+    std::string path;
+    std::FILE* fp;
+    
+    mutable std::mutex mtx;
+    std::condition_variable flushed;
+    std::string pending;            // 尚未写入文件的记录
+    std::uint64_t nextLsn;
+    std::uint64_t durableLsn;       // 已落盘的最大序号
+    bool flushing;                  // 是否有线程正在刷盘
+    bool failed;                    // 写入失败后日志不再可信，后续 sync 均失败
+    
+    std::uint64_t entries;
+    std::uint64_t syncs;
+    std::uint64_t bytes;
+    std::uint64_t appended;         // 文件中的字节数加上缓冲中与正在刷盘的记录
+    
+    // 把一条编码好的负载加上记录头后追加到缓冲，返回序号（调用者持有 mtx）
+    std::uint64_t appendLocked(EntryType type, const std::string& payload);
+};
+
+#endif // WRITE_AHEAD_LOG_H
@@ -0,0 +1,25 @@
+#include "../include/BinaryCodec.h"
+
+namespace {
+    struct CrcTable {
+        std::uint32_t t[256];
+        CrcTable() {
+            for (std::uint32_t i = 0; i < 256; i++) {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+                }
+                t[i] = c;
+            }
+        }
+    };
+}
+
+std::uint32_t BinaryCodec::crc32(const char* data, size_t n, std::uint32_t crc) {
+    static const CrcTable table;
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++) {
+        crc = table.t[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
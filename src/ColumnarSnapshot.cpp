@@ -0,0 +1,516 @@
+#include "../include/ColumnarSnapshot.h"
+#include "../include/FileSync.h"
+#include "../include/Parallel.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace {
+    const char MAGIC[8] = {'P', 'L', 'A', 'T', 'E', 'S', 'N', 'P'};
+    const std::uint32_t ENDIAN_TAG = 0x01020304;
+    
+    const std::uint32_t FLAG_SORTED_BY_PLATE = 1;
+    const std::uint32_t FLAG_CITY_INDEX = 2;
+    
+    // 文件头
+    struct SnapshotHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t endianTag;
+        std::uint32_t flags;
+        std::uint32_t reserved;
+        std::uint64_t rowCount;
+        std::uint64_t cityCount;
+        std::uint64_t blockCount;
+        std::uint64_t keyOffset;
+        std::uint64_t cityIdOffset;
+        std::uint64_t categoryOffset;
+        std::uint64_t ownerOffsetOffset;
+        std::uint64_t ownerHeapOffset;
+        std::uint64_t ownerHeapSize;
+        std::uint64_t cityDictOffset;
+        std::uint64_t cityDictSize;
+        std::uint64_t blockOffset;
+        std::uint64_t fileSize;
+        std::uint64_t walSequence;      // 快照已包含的最后一条日志序号
+        std::uint64_t snapshotId;       // 快照标识（每次写入不同）
+    };
+    
+    // 城市分块（磁盘格式）
+    struct DiskBlock {
+        std::uint32_t cityId;
+        std::uint32_t reserved;
+        std::uint64_t start;
+        std::uint64_t count;
+    };
+    
+    // [offset, offset + count * elemSize) 是否落在 size 字节之内（不会溢出）
+    bool fitsIn(std::uint64_t size, std::uint64_t offset, std::uint64_t count,
+                std::uint64_t elemSize) {
+        return offset <= size && count <= (size - offset) / elemSize;
+    }
+    
+    std::uint64_t align8(std::uint64_t v) {
+        return (v + 7) & ~static_cast<std::uint64_t>(7);
+    }
+    
+    // 带大缓冲的顺序写入器
+    class BufferedWriter {
+    public:
+        explicit BufferedWriter(std::ofstream& out) : out(out), written(0) {
+            buf.reserve(1 << 20);
+        }
+        
+        void put(const void* data, size_t n) {
+            if (buf.size() + n > buf.capacity()) {
+                flush();
+            }
+            if (n >= buf.capacity()) {
+                out.write(static_cast<const char*>(data), static_cast<std::streamsize>(n));
+            } else {
+                const char* p = static_cast<const char*>(data);
+                buf.insert(buf.end(), p, p + n);
+            }
+            written += n;
+        }
+        
+        template <typename T>
+        void putValue(const T& v) { put(&v, sizeof(T)); }
+        
+        // 以 0 填充到 8 字节边界
+        void pad() {
+            static const char zeros[8] = {0};
+            put(zeros, static_cast<size_t>(align8(written) - written));
+        }
+        
+        void flush() {
+            if (!buf.empty()) {
+                out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+                buf.clear();
+            }
+        }
+        
+        std::uint64_t offset() const { return written; }
+        
+    private:
+        std::ofstream& out;
+        std::vector<char> buf;
+        std::uint64_t written;
+    };
+    
+    const std::string EMPTY_CITY;
+    
+    // 按行依次访问全部记录；分块记录表逐块访问，不拼接
+    template <typename Fn>
+    void forEachRecord(const std::vector<PlateRecord>& records, Fn fn) {
+        for (const auto& rec : records) {
+            fn(rec);
+        }
+    }
+    
+    template <typename Fn>
+    void forEachRecord(const RecordTable& records, Fn fn) {
+        records.forEachRun([&fn](const PlateRecord* first, size_t n, size_t) {
+            for (size_t i = 0; i < n; ++i) {
+                fn(first[i]);
+            }
+        });
+    }
+    
+    // 两种记录来源共用的写出实现
+    template <typename Rows>
+    bool writeRows(const std::string& filename, const Rows& records,
+                   const std::vector<CityBlock>& cityIndex,
+                   bool sortedByPlate, bool cityIndexBuilt,
+                   std::uint64_t walSequence, std::uint64_t snapshotId) {
+        const std::uint64_t n = records.size();
+        
+        // 城市字典：按首次出现顺序编号
+        std::unordered_map<std::string, std::uint16_t> cityIds;
+        std::vector<const std::string*> dict;
+        std::uint64_t ownerHeapSize = 0;
+        std::uint64_t dictBytes = 0;
+        bool tooManyCities = false;
+        forEachRecord(records, [&](const PlateRecord& rec) {
+            if (cityIds.find(rec.city) == cityIds.end()) {
+                if (dict.size() > 0xFFFF) {
+                    tooManyCities = true;
+                    return;
+                }
+                cityIds.emplace(rec.city, static_cast<std::uint16_t>(dict.size()));
+                dict.push_back(&rec.city);
+                dictBytes += rec.city.size();
+            }
+            ownerHeapSize += rec.owner.size();
+        });
+        if (tooManyCities) {
+            std::cerr << "城市种类过多，无法写入快照：" << filename << std::endl;
+            return false;
+        }
+        
+        // 计算各段偏移
+        SnapshotHeader h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.version = ColumnarSnapshot::FORMAT_VERSION;
+        h.endianTag = ENDIAN_TAG;
+        h.flags = (sortedByPlate ? FLAG_SORTED_BY_PLATE : 0) |
+                  (cityIndexBuilt ? FLAG_CITY_INDEX : 0);
+        h.rowCount = n;
+        h.cityCount = dict.size();
+        h.blockCount = cityIndexBuilt ? cityIndex.size() : 0;
+        
+        std::uint64_t off = align8(sizeof(SnapshotHeader));
+        h.keyOffset = off;          off = align8(off + 8 * n);
+        h.cityIdOffset = off;       off = align8(off + 2 * n);
+        h.categoryOffset = off;     off = align8(off + (n + 7) / 8);
+        h.ownerOffsetOffset = off;  off = align8(off + 8 * (n + 1));
+        h.ownerHeapOffset = off;    h.ownerHeapSize = ownerHeapSize;
+        off = align8(off + ownerHeapSize);
+        h.cityDictOffset = off;     h.cityDictSize = 4 * (dict.size() + 1) + dictBytes;
+        off = align8(off + h.cityDictSize);
+        h.blockOffset = off;        off += sizeof(DiskBlock) * h.blockCount;
+        h.fileSize = off;
+        h.walSequence = walSequence;
+        h.snapshotId = snapshotId != 0 ? snapshotId : ColumnarSnapshot::newSnapshotId();
+        
+        std::string tmpName = filename + ".tmp";
+        std::ofstream fout(tmpName, std::ios::binary | std::ios::trunc);
+        if (!fout.is_open()) {
+            std::cerr << "无法创建文件：" << tmpName << std::endl;
+            return false;
+        }
+        
+        BufferedWriter w(fout);
+        w.putValue(h);
+        w.pad();
+        
+        // 车牌列
+        const PlateRecord* invalid = nullptr;
+        forEachRecord(records, [&](const PlateRecord& rec) {
+            PlateKey key = PlateCodec::encode(rec.plate);
+            if (key == PlateCodec::INVALID_KEY) {
+                if (!invalid) invalid = &rec;
+                return;
+            }
+            w.putValue(key);
+        });
+        if (invalid) {
+            std::cerr << "快照写入失败，存在非法车牌：" << invalid->plate << std::endl;
+            fout.close();
+            std::remove(tmpName.c_str());
+            return false;
+        }
+        w.pad();
+        
+        // 城市列
+        forEachRecord(records, [&](const PlateRecord& rec) {
+            w.putValue(cityIds[rec.city]);
+        });
+        w.pad();
+        
+        // 类别位图
+        std::uint8_t bits = 0;
+        std::uint64_t i = 0;
+        forEachRecord(records, [&](const PlateRecord& rec) {
+            if (rec.category == "电车") {
+                bits |= static_cast<std::uint8_t>(1u << (i & 7));
+            }
+            if ((i & 7) == 7 || i + 1 == n) {
+                w.putValue(bits);
+                bits = 0;
+            }
+            ++i;
+        });
+        w.pad();
+        
+        // 车主偏移与字符串堆
+        std::uint64_t ownerOff = 0;
+        w.putValue(ownerOff);
+        forEachRecord(records, [&](const PlateRecord& rec) {
+            ownerOff += rec.owner.size();
+            w.putValue(ownerOff);
+        });
+        w.pad();
+        forEachRecord(records, [&](const PlateRecord& rec) {
+            w.put(rec.owner.data(), rec.owner.size());
+        });
+        w.pad();
+        
+        // 城市字典
+        std::uint32_t dictOff = 0;
+        w.putValue(dictOff);
+        for (const auto* city : dict) {
+            dictOff += static_cast<std::uint32_t>(city->size());
+            w.putValue(dictOff);
+        }
+        for (const auto* city : dict) {
+            w.put(city->data(), city->size());
+        }
+        w.pad();
+        
+        // 城市分块
+        for (std::uint64_t b = 0; b < h.blockCount; ++b) {
+            DiskBlock block;
+            block.cityId = cityIds[cityIndex[b].city];
+            block.reserved = 0;
+            block.start = static_cast<std::uint64_t>(cityIndex[b].start);
+            block.count = static_cast<std::uint64_t>(cityIndex[b].count);
+            w.putValue(block);
+        }
+        
+        w.flush();
+        fout.close();
+        if (!fout) {
+            std::cerr << "写入文件失败：" << tmpName << std::endl;
+            std::remove(tmpName.c_str());
+            return false;
+        }
+        // 快照落盘并且改名后的目录项落盘，才算写出完成（检查点随后截断日志）
+        return FileSync::commitReplace(tmpName, filename);
+    }
+}
+
+ColumnarSnapshot::ColumnarSnapshot()
+    : rowCount(0), sortedByPlate(false), cityIndexBuilt(false), walSeq(0), id(0),
+      keys(nullptr), cityIds(nullptr), categoryBits(nullptr),
+      ownerOffsets(nullptr), ownerHeap(nullptr), decodedReady(false) {
+}
+
+std::uint64_t ColumnarSnapshot::newSnapshotId() {
+    static std::mutex idMutex;
+    static std::mt19937_64 gen(static_cast<std::uint64_t>(std::random_device()()) ^
+        static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
+    std::lock_guard<std::mutex> lock(idMutex);
+    std::uint64_t v;
+    do {
+        v = gen();
+    } while (v == 0);
+    return v;
+}
+
+bool ColumnarSnapshot::write(const std::string& filename,
+                             const std::vector<PlateRecord>& records,
+                             const std::vector<CityBlock>& cityIndex,
+                             bool sortedByPlate, bool cityIndexBuilt,
+                             std::uint64_t walSequence,
+                             std::uint64_t snapshotId) {
+    return writeRows(filename, records, cityIndex, sortedByPlate, cityIndexBuilt,
+                     walSequence, snapshotId);
+}
+
+bool ColumnarSnapshot::write(const std::string& filename,
+                             const RecordTable& records,
+                             const std::vector<CityBlock>& cityIndex,
+                             bool sortedByPlate, bool cityIndexBuilt,
+                             std::uint64_t walSequence,
+                             std::uint64_t snapshotId) {
+    return writeRows(filename, records, cityIndex, sortedByPlate, cityIndexBuilt,
+                     walSequence, snapshotId);
+}
+
+bool ColumnarSnapshot::open(const std::string& filename) {
+    if (!file.open(filename, false)) {
+        std::cerr << "无法打开快照文件：" << filename << std::endl;
+        return false;
+    }
+    
+    SnapshotHeader h;
+    if (file.size() < sizeof(h)) {
+        std::cerr << "快照文件已损坏：" << filename << std::endl;
+        return false;
+    }
+    std::memcpy(&h, file.data(), sizeof(h));
+    
+    // 各段的偏移与长度都来自文件，逐项检查且不做可能溢出的加法
+    const std::uint64_t n = h.rowCount;
+    const std::uint64_t size = file.size();
+    bool ok = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+              h.endianTag == ENDIAN_TAG &&
+              h.fileSize == size &&
+              n <= static_cast<std::uint64_t>(std::numeric_limits<int>::max()) &&
+              h.keyOffset % 8 == 0 && h.cityIdOffset % 2 == 0 &&
+              h.ownerOffsetOffset % 8 == 0 && h.cityDictOffset % 4 == 0 &&
+              h.blockOffset % 8 == 0 &&
+              fitsIn(size, h.keyOffset, n, 8) &&
+              fitsIn(size, h.cityIdOffset, n, 2) &&
+              fitsIn(size, h.categoryOffset, (n + 7) / 8, 1) &&
+              fitsIn(size, h.ownerOffsetOffset, n + 1, 8) &&
+              fitsIn(size, h.ownerHeapOffset, h.ownerHeapSize, 1) &&
+              fitsIn(size, h.cityDictOffset, h.cityDictSize, 1) &&
+              h.cityCount < h.cityDictSize / 4 &&
+              fitsIn(size, h.blockOffset, h.blockCount, sizeof(DiskBlock));
+    if (!ok) {
+        std::cerr << "快照文件已损坏：" << filename << std::endl;
+        file.close();
+        return false;
+    }
+    if (h.version != FORMAT_VERSION) {
+        std::cerr << "不支持的快照版本 " << h.version << "：" << filename << std::endl;
+        file.close();
+        return false;
+    }
+    
+    const char* base = file.data();
+    rowCount = static_cast<size_t>(n);
+    sortedByPlate = (h.flags & FLAG_SORTED_BY_PLATE) != 0;
+    cityIndexBuilt = (h.flags & FLAG_CITY_INDEX) != 0;
+    walSeq = h.walSequence;
+    id = h.snapshotId;
+    keys = reinterpret_cast<const std::uint64_t*>(base + h.keyOffset);
+    cityIds = reinterpret_cast<const std::uint16_t*>(base + h.cityIdOffset);
+    categoryBits = reinterpret_cast<const std::uint8_t*>(base + h.categoryOffset);
+    ownerOffsets = reinterpret_cast<const std::uint64_t*>(base + h.ownerOffsetOffset);
+    ownerHeap = base + h.ownerHeapOffset;
+    
+    // 车主偏移从 0 开始单调不减并止于堆大小，否则按偏移取车主会越界；分块并行检查
+    const size_t CHUNK = 1 << 20;
+    size_t chunks = (rowCount + CHUNK - 1) / CHUNK;
+    std::vector<char> chunkOk(chunks, 1);
+    Parallel::forEach(chunks, [this, CHUNK, &chunkOk](size_t c) {
+        size_t end = std::min(rowCount, (c + 1) * CHUNK);
+        for (size_t i = c * CHUNK; i < end; ++i) {
+            if (ownerOffsets[i] > ownerOffsets[i + 1]) {
+                chunkOk[c] = 0;
+                return;
+            }
+        }
+    });
+    ok = ownerOffsets[0] == 0 && ownerOffsets[n] == h.ownerHeapSize &&
+         std::find(chunkOk.begin(), chunkOk.end(), 0) == chunkOk.end();
+    
+    // 展开城市字典：偏移同样须单调不减且不超出字典字节区
+    const std::uint32_t* dictOffsets = reinterpret_cast<const std::uint32_t*>(base + h.cityDictOffset);
+    const char* dictBytes = base + h.cityDictOffset + 4 * (h.cityCount + 1);
+    const std::uint64_t dictBytesSize = h.cityDictSize - 4 * (h.cityCount + 1);
+    ok = ok && dictOffsets[0] == 0 && dictOffsets[h.cityCount] <= dictBytesSize;
+    for (std::uint64_t i = 0; ok && i < h.cityCount; ++i) {
+        ok = dictOffsets[i] <= dictOffsets[i + 1];
+    }
+    if (!ok) {
+        std::cerr << "快照文件已损坏：" << filename << std::endl;
+        file.close();
+        return false;
+    }
+    cities.clear();
+    for (std::uint64_t i = 0; i < h.cityCount; ++i) {
+        cities.emplace_back(dictBytes + dictOffsets[i], dictOffsets[i + 1] - dictOffsets[i]);
+    }
+    
+    // 城市分块索引
+    blocks.clear();
+    const DiskBlock* disk = reinterpret_cast<const DiskBlock*>(base + h.blockOffset);
+    for (std::uint64_t i = 0; i < h.blockCount; ++i) {
+        if (disk[i].cityId >= cities.size() || disk[i].start > n ||
+            disk[i].count > n - disk[i].start) {
+            std::cerr << "快照文件已损坏：" << filename << std::endl;
+            file.close();
+            return false;
+        }
+        blocks.emplace_back(cities[disk[i].cityId],
+                            static_cast<int>(disk[i].start),
+                            static_cast<int>(disk[i].count));
+    }
+    
+    return true;
+}
+
+const std::string& ColumnarSnapshot::cityAt(size_t row) const {
+    std::uint16_t id = cityIds[row];
+    return id < cities.size() ? cities[id] : EMPTY_CITY;
+}
+
+std::string ColumnarSnapshot::ownerAt(size_t row) const {
+    return std::string(ownerHeap + ownerOffsets[row],
+                       static_cast<size_t>(ownerOffsets[row + 1] - ownerOffsets[row]));
+}
+
+PlateRecord ColumnarSnapshot::recordAt(size_t row) const {
+    PlateRecord rec;
+    char buf[PlateCodec::MAX_PLATE_BYTES];
+    rec.plate.assign(buf, PlateCodec::decode(keys[row], buf));
+    rec.city = cityAt(row);
+    rec.owner.assign(ownerHeap + ownerOffsets[row],
+                     static_cast<size_t>(ownerOffsets[row + 1] - ownerOffsets[row]));
+    rec.category = isNewEnergyAt(row) ? "电车" : "油车";
+    return rec;
+}
+
+SearchResult ColumnarSnapshot::find(const std::string& plate) const {
+    SearchResult result;
+    PlateKey key = PlateCodec::encode(plate);
+    if (key != PlateCodec::INVALID_KEY) {
+        if (sortedByPlate) {
+            long long l = 0, r = static_cast<long long>(rowCount) - 1;
+            while (l <= r) {
+                result.comparisons++;
+                long long mid = l + (r - l) / 2;
+                if (keys[mid] == key) {
+                    result.index = static_cast<int>(mid);
+                    break;
+                } else if (keys[mid] < key) {
+                    l = mid + 1;
+                } else {
+                    r = mid - 1;
+                }
+            }
+        } else {
+            for (size_t i = 0; i < rowCount; ++i) {
+                result.comparisons++;
+                if (keys[i] == key) {
+                    result.index = static_cast<int>(i);
+                    break;
+                }
+            }
+        }
+    }
+    
+    return result;
+}
+
+std::vector<PlateRecord> ColumnarSnapshot::prefixSearch(const std::string& prefix) const {
+    std::vector<PlateRecord> result;
+    PlateKey lo = 0, hi = 0;
+    if (!PlateCodec::prefixRange(prefix, lo, hi)) {
+        return result;
+    }
+    
+    if (sortedByPlate) {
+        // 已排序：匹配的记录在车牌列上连续
+        const std::uint64_t* first = std::lower_bound(keys, keys + rowCount, lo);
+        const std::uint64_t* last = std::lower_bound(first, keys + rowCount, hi);
+        result.reserve(static_cast<size_t>(last - first));
+        for (const std::uint64_t* p = first; p != last; ++p) {
+            result.push_back(recordAt(static_cast<size_t>(p - keys)));
+        }
+    } else {
+        for (size_t i = 0; i < rowCount; ++i) {
+            if (keys[i] >= lo && keys[i] < hi) {
+                result.push_back(recordAt(i));
+            }
+        }
+    }
+    return result;
+}
+
+const std::vector<PlateRecord>& ColumnarSnapshot::records() const {
+    std::call_once(decodeOnce, [this]() {
+        decoded.resize(rowCount);
+        const size_t CHUNK = 1 << 16;
+        size_t chunks = (rowCount + CHUNK - 1) / CHUNK;
+        Parallel::forEach(chunks, [this, CHUNK](size_t c) {
+            size_t end = std::min(rowCount, (c + 1) * CHUNK);
+            for (size_t i = c * CHUNK; i < end; ++i) {
+                decoded[i] = recordAt(i);
+            }
+        });
+        decodedReady = true;
+    });
+    return decoded;
+}
@@ -0,0 +1,597 @@
+#include "../include/DataGenerator.h"
+#include "../include/PlateKey.h"
+#include "../include/PlateOccupancy.h"
+#include "../include/EliasFanoPlateSet.h"
+#include "../include/Parallel.h"
+#include "../include/Utils.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // 有对应城市的发牌字母
+    const char CITY_LETTERS[] = "ABCDEFGHJKLMNP";
+    const std::uint32_t CITY_COUNT = sizeof(CITY_LETTERS) - 1;
+    const std::uint32_t KIND_COUNT = 3;
+    
+    // 全部号段的车牌数
+    const std::uint64_t PLATE_SPACE =
+        static_cast<std::uint64_t>(CITY_COUNT) * KIND_COUNT * PlateOccupancy::SERIAL_COUNT;
+    
+    // 常见姓氏与名字用字（UTF-8，均为 3 字节）
+    const char* const SURNAMES[] = {
+        "王", "李", "张", "刘", "陈", "杨", "赵", "黄", "周", "吴", "徐", "孙",
+        "胡", "朱", "高", "林", "何", "郭", "马", "罗", "梁", "宋", "郑", "谢"
+    };
+    const char* const GIVEN_CHARS[] = {
+        "伟", "芳", "娜", "敏", "静", "丽", "强", "磊", "军", "洋", "勇", "艳",
+        "杰", "娟", "涛", "明", "超", "秀", "霞", "平", "刚", "桂", "英", "华",
+        "鹏", "辉", "玲", "宇", "浩", "凯", "婷", "欣"
+    };
+    const std::uint32_t SURNAME_COUNT = sizeof(SURNAMES) / sizeof(SURNAMES[0]);
+    const std::uint32_t GIVEN_COUNT = sizeof(GIVEN_CHARS) / sizeof(GIVEN_CHARS[0]);
+    const size_t HANZI_BYTES = 3;
+    
+    // 各字母对应的城市名（首次使用时由 Utils 的映射表建立）
+    const std::vector<std::string>& cityNames() {
+        static const std::vector<std::string> names = []() {
+            std::vector<std::string> v;
+            for (std::uint32_t i = 0; i < CITY_COUNT; ++i) {
+                v.push_back(Utils::getCityByPlateLetter(CITY_LETTERS[i]));
+            }
+            return v;
+        }();
+        return names;
+    }
+    
+    /**
+     * [0, domain) 上的双射
+     * 在不小于 domain 的 4^k 上做 4 轮平衡 Feistel（各轮的密钥由种子派生），
+     * 结果超出区间时继续置换（cycle walking），平均不超过 4 次
+     */
+    class PlatePermutation {
+    public:
+        PlatePermutation(std::uint64_t seed, std::uint64_t domain = PLATE_SPACE)
+            : domain(domain), halfBits(1) {
+            while ((static_cast<std::uint64_t>(1) << (2 * halfBits)) < domain) {
+                halfBits++;
+            }
+            halfMask = (static_cast<std::uint64_t>(1) << halfBits) - 1;
+            std::uint64_t state = seed;
+            for (int i = 0; i < ROUNDS; ++i) {
+                keys[i] = Xoshiro256::splitMix64(state);
+            }
+        }
+        
+        std::uint64_t apply(std::uint64_t x) const {
+            do {
+                x = feistel(x);
+            } while (x >= domain);
+            return x;
+        }
+        
+    private:
+        static const int ROUNDS = 4;
+        std::uint64_t keys[ROUNDS];
+        std::uint64_t domain;
+        unsigned halfBits;
+        std::uint64_t halfMask;
+        
+        std::uint64_t feistel(std::uint64_t x) const {
+            std::uint64_t left = x >> halfBits;
+            std::uint64_t right = x & halfMask;
+            for (int i = 0; i < ROUNDS; ++i) {
+                std::uint64_t h = (right ^ keys[i]) * 0x9E3779B97F4A7C15ULL;
+                std::uint64_t f = h >> (64 - halfBits);
+                std::uint64_t t = right;
+                right = left ^ f;
+                left = t;
+            }
+            return (left << halfBits) | right;
+        }
+    };
+    
+    /**
+     * 生成的一行，字段指向行内缓冲区或静态表
+     */
+    struct GeneratedRow {
+        char plate[PlateCodec::MAX_PLATE_BYTES];
+        size_t plateLength;
+        const std::string* city;
+        const char* category;
+        char owner[HANZI_BYTES * 3 + 24];   // 姓名 + “#车主编号”
+        size_t ownerLength;
+    };
+    
+    // 由置换后的位置得到车牌、城市与类别
+    void fillPlate(std::uint64_t position, GeneratedRow& row) {
+        std::uint32_t serial = static_cast<std::uint32_t>(position % PlateOccupancy::SERIAL_COUNT);
+        std::uint32_t space = static_cast<std::uint32_t>(position / PlateOccupancy::SERIAL_COUNT);
+        std::uint32_t city = space / KIND_COUNT;
+        PlateOccupancy::Kind kind = static_cast<PlateOccupancy::Kind>(space % KIND_COUNT);
+        
+        row.plateLength = PlateOccupancy::formatPlate(CITY_LETTERS[city], kind, serial, row.plate);
+        row.city = &cityNames()[city];
+        row.category = kind == PlateOccupancy::KIND_FUEL ? "油车" : "电车";
+    }
+    
+    // 一次随机数决定姓氏、名字用字及单名 / 双名
+    void fillOwner(std::uint64_t r, GeneratedRow& row) {
+        const char* parts[3];
+        size_t n = 0;
+        parts[n++] = SURNAMES[(r & 0xFFFF) * SURNAME_COUNT >> 16];
+        parts[n++] = GIVEN_CHARS[((r >> 16) & 0xFFFF) * GIVEN_COUNT >> 16];
+        if (r >> 63) {
+            parts[n++] = GIVEN_CHARS[((r >> 32) & 0xFFFF) * GIVEN_COUNT >> 16];
+        }
+        for (size_t i = 0; i < n; ++i) {
+            std::memcpy(row.owner + i * HANZI_BYTES, parts[i], HANZI_BYTES);
+        }
+        row.ownerLength = n * HANZI_BYTES;
+    }
+    
+    // 第 segment 段的随机数流
+    Xoshiro256 segmentStream(std::uint64_t seed, std::uint64_t segment) {
+        std::uint64_t state = seed ^ (segment * 0xD1B54A32D192ED03ULL);
+        return Xoshiro256(Xoshiro256::splitMix64(state));
+    }
+    
+    /**
+     * 依次生成第 [first, last) 行并交给 visit(row, 行号)
+     * 每遇到段边界就换用该段的随机数流；区间起点不在段首时先跳过段内之前的输出
+     */
+    template <typename Visit>
+    void generateRows(std::uint64_t seed, const PlatePermutation& perm,
+                      std::uint64_t first, std::uint64_t last, Visit visit) {
+        GeneratedRow row;
+        std::uint64_t i = first;
+        while (i < last) {
+            std::uint64_t stream = i / DataGenerator::STREAM_ROWS;
+            std::uint64_t streamEnd = (stream + 1) * DataGenerator::STREAM_ROWS;
+            if (streamEnd > last) streamEnd = last;
+            
+            Xoshiro256 rng = segmentStream(seed, stream);
+            for (std::uint64_t skip = stream * DataGenerator::STREAM_ROWS; skip < i; ++skip) {
+                rng.next();
+            }
+            
+            for (; i < streamEnd; ++i) {
+                fillPlate(perm.apply(i), row);
+                fillOwner(rng.next(), row);
+                visit(row, i);
+            }
+        }
+    }
+    
+    const size_t SPACE_COUNT = CITY_COUNT * KIND_COUNT;
+    
+    // 追加十进制数字
+    size_t appendNumber(std::uint64_t v, char* out) {
+        char tmp[20];
+        size_t n = 0;
+        do {
+            tmp[n++] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        } while (v != 0);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = tmp[n - 1 - i];
+        }
+        return n;
+    }
+    
+    /**
+     * 按分布参数生成的计划
+     *
+     * 号段 = 城市 × 类型（燃油 / D / F），每行由一次随机数按累积权重选定号段；
+     * 每个号段中的第 k 辆车按序号 k 经下面的双射映射为编号：
+     *   前 k+1 个序号中有 min(⌊(k+1)·clusterShare⌋, 热点总数) 个落在热点区间，
+     *   新增的那个取热点区间置换中的下一个位置，否则取其余编号置换中的下一个位置。
+     * 热点占满后余下的序号全部落在其余编号中，映射始终是双射。
+     */
+    class SkewedPlan {
+    public:
+        SkewedPlan(const WorkloadSpec& spec, std::uint64_t seed, std::uint64_t rows)
+            : spec(spec), seed(seed), rows(rows), clusterTotal(0), ownerPool(0), ok(true) {
+            double weights[CITY_COUNT];
+            double weightSum = 0.0;
+            for (std::uint32_t c = 0; c < CITY_COUNT; ++c) {
+                if (!spec.cityWeights.empty()) {
+                    weights[c] = c < spec.cityWeights.size() ? spec.cityWeights[c] : -1.0;
+                } else {
+                    weights[c] = 1.0 / std::pow(static_cast<double>(c + 1), spec.cityZipf);
+                }
+                if (!(weights[c] >= 0.0)) {
+                    fail("城市权重必须为 14 个非负数");
+                    return;
+                }
+                weightSum += weights[c];
+            }
+            if (!spec.cityWeights.empty() && spec.cityWeights.size() != CITY_COUNT) {
+                fail("城市权重必须为 14 个非负数");
+                return;
+            }
+            if (!(weightSum > 0.0)) {
+                fail("城市权重之和必须大于 0");
+                return;
+            }
+            if (!(spec.evShare >= 0.0 && spec.evShare <= 1.0) ||
+                !(spec.clusterShare >= 0.0 && spec.clusterShare <= 1.0)) {
+                fail("新能源占比与热点比例必须在 [0, 1] 内");
+                return;
+            }
+            if (spec.clusterCount > 0 &&
+                (spec.clusterWidth == 0 ||
+                 static_cast<std::uint64_t>(spec.clusterCount) * spec.clusterWidth >
+                     PlateOccupancy::SERIAL_COUNT / 2)) {
+                fail("热点区间总宽度不能超过号段的一半");
+                return;
+            }
+            if (!(spec.vehiclesPerOwner >= 1.0)) {
+                fail("每位车主平均车辆数不能小于 1");
+                return;
+            }
+            
+            // 号段累积权重
+            const double kindShare[KIND_COUNT] = {
+                1.0 - spec.evShare, spec.evShare / 2.0, spec.evShare / 2.0
+            };
+            double acc = 0.0;
+            for (size_t sp = 0; sp < SPACE_COUNT; ++sp) {
+                acc += weights[sp / KIND_COUNT] / weightSum * kindShare[sp % KIND_COUNT];
+                cdf[sp] = acc;
+            }
+            
+            // 各号段的热点区间：在宽度对齐的槽位中随机选取互不相同的若干个
+            clusterTotal = spec.clusterCount > 0
+                ? static_cast<std::uint64_t>(spec.clusterCount) * spec.clusterWidth : 0;
+            std::uint64_t slots = spec.clusterCount > 0
+                ? PlateOccupancy::SERIAL_COUNT / spec.clusterWidth : 0;
+            clusterStarts.resize(SPACE_COUNT);
+            for (size_t sp = 0; sp < SPACE_COUNT; ++sp) {
+                std::uint64_t state = seed ^ ((sp + 1) * 0xA0761D6478BD642FULL);
+                Xoshiro256 rng(Xoshiro256::splitMix64(state));
+                std::vector<std::uint32_t>& starts = clusterStarts[sp];
+                while (starts.size() < spec.clusterCount) {
+                    std::uint32_t start = rng.below(static_cast<std::uint32_t>(slots)) * spec.clusterWidth;
+                    if (std::find(starts.begin(), starts.end(), start) == starts.end()) {
+                        starts.push_back(start);
+                    }
+                }
+                std::sort(starts.begin(), starts.end());
+                
+                clusterPerms.push_back(PlatePermutation(Xoshiro256::splitMix64(state),
+                                                        clusterTotal > 0 ? clusterTotal : 1));
+                backgroundPerms.push_back(PlatePermutation(Xoshiro256::splitMix64(state),
+                                                           PlateOccupancy::SERIAL_COUNT - clusterTotal));
+            }
+            
+            // 车主从 P 人中均匀抽取时，有车的车主约 P·(1 - e^-λ) 人（λ = 行数 / P）；
+            // 解 λ / (1 - e^-λ) = vehiclesPerOwner 使有车车主的平均车辆数符合参数
+            if (spec.vehiclesPerOwner > 1.0) {
+                double lo = 0.0;
+                double hi = 64.0;
+                for (int iter = 0; iter < 100; ++iter) {
+                    double mid = (lo + hi) / 2.0;
+                    if (mid / -std::expm1(-mid) < spec.vehiclesPerOwner) lo = mid; else hi = mid;
+                }
+                ownerPool = static_cast<std::uint64_t>(std::ceil(static_cast<double>(rows) / hi));
+                if (ownerPool == 0) ownerPool = 1;
+            }
+        }
+        
+        bool valid() const { return ok; }
+        
+        /**
+         * 第一遍：并行统计每段落在各号段的行数，换算为每段在各号段中的起始序号
+         * @return 某号段容量不足时返回 false
+         */
+        bool prepare(unsigned threads) {
+            size_t segments = static_cast<size_t>((rows + DataGenerator::STREAM_ROWS - 1) /
+                                                  DataGenerator::STREAM_ROWS);
+            offsets.assign(segments * SPACE_COUNT, 0);
+            Parallel::forEach(segments, [&](size_t seg) {
+                std::uint64_t from = static_cast<std::uint64_t>(seg) * DataGenerator::STREAM_ROWS;
+                std::uint64_t to = std::min<std::uint64_t>(from + DataGenerator::STREAM_ROWS, rows);
+                Xoshiro256 rng = segmentStream(seed, seg);
+                std::uint64_t* counts = &offsets[seg * SPACE_COUNT];
+                for (std::uint64_t i = from; i < to; ++i) {
+                    counts[pickSpace(rng.next())]++;
+                    rng.next();
+                }
+            }, threads);
+            
+            for (size_t sp = 0; sp < SPACE_COUNT; ++sp) {
+                std::uint64_t total = 0;
+                for (size_t seg = 0; seg < segments; ++seg) {
+                    std::uint64_t n = offsets[seg * SPACE_COUNT + sp];
+                    offsets[seg * SPACE_COUNT + sp] = total;
+                    total += n;
+                }
+                if (total > PlateOccupancy::SERIAL_COUNT) {
+                    fail("生成行数超出单个号段容量，请降低偏斜程度或行数");
+                    return false;
+                }
+            }
+            return true;
+        }
+        
+        /**
+         * 第二遍：依次生成第 [first, last) 行并交给 visit(row, 行号)
+         */
+        template <typename Visit>
+        void generateRows(std::uint64_t first, std::uint64_t last, Visit visit) const {
+            GeneratedRow row;
+            std::uint64_t ownerSalt = seed * 0x9E3779B97F4A7C15ULL;
+            std::uint64_t i = first;
+            while (i < last) {
+                std::uint64_t seg = i / DataGenerator::STREAM_ROWS;
+                std::uint64_t segEnd = std::min<std::uint64_t>((seg + 1) * DataGenerator::STREAM_ROWS, last);
+                
+                Xoshiro256 rng = segmentStream(seed, seg);
+                std::uint64_t ordinals[SPACE_COUNT];
+                std::copy(offsets.begin() + seg * SPACE_COUNT,
+                          offsets.begin() + (seg + 1) * SPACE_COUNT, ordinals);
+                for (std::uint64_t j = seg * DataGenerator::STREAM_ROWS; j < i; ++j) {
+                    ordinals[pickSpace(rng.next())]++;
+                    rng.next();
+                }
+                
+                for (; i < segEnd; ++i) {
+                    unsigned sp = pickSpace(rng.next());
+                    std::uint64_t r = rng.next();
+                    
+                    std::uint32_t city = sp / KIND_COUNT;
+                    PlateOccupancy::Kind kind = static_cast<PlateOccupancy::Kind>(sp % KIND_COUNT);
+                    row.plateLength = PlateOccupancy::formatPlate(
+                        CITY_LETTERS[city], kind, serialFor(sp, ordinals[sp]++), row.plate);
+                    row.city = &cityNames()[city];
+                    row.category = kind == PlateOccupancy::KIND_FUEL ? "油车" : "电车";
+                    
+                    // 同一车主编号总得到同一姓名
+                    std::uint64_t owner = ownerPool > 0 ? ((r >> 32) * ownerPool) >> 32 : i;
+                    std::uint64_t nameState = owner ^ ownerSalt;
+                    fillOwner(Xoshiro256::splitMix64(nameState), row);
+                    row.owner[row.ownerLength++] = '#';
+                    row.ownerLength += appendNumber(owner + 1, row.owner + row.ownerLength);
+                    
+                    visit(row, i);
+                }
+            }
+        }
+        
+    private:
+        const WorkloadSpec& spec;
+        std::uint64_t seed;
+        std::uint64_t rows;
+        double cdf[SPACE_COUNT];
+        std::uint64_t clusterTotal;
+        std::vector<std::vector<std::uint32_t>> clusterStarts;
+        std::vector<PlatePermutation> clusterPerms;
+        std::vector<PlatePermutation> backgroundPerms;
+        std::uint64_t ownerPool;                // 车主人数，0 表示一车一主
+        std::vector<std::uint64_t> offsets;     // [段 × 号段] 起始序号
+        bool ok;
+        
+        void fail(const char* reason) {
+            std::cerr << "数据分布参数错误：" << reason << std::endl;
+            ok = false;
+        }
+        
+        unsigned pickSpace(std::uint64_t r) const {
+            double u = static_cast<double>(r >> 11) * (1.0 / 9007199254740992.0) * cdf[SPACE_COUNT - 1];
+            const double* it = std::upper_bound(cdf, cdf + SPACE_COUNT, u);
+            size_t sp = static_cast<size_t>(it - cdf);
+            return static_cast<unsigned>(sp < SPACE_COUNT ? sp : SPACE_COUNT - 1);
+        }
+        
+        std::uint32_t serialFor(unsigned sp, std::uint64_t k) const {
+            if (clusterTotal > 0) {
+                std::uint64_t before = std::min<std::uint64_t>(
+                    static_cast<std::uint64_t>(std::floor(static_cast<double>(k) * spec.clusterShare)), clusterTotal);
+                std::uint64_t upTo = std::min<std::uint64_t>(
+                    static_cast<std::uint64_t>(std::floor(static_cast<double>(k + 1) * spec.clusterShare)), clusterTotal);
+                if (upTo > before) {
+                    std::uint64_t p = clusterPerms[sp].apply(upTo - 1);
+                    return clusterStarts[sp][p / spec.clusterWidth] +
+                           static_cast<std::uint32_t>(p % spec.clusterWidth);
+                }
+                k -= upTo;
+            }
+            
+            // 其余编号：跳过位于其前的热点区间
+            std::uint64_t p = backgroundPerms[sp].apply(k);
+            for (std::uint32_t start : clusterStarts[sp]) {
+                if (p < start) break;
+                p += spec.clusterWidth;
+            }
+            return static_cast<std::uint32_t>(p);
+        }
+    };
+}
+
+std::uint64_t DataGenerator::capacity() {
+    return PLATE_SPACE;
+}
+
+std::string DataGenerator::plateAt(std::uint64_t seed, std::uint64_t row) {
+    if (row >= PLATE_SPACE) {
+        return std::string();
+    }
+    GeneratedRow r;
+    fillPlate(PlatePermutation(seed).apply(row), r);
+    return std::string(r.plate, r.plateLength);
+}
+
+bool DataGenerator::generate(std::uint64_t seed, std::uint64_t first, size_t count,
+                             std::vector<PlateRecord>& records, unsigned threads) {
+    if (first > PLATE_SPACE || count > PLATE_SPACE - first) {
+        std::cerr << "生成行数超出车牌号段容量（" << PLATE_SPACE << "）！" << std::endl;
+        return false;
+    }
+    
+    const PlatePermutation perm(seed);
+    const size_t base = records.size();
+    records.resize(base + count);
+    
+    // 按段并行，每个任务写入自己的那一段记录
+    std::uint64_t last = first + count;
+    std::uint64_t firstStream = first / STREAM_ROWS;
+    size_t tasks = count == 0 ? 0 : static_cast<size_t>((last - 1) / STREAM_ROWS - firstStream + 1);
+    Parallel::forEach(tasks, [&](size_t t) {
+        std::uint64_t from = (firstStream + t) * STREAM_ROWS;
+        std::uint64_t to = from + STREAM_ROWS;
+        if (from < first) from = first;
+        if (to > last) to = last;
+        generateRows(seed, perm, from, to, [&](const GeneratedRow& row, std::uint64_t i) {
+            PlateRecord& rec = records[base + static_cast<size_t>(i - first)];
+            rec.plate.assign(row.plate, row.plateLength);
+            rec.city = *row.city;
+            rec.owner.assign(row.owner, row.ownerLength);
+            rec.category = row.category;
+        });
+    }, threads);
+    return true;
+}
+
+bool DataGenerator::writeFile(const std::string& filename, std::uint64_t seed, size_t count,
+                              bool csv, const ProgressFn& progress,
+                              SaveReport* report, unsigned threads) {
+    if (count > PLATE_SPACE) {
+        std::cerr << "生成行数超出车牌号段容量（" << PLATE_SPACE << "）！" << std::endl;
+        return false;
+    }
+    
+    const PlatePermutation perm(seed);
+    const char sep = csv ? ',' : ' ';
+    bool ok = FileIO::writeChunks(filename, count,
+        [&](size_t first, size_t last, std::string& out) {
+            out.clear();
+            generateRows(seed, perm, first, last, [&](const GeneratedRow& row, std::uint64_t) {
+                out.append(row.plate, row.plateLength);
+                out.push_back(sep);
+                out.append(*row.city);
+                out.push_back(sep);
+                out.append(row.owner, row.ownerLength);
+                out.push_back(sep);
+                out.append(row.category);
+                out.push_back('\n');
+            });
+        }, csv ? "车牌号,城市,车主,类别\n" : nullptr, progress, report, threads);
+    
+    if (ok) {
+        std::cout << "已生成 " << count << " 条记录到文件：" << filename << std::endl;
+    }
+    return ok;
+}
+
+bool DataGenerator::generate(const WorkloadSpec& spec, std::uint64_t seed, size_t count,
+                             std::vector<PlateRecord>& records, unsigned threads) {
+    SkewedPlan plan(spec, seed, count);
+    if (!plan.valid() || !plan.prepare(threads)) {
+        return false;
+    }
+    
+    const size_t base = records.size();
+    records.resize(base + count);
+    size_t tasks = (count + STREAM_ROWS - 1) / STREAM_ROWS;
+    Parallel::forEach(tasks, [&](size_t t) {
+        std::uint64_t from = static_cast<std::uint64_t>(t) * STREAM_ROWS;
+        std::uint64_t to = std::min<std::uint64_t>(from + STREAM_ROWS, count);
+        plan.generateRows(from, to, [&](const GeneratedRow& row, std::uint64_t i) {
+            PlateRecord& rec = records[base + static_cast<size_t>(i)];
+            rec.plate.assign(row.plate, row.plateLength);
+            rec.city = *row.city;
+            rec.owner.assign(row.owner, row.ownerLength);
+            rec.category = row.category;
+        });
+    }, threads);
+    return true;
+}
+
+bool DataGenerator::writeFile(const std::string& filename, const WorkloadSpec& spec,
+                              std::uint64_t seed, size_t count, bool csv,
+                              const ProgressFn& progress, SaveReport* report,
+                              unsigned threads) {
+    SkewedPlan plan(spec, seed, count);
+    if (!plan.valid() || !plan.prepare(threads)) {
+        return false;
+    }
+    
+    const char sep = csv ? ',' : ' ';
+    bool ok = FileIO::writeChunks(filename, count,
+        [&](size_t first, size_t last, std::string& out) {
+            out.clear();
+            plan.generateRows(first, last, [&](const GeneratedRow& row, std::uint64_t) {
+                out.append(row.plate, row.plateLength);
+                out.push_back(sep);
+                out.append(*row.city);
+                out.push_back(sep);
+                out.append(row.owner, row.ownerLength);
+                out.push_back(sep);
+                out.append(row.category);
+                out.push_back('\n');
+            });
+        }, csv ? "车牌号,城市,车主,类别\n" : nullptr, progress, report, threads);
+    
+    if (ok) {
+        std::cout << "已按分布参数生成 " << count << " 条记录到文件：" << filename << std::endl;
+    }
+    return ok;
+}
+
+std::vector<WorkloadQuery> DataGenerator::generateQueries(const std::vector<PlateRecord>& data,
+                                                          const QueryMixSpec& mix,
+                                                          std::uint64_t seed, size_t count) {
+    std::vector<WorkloadQuery> queries;
+    queries.reserve(count);
+    
+    Xoshiro256 rng(seed);
+    const size_t n = data.size();
+    ZipfSampler zipf(n, mix.keyZipf);
+    std::uint64_t scramble = seed ^ 0x2545F4914F6CDD1DULL;
+    
+    // 已有车牌的压缩集合，用于确认未命中查询确实不存在
+    EliasFanoPlateSet present;
+    present.build(data);
+    
+    // 按热度取一条记录：Zipf 排名经散列映射到行号，热点分散在整张表中
+    auto hotRecord = [&]() -> const PlateRecord& {
+        std::uint64_t rank = zipf.sample(rng);
+        std::uint64_t state = rank ^ scramble;
+        return data[static_cast<size_t>(Xoshiro256::splitMix64(state) % n)];
+    };
+    auto missingPlate = [&]() -> std::string {
+        for (;;) {
+            char letter = CITY_LETTERS[rng.below(CITY_COUNT)];
+            PlateOccupancy::Kind kind = static_cast<PlateOccupancy::Kind>(rng.below(KIND_COUNT));
+            std::string plate = PlateOccupancy::makePlate(letter, kind, rng.below(PlateOccupancy::SERIAL_COUNT));
+            if (present.find(plate) < 0) {
+                return plate;
+            }
+        }
+    };
+    
+    unsigned minPrefix = std::max(1u, std::min(mix.minPrefix, mix.maxPrefix));
+    unsigned maxPrefix = std::max(minPrefix, mix.maxPrefix);
+    
+    for (size_t q = 0; q < count; ++q) {
+        WorkloadQuery query;
+        double u = rng.uniform();
+        if (u < mix.prefixShare) {
+            query.type = QUERY_PREFIX;
+            std::string plate = n > 0 ? hotRecord().plate : missingPlate();
+            size_t len = minPrefix + rng.below(maxPrefix - minPrefix + 1);
+            query.key = plate.substr(0, std::min(plate.size(), 3 + len));  // “辽”占 3 字节
+        } else if (u < mix.prefixShare + mix.cityShare) {
+            query.type = QUERY_CITY;
+            query.key = n > 0 ? hotRecord().city : cityNames()[rng.below(CITY_COUNT)];
+        } else {
+            query.type = QUERY_LOOKUP;
+            query.expectHit = n > 0 && rng.uniform() < mix.hitRatio;
+            query.key = query.expectHit ? hotRecord().plate : missingPlate();
+        }
+        queries.push_back(query);
+    }
+    return queries;
+}
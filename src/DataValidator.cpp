@@ -0,0 +1,293 @@
+#include "../include/DataValidator.h"
+#include "../include/MemoryTracker.h"
+#include "../include/PlateBatch.h"
+#include "../include/PlateKey.h"
+#include "../include/Parallel.h"
+#include "../include/Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+namespace {
+    // 重复检测的分区数（按编码散列的高位划分）
+    const unsigned PARTITION_BITS = 8;
+    const size_t PARTITION_COUNT = static_cast<size_t>(1) << PARTITION_BITS;
+    
+    // 每个线程至少处理的记录数，记录太少时不值得开线程
+    const size_t MIN_ROWS_PER_THREAD = 1u << 14;
+    
+    // 合法车牌编码的分区缓冲，计入 MemoryTracker 的验证缓冲
+    typedef std::vector<PlateKey, TrackingAllocator<PlateKey, MemoryTracker::VALIDATE> > KeyList;
+    
+    inline size_t partitionOf(PlateKey key) {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> (64 - PARTITION_BITS));
+    }
+    
+    // 发牌字母 → 城市名，直接按字母下标查表
+    struct CityTable {
+        std::string city[26];
+        bool known[26];
+        
+        CityTable() {
+            for (int i = 0; i < 26; ++i) {
+                city[i] = Utils::getCityByPlateLetter(static_cast<char>('A' + i));
+                known[i] = !city[i].empty();
+            }
+        }
+    };
+    
+    const CityTable& cityTable() {
+        static const CityTable table;
+        return table;
+    }
+    
+    // 每批向量化校验的车牌数
+    const size_t BATCH_ROWS = 1024;
+    
+    /**
+     * 单个线程的扫描结果
+     */
+    struct BlockResult {
+        size_t invalid;
+        size_t mismatches;
+        std::vector<const std::string*> invalidPlates;      // 全部非法车牌（用于重复检测）
+        std::vector<size_t> mismatchRows;                   // 前若干条不匹配记录的行号
+        std::vector<KeyList> partitions;                    // 合法车牌编码
+        
+        BlockResult() : invalid(0), mismatches(0), partitions(PARTITION_COUNT) {}
+    };
+    
+    // 先按平均分布预留各分区容量，减少扩容
+    void reservePartitions(size_t rows, BlockResult& out) {
+        size_t expected = rows / PARTITION_COUNT + 16;
+        for (auto& part : out.partitions) {
+            part.reserve(expected + expected / 4);
+        }
+    }
+    
+    // 扫描连续存放的 n 条记录，start 是首条的行号
+    void scanRun(const PlateRecord* rows, size_t n, size_t start,
+                 size_t maxSamples, BlockResult& out) {
+        const CityTable& table = cityTable();
+        
+        // 按批向量化校验并编码，不再逐字符检查
+        PlateBatch batch(BATCH_ROWS);
+        for (size_t begin = 0; begin < n; begin += BATCH_ROWS) {
+            size_t end = std::min(n, begin + BATCH_ROWS);
+            batch.clear();
+            for (size_t i = begin; i < end; ++i) {
+                batch.add(rows[i].plate);
+            }
+            batch.classify();
+            
+            for (size_t i = begin; i < end; ++i) {
+                const PlateRecord& rec = rows[i];
+                size_t j = i - begin;
+                // 验证沿用 Utils::isValidPlate 的规则，小写字母视为非法
+                if (batch.flags(j) != PlateBatch::FLAG_VALID &&
+                    batch.flags(j) != (PlateBatch::FLAG_VALID | PlateBatch::FLAG_NEW_ENERGY)) {
+                    out.invalid++;
+                    out.invalidPlates.push_back(&rec.plate);
+                    continue;
+                }
+                
+                PlateKey key = batch.key(j);
+                out.partitions[partitionOf(key)].push_back(key);
+                
+                int letter = rec.plate[3] - 'A';
+                if (!table.known[letter] || table.city[letter] != rec.city) {
+                    if (out.mismatches < maxSamples) {
+                        out.mismatchRows.push_back(start + i);
+                    }
+                    out.mismatches++;
+                }
+            }
+        }
+    }
+    
+    // 扫描 [first, last) 行
+    void scanBlock(const std::vector<PlateRecord>& records, size_t first, size_t last,
+                   size_t maxSamples, BlockResult& out) {
+        reservePartitions(last - first, out);
+        scanRun(records.data() + first, last - first, first, maxSamples, out);
+    }
+    
+    // 同上，分块记录表逐块扫描，不拼接
+    void scanBlock(const RecordTable& records, size_t first, size_t last,
+                   size_t maxSamples, BlockResult& out) {
+        reservePartitions(last - first, out);
+        records.forEachRun(first, last, [&](const PlateRecord* rows, size_t n, size_t start) {
+            scanRun(rows, n, start, maxSamples, out);
+        });
+    }
+    
+    bool lessByValue(const std::string* a, const std::string* b) {
+        return *a < *b;
+    }
+}
+
+// 两种记录来源共用的验证实现
+template <typename Rows>
+static ValidationReport validateRows(const Rows& records, unsigned threads) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    ValidationReport report;
+    const size_t n = records.size();
+    report.total = n;
+    
+    if (threads == 0) {
+        threads = Parallel::defaultThreads();
+    }
+    size_t maxThreads = std::max<size_t>(1, n / MIN_ROWS_PER_THREAD);
+    if (threads > maxThreads) {
+        threads = static_cast<unsigned>(maxThreads);
+    }
+    report.threads = threads;
+    
+    // 第一阶段：每个线程扫描相邻的一段记录
+    std::vector<BlockResult> blocks(threads);
+    Parallel::forEach(threads, [&](size_t t) {
+        size_t first = n * t / threads;
+        size_t last = n * (t + 1) / threads;
+        scanBlock(records, first, last, report.maxSamples, blocks[t]);
+    }, threads);
+    
+    // 按记录顺序合并计数与明细
+    std::vector<const std::string*> invalidPlates;
+    for (const auto& b : blocks) {
+        report.invalid += b.invalid;
+        for (size_t i = 0; i < b.invalidPlates.size() && report.invalidSamples.size() < report.maxSamples; ++i) {
+            report.invalidSamples.push_back(*b.invalidPlates[i]);
+        }
+        invalidPlates.insert(invalidPlates.end(), b.invalidPlates.begin(), b.invalidPlates.end());
+        
+        for (size_t row : b.mismatchRows) {
+            if (report.mismatchSamples.size() < report.maxSamples) {
+                report.mismatchSamples.push_back(std::make_pair(records[row].plate, records[row].city));
+            }
+        }
+        report.mismatches += b.mismatches;
+    }
+    
+    // 第二阶段：各分区合并、排序，相邻相等即重复
+    std::vector<size_t> partDuplicates(PARTITION_COUNT, 0);
+    std::vector<size_t> partPlates(PARTITION_COUNT, 0);
+    std::vector<std::vector<std::pair<PlateKey, size_t>>> partSamples(PARTITION_COUNT);
+    Parallel::forEach(PARTITION_COUNT, [&](size_t p) {
+        size_t size = 0;
+        for (const auto& b : blocks) {
+            size += b.partitions[p].size();
+        }
+        KeyList keys;
+        keys.reserve(size);
+        for (auto& b : blocks) {
+            keys.insert(keys.end(), b.partitions[p].begin(), b.partitions[p].end());
+            KeyList().swap(b.partitions[p]);
+        }
+        std::sort(keys.begin(), keys.end());
+        
+        for (size_t i = 0; i < keys.size();) {
+            size_t j = i + 1;
+            while (j < keys.size() && keys[j] == keys[i]) {
+                j++;
+            }
+            if (j - i > 1) {
+                partDuplicates[p] += j - i - 1;
+                partPlates[p]++;
+                if (partSamples[p].size() < report.maxSamples) {
+                    partSamples[p].push_back(std::make_pair(keys[i], j - i));
+                }
+            }
+            i = j;
+        }
+    }, threads);
+    
+    std::vector<std::pair<PlateKey, size_t>> duplicateKeys;
+    for (size_t p = 0; p < PARTITION_COUNT; ++p) {
+        report.duplicates += partDuplicates[p];
+        report.duplicatePlates += partPlates[p];
+        duplicateKeys.insert(duplicateKeys.end(), partSamples[p].begin(), partSamples[p].end());
+    }
+    std::sort(duplicateKeys.begin(), duplicateKeys.end());
+    for (size_t i = 0; i < duplicateKeys.size() && i < report.maxSamples; ++i) {
+        report.duplicateSamples.push_back(
+            std::make_pair(PlateCodec::decode(duplicateKeys[i].first), duplicateKeys[i].second));
+    }
+    
+    // 非法车牌之间的重复（数量通常很少，直接排序）
+    std::sort(invalidPlates.begin(), invalidPlates.end(), lessByValue);
+    for (size_t i = 0; i < invalidPlates.size();) {
+        size_t j = i + 1;
+        while (j < invalidPlates.size() && *invalidPlates[j] == *invalidPlates[i]) {
+            j++;
+        }
+        if (j - i > 1) {
+            report.duplicates += j - i - 1;
+            report.duplicatePlates++;
+            if (report.duplicateSamples.size() < report.maxSamples) {
+                report.duplicateSamples.push_back(std::make_pair(*invalidPlates[i], j - i));
+            }
+        }
+        i = j;
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    report.timeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    return report;
+}
+
+ValidationReport DataValidator::validate(const std::vector<PlateRecord>& records,
+                                         unsigned threads) {
+    return validateRows(records, threads);
+}
+
+ValidationReport DataValidator::validate(const RecordTable& records, unsigned threads) {
+    return validateRows(records, threads);
+}
+
+std::string ValidationReport::toString() const {
+    std::ostringstream oss;
+    oss << "========== 数据验证结果 ==========\n";
+    oss << "总记录数：" << total << "\n";
+    oss << "有效记录数：" << (total - invalid) << "\n";
+    oss << "非法车牌数：" << invalid << "\n";
+    oss << "重复车牌数：" << duplicates << "\n";
+    oss << "数据完整性：" << (passed() ? "✓ 通过" : "✗ 未通过") << "\n";
+    
+    if (invalid > 0) {
+        oss << "\n【非法车牌列表】\n";
+        for (const auto& plate : invalidSamples) {
+            oss << "  " << plate << "\n";
+        }
+        if (invalid > invalidSamples.size()) {
+            oss << "  ... 还有 " << (invalid - invalidSamples.size()) << " 个非法车牌\n";
+        }
+    }
+    
+    if (duplicates > 0) {
+        oss << "\n【重复车牌列表】\n";
+        for (const auto& d : duplicateSamples) {
+            oss << "  " << d.first << " (出现 " << d.second << " 次)\n";
+        }
+        if (duplicatePlates > duplicateSamples.size()) {
+            oss << "  ... 还有 " << (duplicatePlates - duplicateSamples.size()) << " 个重复车牌\n";
+        }
+    }
+    
+    if (mismatches > 0) {
+        oss << "\n【车牌与城市不匹配】\n";
+        oss << "不匹配数量：" << mismatches << "\n";
+        for (const auto& m : mismatchSamples) {
+            oss << "  " << m.first << " (城市: " << m.second << ")\n";
+        }
+        if (mismatches > mismatchSamples.size()) {
+            oss << "  ... 还有 " << (mismatches - mismatchSamples.size()) << " 个不匹配记录\n";
+        }
+    } else {
+        oss << "\n【车牌与城市匹配】✓ 全部匹配\n";
+    }
+    
+    oss << "\n验证耗时：" << static_cast<long long>(timeMs) << " ms（" << threads << " 线程）\n";
+    oss << "=============================";
+    return oss.str();
+}
@@ -0,0 +1,126 @@
+#include "../include/DeltaFile.h"
+#include "../include/BinaryCodec.h"
+#include "../include/FileSync.h"
+#include "../include/MappedFile.h"
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    const char MAGIC[8] = {'P', 'L', 'A', 'T', 'E', 'D', 'L', 'T'};
+    
+    // 魔数(8) + 版本(4) + 标志(4) + 基准标识(8) + 序号(8) + 条数(8)
+    const size_t HEADER_SIZE = 8 + 4 + 4 + 8 + 8 + 8;
+    
+    const std::uint32_t FLAG_CLEARED = 1;
+    
+    const unsigned char CHANGE_UPSERT = 1;
+    const unsigned char CHANGE_REMOVE = 2;
+}
+
+std::string DeltaFile::pathFor(const std::string& baseFile, std::uint64_t sequence) {
+    return baseFile + "." + std::to_string(sequence) + ".delta";
+}
+
+bool DeltaFile::write(const std::string& filename, std::uint64_t baseId,
+                      std::uint64_t sequence, bool cleared,
+                      const std::vector<DeltaChange>& changes) {
+    std::string buf(MAGIC, sizeof(MAGIC));
+    BinaryCodec::putU32(buf, FORMAT_VERSION);
+    BinaryCodec::putU32(buf, cleared ? FLAG_CLEARED : 0);
+    BinaryCodec::putU64(buf, baseId);
+    BinaryCodec::putU64(buf, sequence);
+    BinaryCodec::putU64(buf, changes.size());
+    for (const auto& c : changes) {
+        if (c.removed) {
+            buf.push_back(static_cast<char>(CHANGE_REMOVE));
+            BinaryCodec::putString(buf, c.record.plate);
+        } else {
+            buf.push_back(static_cast<char>(CHANGE_UPSERT));
+            BinaryCodec::putRecord(buf, c.record);
+        }
+    }
+    BinaryCodec::putU32(buf, BinaryCodec::crc32(buf.data(), buf.size()));
+    
+    std::string tmpName = filename + ".tmp";
+    {
+        std::ofstream fout(tmpName, std::ios::binary | std::ios::trunc);
+        if (!fout.is_open()) {
+            std::cerr << "无法创建文件：" << tmpName << std::endl;
+            return false;
+        }
+        fout.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        fout.close();
+        if (!fout) {
+            std::cerr << "写入文件失败：" << tmpName << std::endl;
+            std::remove(tmpName.c_str());
+            return false;
+        }
+    }
+    
+    // 返回成功后调用者即丢弃这些变化，因此文件与目录项都须先落盘
+    return FileSync::commitReplace(tmpName, filename);
+}
+
+bool DeltaFile::read(const std::string& filename, std::uint64_t* baseId,
+                     std::uint64_t* sequence, bool* cleared,
+                     std::vector<DeltaChange>& changes) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    
+    const char* data = file.data();
+    size_t size = file.size();
+    if (size < HEADER_SIZE + 4 || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+        BinaryCodec::getU32(data + size - 4) != BinaryCodec::crc32(data, size - 4)) {
+        std::cerr << "增量文件已损坏：" << filename << std::endl;
+        return false;
+    }
+    if (BinaryCodec::getU32(data + 8) != FORMAT_VERSION) {
+        std::cerr << "不支持的增量文件版本：" << filename << std::endl;
+        return false;
+    }
+    
+    std::uint32_t flags = BinaryCodec::getU32(data + 12);
+    if (baseId) *baseId = BinaryCodec::getU64(data + 16);
+    if (sequence) *sequence = BinaryCodec::getU64(data + 24);
+    if (cleared) *cleared = (flags & FLAG_CLEARED) != 0;
+    std::uint64_t count = BinaryCodec::getU64(data + 32);
+    
+    BinaryCodec::Reader in(data + HEADER_SIZE, data + size - 4);
+    changes.clear();
+    // 每条至少 2 字节，据此拒绝明显错误的条数
+    if (count > size / 2) {
+        std::cerr << "增量文件已损坏：" << filename << std::endl;
+        return false;
+    }
+    changes.reserve(static_cast<size_t>(count));
+    for (std::uint64_t i = 0; i < count && in.ok; ++i) {
+        unsigned char type = in.byte();
+        if (type == CHANGE_REMOVE) {
+            PlateRecord rec;
+            rec.plate = in.str();
+            changes.emplace_back(true, rec);
+        } else if (type == CHANGE_UPSERT) {
+            changes.emplace_back(false, in.record());
+        } else {
+            in.ok = false;
+        }
+    }
+    if (!in.ok || !in.atEnd()) {
+        std::cerr << "增量文件已损坏：" << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void DeltaFile::removeAll(const std::string& baseFile) {
+    for (std::uint64_t seq = 1; ; ++seq) {
+        std::string path = pathFor(baseFile, seq);
+        if (std::remove(path.c_str()) != 0) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,277 @@
+#include "../include/EliasFanoPlateSet.h"
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+    // 采样间隔（每 256 个 1 或 0 记录一次位置）
+    const size_t SAMPLE_RATE = 256;
+    
+    inline unsigned popcount64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_popcountll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<unsigned>(__popcnt64(x));
+#else
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<unsigned>((x * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+    
+    inline unsigned ctz64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long idx;
+        _BitScanForward64(&idx, x);
+        return static_cast<unsigned>(idx);
+#else
+        unsigned n = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+    
+    // 字中第 k 个（从 0 计）置位的位置，调用者保证存在
+    inline unsigned selectInWord(std::uint64_t word, unsigned k) {
+        for (unsigned i = 0; i < k; ++i) {
+            word &= word - 1;
+        }
+        return ctz64(word);
+    }
+}
+
+EliasFanoPlateSet::EliasFanoPlateSet()
+    : count(0), base(0), lowWidth(0), lowMask(0), maxHigh(0), highLength(0) {
+}
+
+void EliasFanoPlateSet::build(const std::vector<PlateKey>& sortedKeys) {
+    count = sortedKeys.size();
+    low.clear();
+    high.clear();
+    oneSamples.clear();
+    zeroSamples.clear();
+    base = 0;
+    lowWidth = 0;
+    lowMask = 0;
+    maxHigh = 0;
+    highLength = 0;
+    if (count == 0) {
+        return;
+    }
+    
+    // l = floor(log2(跨度 / n))；同一省份的车牌共享高位，减去最小值后跨度显著缩小
+    base = sortedKeys.front();
+    std::uint64_t universe = sortedKeys.back() - base + 1;
+    std::uint64_t ratio = universe / count;
+    while (ratio > 1) {
+        ratio >>= 1;
+        lowWidth++;
+    }
+    lowMask = lowWidth == 0 ? 0 : ((static_cast<std::uint64_t>(1) << lowWidth) - 1);
+    maxHigh = (sortedKeys.back() - base) >> lowWidth;
+    highLength = static_cast<size_t>(maxHigh) + count + 1;
+    
+    low.assign((count * lowWidth + 63) / 64, 0);
+    high.assign((highLength + 63) / 64, 0);
+    
+    for (size_t i = 0; i < count; ++i) {
+        std::uint64_t key = sortedKeys[i] - base;
+        
+        if (lowWidth > 0) {
+            std::uint64_t v = key & lowMask;
+            size_t bit = i * lowWidth;
+            size_t word = bit >> 6;
+            unsigned shift = static_cast<unsigned>(bit & 63);
+            low[word] |= v << shift;
+            if (shift + lowWidth > 64) {
+                low[word + 1] |= v >> (64 - shift);
+            }
+        }
+        
+        size_t pos = static_cast<size_t>(key >> lowWidth) + i;
+        high[pos >> 6] |= static_cast<std::uint64_t>(1) << (pos & 63);
+    }
+    
+    // 采样：逐字统计，定位第 k*256 个 1 与 0
+    size_t ones = 0;
+    size_t zeros = 0;
+    for (size_t w = 0; w < high.size(); ++w) {
+        std::uint64_t word = high[w];
+        size_t bitsInWord = std::min<size_t>(64, highLength - w * 64);
+        std::uint64_t valid = bitsInWord == 64 ? ~static_cast<std::uint64_t>(0)
+                                               : ((static_cast<std::uint64_t>(1) << bitsInWord) - 1);
+        std::uint64_t zeroWord = ~word & valid;
+        size_t wordOnes = popcount64(word);
+        size_t wordZeros = popcount64(zeroWord);
+        
+        while (oneSamples.size() * SAMPLE_RATE < ones + wordOnes) {
+            unsigned k = static_cast<unsigned>(oneSamples.size() * SAMPLE_RATE - ones);
+            oneSamples.push_back(w * 64 + selectInWord(word, k));
+        }
+        while (zeroSamples.size() * SAMPLE_RATE < zeros + wordZeros) {
+            unsigned k = static_cast<unsigned>(zeroSamples.size() * SAMPLE_RATE - zeros);
+            zeroSamples.push_back(w * 64 + selectInWord(zeroWord, k));
+        }
+        ones += wordOnes;
+        zeros += wordZeros;
+    }
+}
+
+void EliasFanoPlateSet::build(const std::vector<PlateRecord>& records) {
+    std::vector<PlateKey> keys;
+    keys.reserve(records.size());
+    for (const auto& rec : records) {
+        PlateKey key = PlateCodec::encode(rec.plate);
+        if (key != PlateCodec::INVALID_KEY) {
+            keys.push_back(key);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    build(keys);
+}
+
+std::uint64_t EliasFanoPlateSet::lowAt(size_t i) const {
+    if (lowWidth == 0) {
+        return 0;
+    }
+    size_t bit = i * lowWidth;
+    size_t word = bit >> 6;
+    unsigned shift = static_cast<unsigned>(bit & 63);
+    std::uint64_t v = low[word] >> shift;
+    if (shift + lowWidth > 64) {
+        v |= low[word + 1] << (64 - shift);
+    }
+    return v & lowMask;
+}
+
+size_t EliasFanoPlateSet::select1(size_t i) const {
+    size_t sample = i / SAMPLE_RATE;
+    size_t pos = oneSamples[sample];
+    size_t remaining = i - sample * SAMPLE_RATE;
+    
+    // 从采样位置所在字开始，屏蔽掉采样点之前的位
+    size_t w = pos >> 6;
+    std::uint64_t word = high[w] & (~static_cast<std::uint64_t>(0) << (pos & 63));
+    for (;;) {
+        unsigned c = popcount64(word);
+        if (remaining < c) {
+            return w * 64 + selectInWord(word, static_cast<unsigned>(remaining));
+        }
+        remaining -= c;
+        word = high[++w];
+    }
+}
+
+size_t EliasFanoPlateSet::select0(size_t i) const {
+    size_t sample = i / SAMPLE_RATE;
+    size_t pos = zeroSamples[sample];
+    size_t remaining = i - sample * SAMPLE_RATE;
+    
+    size_t w = pos >> 6;
+    std::uint64_t word = ~high[w] & (~static_cast<std::uint64_t>(0) << (pos & 63));
+    for (;;) {
+        unsigned c = popcount64(word);
+        if (remaining < c) {
+            return w * 64 + selectInWord(word, static_cast<unsigned>(remaining));
+        }
+        remaining -= c;
+        word = ~high[++w];
+    }
+}
+
+PlateKey EliasFanoPlateSet::select(size_t i) const {
+    std::uint64_t h = select1(i) - i;
+    return base + ((h << lowWidth) | lowAt(i));
+}
+
+size_t EliasFanoPlateSet::rank(PlateKey key) const {
+    if (count == 0 || key <= base) {
+        return 0;
+    }
+    key -= base;
+    std::uint64_t h = key >> lowWidth;
+    if (h > maxHigh) {
+        return count;
+    }
+    
+    // 高位为 h 的元素紧跟在第 h 个 0（从 1 计）之后
+    size_t pos = 0;
+    size_t index = 0;
+    if (h > 0) {
+        pos = select0(static_cast<size_t>(h - 1)) + 1;
+        index = pos - static_cast<size_t>(h);
+    }
+    
+    // 同一高位桶内按低位比较，桶内元素平均不超过 2 个
+    std::uint64_t target = key & lowMask;
+    while (pos < highLength && highBit(pos)) {
+        if (lowAt(index) >= target) {
+            return index;
+        }
+        pos++;
+        index++;
+    }
+    return index;
+}
+
+long long EliasFanoPlateSet::find(const std::string& plate) const {
+    PlateKey key = PlateCodec::encode(plate);
+    if (key == PlateCodec::INVALID_KEY) {
+        return -1;
+    }
+    size_t r = rank(key);
+    if (r < count && select(r) == key) {
+        return static_cast<long long>(r);
+    }
+    return -1;
+}
+
+std::pair<size_t, size_t> EliasFanoPlateSet::prefixRange(const std::string& prefix) const {
+    PlateKey lo = 0;
+    PlateKey hi = 0;
+    if (!PlateCodec::prefixRange(prefix, lo, hi)) {
+        return std::make_pair(static_cast<size_t>(0), static_cast<size_t>(0));
+    }
+    return std::make_pair(rank(lo), rank(hi));
+}
+
+size_t EliasFanoPlateSet::memoryBytes() const {
+    return sizeof(*this) +
+           (low.capacity() + high.capacity()) * sizeof(std::uint64_t) +
+           (oneSamples.capacity() + zeroSamples.capacity()) * sizeof(size_t);
+}
+
+EliasFanoPlateSet::Iterator::Iterator(const EliasFanoPlateSet* set, size_t index)
+    : set(set), index(index), pos(0) {
+    if (index < set->count) {
+        pos = set->select1(index);
+    }
+}
+
+bool EliasFanoPlateSet::Iterator::next(PlateKey& key) {
+    if (index >= set->count) {
+        return false;
+    }
+    
+    // 找到 pos 及之后的第一个 1
+    size_t w = pos >> 6;
+    std::uint64_t word = set->high[w] & (~static_cast<std::uint64_t>(0) << (pos & 63));
+    while (word == 0) {
+        word = set->high[++w];
+    }
+    pos = w * 64 + ctz64(word);
+    
+    std::uint64_t h = pos - index;
+    key = set->base + ((h << set->lowWidth) | set->lowAt(index));
+    pos++;
+    index++;
+    return true;
+}
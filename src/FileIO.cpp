@@ -1,160 +1,628 @@
 #include "../include/FileIO.h"
+#include "../include/MappedFile.h"
+#include "../include/MemoryTracker.h"
+#include "../include/Parallel.h"
+#include "../include/PlateBatch.h"
+#include "../include/PlateKey.h"
+#include "../include/Trace.h"
 #include "../include/Utils.h"
-#include <fstream>
 #include <iostream>
+#include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <iterator>
+#include <utility>
 
-// 文本格式加载：每行“车牌 城市 车主”
-static bool loadTextFile(const std::string& filename,
-                         std::vector<PlateRecord>& records) {
-    std::ifstream fin(filename);
-    if (!fin.is_open()) {
-        std::cerr << "无法打开文件：" << filename << std::endl;
-        return false;
-    }
+namespace {
+    // 指向映射缓冲区中的一段字符，不拥有内存
+    struct Slice {
+        const char* data;
+        size_t size;
+        
+        Slice() : data(nullptr), size(0) {}
+        Slice(const char* d, size_t n) : data(d), size(n) {}
+        bool empty() const { return size == 0; }
+    };
+    
+    const char* const DEFAULT_OWNER = "未知";
+    
+    // 保存时每块格式化的记录数，也是报告进度的粒度
+    const size_t WRITE_CHUNK = 1u << 16;
     
-    int count = 0;
-    std::string line;
-    while (std::getline(fin, line)) {
-        if (line.empty()) continue;
+    // 一段连续存放的记录：首行指针与行数
+    typedef std::pair<const PlateRecord*, size_t> RecordRun;
+    
+    // 把若干段记录依次格式化为“车牌 sep 城市 sep 车主 sep 类别\n”，覆盖 out
+    void formatRuns(const std::vector<RecordRun>& runs, char sep, std::string& out) {
+        size_t total = 0;
+        for (const auto& run : runs) {
+            for (size_t i = 0; i < run.second; ++i) {
+                const PlateRecord& r = run.first[i];
+                total += r.plate.size() + r.city.size() + r.owner.size() + r.category.size() + 4;
+            }
+        }
         
-        auto parts = Utils::split(line);
-        if (parts.size() < 2) continue;
+        // 缓冲区跨块复用，只在变大时重新分配
+        out.resize(total);
+        char* p = total > 0 ? &out[0] : nullptr;
+        for (const auto& run : runs) {
+            for (size_t i = 0; i < run.second; ++i) {
+                const PlateRecord& r = run.first[i];
+                std::memcpy(p, r.plate.data(), r.plate.size());
+                p += r.plate.size();
+                *p++ = sep;
+                std::memcpy(p, r.city.data(), r.city.size());
+                p += r.city.size();
+                *p++ = sep;
+                std::memcpy(p, r.owner.data(), r.owner.size());
+                p += r.owner.size();
+                *p++ = sep;
+                std::memcpy(p, r.category.data(), r.category.size());
+                p += r.category.size();
+                *p++ = '\n';
+            }
+        }
+    }
+    
+    // 写出全部记录；header 非空时先写表头
+    bool writeRecords(const std::string& filename, const std::vector<PlateRecord>& records,
+                      const char* header, char sep, const ProgressFn& progress,
+                      SaveReport* report, unsigned threads) {
+        return FileIO::writeChunks(filename, records.size(),
+            [&records, sep](size_t first, size_t last, std::string& out) {
+                std::vector<RecordRun> runs(1, RecordRun(records.data() + first, last - first));
+                formatRuns(runs, sep, out);
+            }, header, progress, report, threads);
+    }
+    
+    // 同上，逐块读取分块记录表，不拼接整表
+    bool writeRecords(const std::string& filename, const RecordTable& records,
+                      const char* header, char sep, const ProgressFn& progress,
+                      SaveReport* report, unsigned threads) {
+        return FileIO::writeChunks(filename, records.size(),
+            [&records, sep](size_t first, size_t last, std::string& out) {
+                std::vector<RecordRun> runs;
+                records.forEachRun(first, last, [&runs](const PlateRecord* rows, size_t n, size_t) {
+                    runs.push_back(RecordRun(rows, n));
+                });
+                formatRuns(runs, sep, out);
+            }, header, progress, report, threads);
+    }
+    
+    inline bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' ||
+               c == '\v' || c == '\f';
+    }
+    
+    // 去掉首尾空白
+    Slice trim(const char* b, const char* e) {
+        while (b < e && isBlank(*b)) ++b;
+        while (e > b && isBlank(*(e - 1))) --e;
+        return Slice(b, static_cast<size_t>(e - b));
+    }
+    
+    // 文本行：按空白切分，只取前 3 个字段，返回取到的字段数
+    size_t splitText(const char* b, const char* e, Slice* fields) {
+        size_t n = 0;
+        while (n < 3) {
+            while (b < e && isBlank(*b)) ++b;
+            if (b == e) break;
+            const char* start = b;
+            while (b < e && !isBlank(*b)) ++b;
+            fields[n++] = Slice(start, static_cast<size_t>(b - start));
+        }
+        return n;
+    }
+    
+    // CSV 行：按逗号切分并去掉各字段首尾空白，只取前 3 个字段
+    // 与 std::getline 逐字段读取的行为一致：行尾的逗号不产生额外的空字段
+    size_t splitCSV(const char* b, const char* e, Slice* fields) {
+        size_t n = 0;
+        while (b < e && n < 3) {
+            const char* comma = static_cast<const char*>(
+                std::memchr(b, ',', static_cast<size_t>(e - b)));
+            const char* cellEnd = comma ? comma : e;
+            fields[n++] = trim(b, cellEnd);
+            if (!comma) break;
+            b = comma + 1;
+        }
+        return n;
+    }
+    
+    // 车牌字母 -> 城市名，按字母直接查表，避免逐行构造字符串
+    struct CityTable {
+        std::string cityOf[26];
         
-        PlateRecord rec;
-        rec.plate = Utils::toUpperStr(parts[0]);
-        rec.city = parts[1];
-        rec.owner = (parts.size() >= 3) ? parts[2] : "未知";
+        CityTable() {
+            for (char c = 'A'; c <= 'Z'; ++c) {
+                cityOf[c - 'A'] = Utils::getCityByPlateLetter(c);
+            }
+        }
+    };
+    
+    // 与 Utils::validatePlateCityMatch 规则一致
+    bool cityMatches(char letter, const Slice& city) {
+        static const CityTable table;
+        const std::string& expected = table.cityOf[letter - 'A'];
+        return !expected.empty() && expected.size() == city.size &&
+               std::memcmp(expected.data(), city.data, city.size) == 0;
+    }
+    
+    // 每批向量化校验的行数
+    const size_t PARSE_BATCH = 256;
+    
+    // 已切分字段、等待整批校验车牌的一行
+    struct PendingLine {
+        Slice fields[3];
+        size_t count;
+        size_t lineNo;
+    };
+    
+    // 并行导入时各线程的私有记录缓冲，计入 MemoryTracker 的导入缓冲
+    typedef std::vector<PlateRecord, TrackingAllocator<PlateRecord, MemoryTracker::IMPORT> > ImportPart;
+    
+    // 整批校验车牌（原地规范化为大写），再把合法行生成记录
+    template <typename Records>
+    void flushPending(std::vector<PendingLine>& pending, PlateBatch& batch,
+                      Records& records, LoadReport& report) {
+        {
+            PLATE_TRACE_SCOPE_N("FileIO::validate", pending.size());
+            batch.classify();
+        }
         
-        if (!Utils::isValidPlate(rec.plate)) {
-            std::cout << "跳过非法车牌：" << rec.plate << std::endl;
-            continue;
+        PLATE_TRACE_SCOPE_N("FileIO::emit", pending.size());
+        for (size_t i = 0; i < pending.size(); ++i) {
+            const PendingLine& line = pending[i];
+            if (!batch.isValid(i)) {
+                report.addError(line.lineNo, line.fields[0].data, line.fields[0].size, "车牌格式非法");
+                continue;
+            }
+            
+            records.emplace_back();
+            PlateRecord& rec = records.back();
+            
+            // 规范化车牌长度不超过短字符串缓冲，无需额外分配
+            const char* plate = batch.plate(i);
+            rec.plate.assign(plate, batch.length(i));
+            rec.city.assign(line.fields[1].data, line.fields[1].size);
+            if (line.count >= 3 && !line.fields[2].empty()) {
+                rec.owner.assign(line.fields[2].data, line.fields[2].size);
+            } else {
+                rec.owner = DEFAULT_OWNER;
+            }
+            // 根据车牌推导车辆类别（油车/电车），忽略文件中潜在的不一致
+            rec.category = batch.isNewEnergy(i) ? "电车" : "油车";
+            report.imported++;
+            
+            // 车牌字母与城市不匹配的记录照常导入，仅计数（与手工录入允许确认后添加一致）
+            if (!cityMatches(plate[3], line.fields[1])) {
+                report.cityMismatches++;
+            }
         }
+        pending.clear();
+        batch.clear();
+    }
+    
+    // 解析缓冲区 [begin, end) 中的每一行，把合法记录直接追加到 records
+    // lineBase 为缓冲区首行之前的行数，用于错误报告中的行号
+    template <typename Records>
+    void parseBuffer(const char* begin, const char* end, bool csv,
+                     bool detectHeader, size_t lineBase,
+                     Records& records, LoadReport& report) {
+        PLATE_TRACE_SCOPE_N("FileIO::parse", end - begin);
+        size_t lineNo = lineBase;
+        const char* p = begin;
+        std::vector<PendingLine> pending;
+        pending.reserve(PARSE_BATCH);
+        PlateBatch batch(PARSE_BATCH);
         
-        // 根据车牌推导车辆类别（油车/电车）
-        rec.category = Utils::getPlateCategory(rec.plate);
+        while (p < end) {
+            // 切分一批行，再整批校验
+            {
+                PLATE_TRACE_SCOPE("FileIO::tokenize");
+                while (p < end && !batch.full()) {
+                    const char* nl = static_cast<const char*>(
+                        std::memchr(p, '\n', static_cast<size_t>(end - p)));
+                    const char* lineEnd = nl ? nl : end;
+                    const char* lineBegin = p;
+                    p = nl ? nl + 1 : end;
+                    ++lineNo;
+                    
+                    if (lineBegin == lineEnd) continue;
+                    
+                    PendingLine line;
+                    line.count = csv ? splitCSV(lineBegin, lineEnd, line.fields)
+                                     : splitText(lineBegin, lineEnd, line.fields);
+                    if (line.count < 2) continue;
+                    line.lineNo = lineNo;
+                    
+                    // 若是首行且第一列不是合法车牌，则视为表头直接跳过
+                    if (detectHeader) {
+                        detectHeader = false;
+                        if (PlateCodec::encode(line.fields[0].data, line.fields[0].size) ==
+                            PlateCodec::INVALID_KEY) {
+                            continue;
+                        }
+                    }
+                    
+                    pending.push_back(line);
+                    batch.add(line.fields[0].data, line.fields[0].size);
+                }
+            }
+            flushPending(pending, batch, records, report);
+        }
         
-        records.push_back(rec);
-        count++;
+        report.linesRead += lineNo - lineBase;
     }
     
-    fin.close();
-    std::cout << "从文本文件读取完成，成功导入 " << count << " 条记录。" << std::endl;
-    return true;
+    // 跳过 UTF-8 BOM
+    const char* skipBOM(const char* begin, const char* end) {
+        if (end - begin >= 3 &&
+            static_cast<unsigned char>(begin[0]) == 0xEF &&
+            static_cast<unsigned char>(begin[1]) == 0xBB &&
+            static_cast<unsigned char>(begin[2]) == 0xBF) {
+            return begin + 3;
+        }
+        return begin;
+    }
+    
+    bool isCSVName(const std::string& filename) {
+        std::string lowerName = filename;
+        std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(),
+                       [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+        return lowerName.size() >= 4 && lowerName.substr(lowerName.size() - 4) == ".csv";
+    }
 }
 
-// CSV 格式加载：支持带表头“车牌号,城市,车主”
-static bool loadCSVFile(const std::string& filename,
-                        std::vector<PlateRecord>& records) {
-    std::ifstream fin(filename);
-    if (!fin.is_open()) {
-        std::cerr << "无法打开CSV文件：" << filename << std::endl;
+void LoadReport::addError(size_t line, const char* text, size_t len, const char* reason) {
+    skipped++;
+    if (errors.size() < maxErrors) {
+        errors.emplace_back(line, std::string(text, len), reason);
+    }
+}
+
+std::string LoadReport::toString() const {
+    std::ostringstream oss;
+    oss << "========== 导入报告 ==========\n";
+    oss << "读取字节数：" << bytesRead << "\n";
+    oss << "读取行数：" << linesRead << "\n";
+    oss << "成功导入：" << imported << " 条\n";
+    oss << "跳过非法：" << skipped << " 条\n";
+    oss << "城市不匹配：" << cityMismatches << " 条\n";
+    oss << "耗时：" << std::fixed << std::setprecision(2) << timeMs << " 毫秒\n";
+    
+    if (!errors.empty()) {
+        oss << "\n【非法记录】\n";
+        for (const auto& err : errors) {
+            oss << "  第 " << err.line << " 行：" << err.text << "（" << err.reason << "）\n";
+        }
+        if (skipped > errors.size()) {
+            oss << "  ... 还有 " << (skipped - errors.size()) << " 条非法记录\n";
+        }
+    }
+    
+    oss << "=============================";
+    return oss.str();
+}
+
+// 文本格式每行“车牌 城市 车主”；CSV 格式支持带表头“车牌号,城市,车主”
+// threads > 1 时在换行处把文件切成若干块，各线程独立解析到私有缓冲后按块顺序拼接
+static bool loadMapped(const std::string& filename,
+                       std::vector<PlateRecord>& records,
+                       LoadReport* report, unsigned threads) {
+    // 根据扩展名自动判断文本/CSV
+    bool csv = isCSVName(filename);
+    
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::cerr << (csv ? "无法打开CSV文件：" : "无法打开文件：") << filename << std::endl;
         return false;
     }
     
-    int count = 0;
-    std::string line;
-    bool isFirstLine = true;
-    while (std::getline(fin, line)) {
-        if (line.empty()) continue;
-        
-        std::stringstream ss(line);
-        std::string cell;
-        std::vector<std::string> parts;
-        while (std::getline(ss, cell, ',')) {
-            // 去掉首尾空白
-            size_t start = cell.find_first_not_of(" \t\r\n");
-            size_t end = cell.find_last_not_of(" \t\r\n");
-            if (start == std::string::npos) {
-                parts.emplace_back("");
-            } else {
-                parts.emplace_back(cell.substr(start, end - start + 1));
-            }
+    LoadReport localReport;
+    LoadReport& rep = report ? *report : localReport;
+    size_t importedBefore = rep.imported;
+    size_t skippedBefore = rep.skipped;
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    const char* begin = skipBOM(file.begin(), file.end());
+    const char* end = file.end();
+    size_t bytes = static_cast<size_t>(end - begin);
+    
+    // 小文件不值得启动线程
+    const size_t MIN_CHUNK_BYTES = 1 << 20;
+    if (threads == 0) {
+        threads = Parallel::defaultThreads();
+    }
+    size_t chunkCount = std::min<size_t>(threads, bytes / MIN_CHUNK_BYTES + 1);
+    
+    if (chunkCount <= 1) {
+        // 先按换行数一次性预留空间，避免大文件导入过程中反复扩容
+        {
+            PLATE_TRACE_SCOPE_N("FileIO::reserve", bytes);
+            size_t lineCount = static_cast<size_t>(std::count(begin, end, '\n')) + 1;
+            records.reserve(records.size() + lineCount);
         }
-        
-        if (parts.size() < 2) continue;
-        
-        // 若是首行且第一列不是合法车牌，则视为表头直接跳过
-        if (isFirstLine) {
-            isFirstLine = false;
-            std::string possiblePlate = Utils::toUpperStr(parts[0]);
-            if (!Utils::isValidPlate(possiblePlate)) {
-                continue;
-            }
+        parseBuffer(begin, end, csv, csv, 0, records, rep);
+    } else {
+        // 按字节均分后把边界推到下一个换行之后，保证每块都由完整行组成
+        std::vector<const char*> bounds(chunkCount + 1);
+        bounds[0] = begin;
+        bounds[chunkCount] = end;
+        for (size_t i = 1; i < chunkCount; ++i) {
+            const char* p = std::max(begin + bytes / chunkCount * i, bounds[i - 1]);
+            const char* nl = static_cast<const char*>(
+                std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            bounds[i] = nl ? nl + 1 : end;
         }
         
-        PlateRecord rec;
-        rec.plate = Utils::toUpperStr(parts[0]);
-        rec.city = parts[1];
-        rec.owner = (parts.size() >= 3 && !parts[2].empty()) ? parts[2] : "未知";
+        std::vector<ImportPart> parts(chunkCount);
+        std::vector<LoadReport> partReports(chunkCount);
+        Parallel::forEach(chunkCount, [&](size_t i) {
+            const char* b = bounds[i];
+            const char* e = bounds[i + 1];
+            partReports[i].maxErrors = rep.maxErrors;
+            parts[i].reserve(static_cast<size_t>(std::count(b, e, '\n')) + 1);
+            // 只有第一块需要识别 CSV 表头
+            parseBuffer(b, e, csv, csv && i == 0, 0, parts[i], partReports[i]);
+        }, static_cast<unsigned>(chunkCount));
         
-        if (!Utils::isValidPlate(rec.plate)) {
-            std::cout << "跳过非法车牌：" << rec.plate << std::endl;
-            continue;
+        // 按块顺序拼接记录，并把块内行号换算为文件行号
+        PLATE_TRACE_SCOPE_N("FileIO::merge", chunkCount);
+        size_t total = 0;
+        for (const auto& part : parts) {
+            total += part.size();
         }
+        records.reserve(records.size() + total);
         
-        // 根据车牌推导车辆类别（油车/电车），忽略或纠正文件中潜在的不一致
-        rec.category = Utils::getPlateCategory(rec.plate);
-        
-        records.push_back(rec);
-        count++;
+        size_t lineBase = 0;
+        for (size_t i = 0; i < chunkCount; ++i) {
+            std::move(parts[i].begin(), parts[i].end(), std::back_inserter(records));
+            ImportPart().swap(parts[i]);
+            
+            const LoadReport& pr = partReports[i];
+            rep.imported += pr.imported;
+            rep.skipped += pr.skipped;
+            rep.cityMismatches += pr.cityMismatches;
+            for (const auto& err : pr.errors) {
+                if (rep.errors.size() >= rep.maxErrors) break;
+                rep.errors.emplace_back(lineBase + err.line, err.text, err.reason);
+            }
+            lineBase += pr.linesRead;
+        }
+        rep.linesRead += lineBase;
     }
     
-    fin.close();
-    std::cout << "从CSV文件读取完成，成功导入 " << count << " 条记录。" << std::endl;
+    auto finish = std::chrono::high_resolution_clock::now();
+    rep.bytesRead += file.size();
+    rep.timeMs += std::chrono::duration_cast<std::chrono::microseconds>(finish - start).count() / 1000.0;
+    
+    std::cout << "从" << (csv ? "CSV" : "文本") << "文件读取完成，成功导入 "
+              << (rep.imported - importedBefore) << " 条记录。" << std::endl;
+    if (rep.skipped > skippedBefore) {
+        std::cout << "跳过非法车牌 " << (rep.skipped - skippedBefore) << " 条。" << std::endl;
+    }
     return true;
 }
 
 bool FileIO::loadFromFile(const std::string& filename, 
-                         std::vector<PlateRecord>& records) {
-    // 根据扩展名自动判断文本/CSV
-    std::string lowerName = filename;
-    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(),
-                   [](unsigned char c){ return static_cast<char>(std::tolower(c)); });
+                         std::vector<PlateRecord>& records,
+                         LoadReport* report) {
+    return loadMapped(filename, records, report, 1);
+}
+
+bool FileIO::loadFromFileParallel(const std::string& filename,
+                                 std::vector<PlateRecord>& records,
+                                 LoadReport* report,
+                                 unsigned threads) {
+    return loadMapped(filename, records, report, threads);
+}
+
+bool FileIO::importStreaming(const std::string& filename,
+                            const ImportBatchFn& sink,
+                            const ImportProgressFn& progress,
+                            LoadReport* report,
+                            size_t batchRows) {
+    bool csv = isCSVName(filename);
     
-    if (lowerName.size() >= 4 && lowerName.substr(lowerName.size() - 4) == ".csv") {
-        return loadCSVFile(filename, records);
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::cerr << (csv ? "无法打开CSV文件：" : "无法打开文件：") << filename << std::endl;
+        return false;
     }
     
-    // 默认按文本格式处理
-    return loadTextFile(filename, records);
+    LoadReport localReport;
+    LoadReport& rep = report ? *report : localReport;
+    size_t importedBefore = rep.imported;
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    const char* begin = skipBOM(file.begin(), file.end());
+    const char* end = file.end();
+    if (batchRows == 0) {
+        batchRows = 1;
+    }
+    
+    std::vector<PlateRecord> batch;
+    batch.reserve(batchRows);
+    MemoryTracker::Hold batchHold(MemoryTracker::IMPORT, batch.capacity() * sizeof(PlateRecord));
+    size_t lineBase = 0;
+    size_t released = 0;
+    bool cancelled = false;
+    const char* p = begin;
+    
+    while (p < end && !cancelled) {
+        // 向后数 batchRows 个换行作为本批的结束位置
+        const char* batchEnd = p;
+        for (size_t i = 0; i < batchRows && batchEnd < end; ++i) {
+            const char* nl = static_cast<const char*>(
+                std::memchr(batchEnd, '\n', static_cast<size_t>(end - batchEnd)));
+            batchEnd = nl ? nl + 1 : end;
+        }
+        
+        size_t linesBefore = rep.linesRead;
+        batch.clear();
+        // 只有第一批需要识别 CSV 表头
+        parseBuffer(p, batchEnd, csv, csv && p == begin, lineBase, batch, rep);
+        batchHold.set(batch.capacity() * sizeof(PlateRecord));
+        lineBase += rep.linesRead - linesBefore;
+        p = batchEnd;
+        
+        if (!batch.empty() && !sink(batch)) {
+            cancelled = true;
+        }
+        
+        // 已解析的部分不会再访问，归还其映射页
+        size_t offset = static_cast<size_t>(p - file.begin());
+        file.release(released, offset - released);
+        released = offset;
+        
+        if (!cancelled && progress &&
+            !progress(offset, file.size(), rep.imported - importedBefore)) {
+            cancelled = true;
+        }
+    }
+    
+    auto finish = std::chrono::high_resolution_clock::now();
+    rep.bytesRead += static_cast<size_t>(p - file.begin());
+    rep.timeMs += std::chrono::duration_cast<std::chrono::microseconds>(finish - start).count() / 1000.0;
+    rep.cancelled = cancelled;
+    
+    if (cancelled) {
+        std::cout << "导入已取消：" << filename << std::endl;
+        return false;
+    }
+    std::cout << "从" << (csv ? "CSV" : "文本") << "文件读取完成，成功导入 "
+              << (rep.imported - importedBefore) << " 条记录。" << std::endl;
+    return true;
 }
 
-bool FileIO::saveToFile(const std::string& filename,
-                       const std::vector<PlateRecord>& records) {
-    std::ofstream fout(filename);
-    if (!fout.is_open()) {
+bool FileIO::writeChunks(const std::string& filename, size_t rows,
+                         const ChunkFormatFn& format, const char* header,
+                         const ProgressFn& progress, SaveReport* report,
+                         unsigned threads) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    std::FILE* out = std::fopen(filename.c_str(), "wb");
+    if (!out) {
         std::cerr << "无法创建文件：" << filename << std::endl;
         return false;
     }
+    // 数据已在自己的缓冲区中成块，关闭 stdio 缓冲，每块直接一次写入
+    std::setvbuf(out, nullptr, _IONBF, 0);
+    
+    const size_t n = rows;
+    if (threads == 0) {
+        threads = Parallel::defaultThreads();
+    }
+    size_t chunkCount = (n + WRITE_CHUNK - 1) / WRITE_CHUNK;
+    if (threads > chunkCount) {
+        threads = chunkCount == 0 ? 1 : static_cast<unsigned>(chunkCount);
+    }
     
-    for (const auto& rec : records) {
-        // 文本格式增加“类别”字段，位于车主之后
-        fout << rec.plate << " " << rec.city << " " << rec.owner << " " << rec.category << "\n";
+    size_t bytes = 0;
+    bool ok = true;
+    if (header) {
+        size_t len = std::strlen(header);
+        ok = std::fwrite(header, 1, len, out) == len;
+        bytes += len;
     }
     
-    fout.close();
+    // 每轮由 threads 个线程各格式化一块，再按块顺序写出
+    std::vector<std::string> buffers(threads);
+    const size_t roundSize = WRITE_CHUNK * threads;
+    for (size_t base = 0; ok && base < n; base += roundSize) {
+        size_t chunks = std::min<size_t>(threads, (n - base + WRITE_CHUNK - 1) / WRITE_CHUNK);
+        Parallel::forEach(chunks, [&](size_t c) {
+            size_t first = base + c * WRITE_CHUNK;
+            size_t last = std::min(first + WRITE_CHUNK, n);
+            PLATE_TRACE_SCOPE_N("FileIO::format", last - first);
+            format(first, last, buffers[c]);
+        }, threads);
+        
+        PLATE_TRACE_SCOPE_N("FileIO::write", chunks);
+        for (size_t c = 0; ok && c < chunks; ++c) {
+            const std::string& buf = buffers[c];
+            ok = std::fwrite(buf.data(), 1, buf.size(), out) == buf.size();
+            bytes += buf.size();
+        }
+        
+        size_t done = std::min(base + roundSize, n);
+        if (ok && progress && done < n && !progress(done, n)) {
+            std::fclose(out);
+            std::remove(filename.c_str());
+            return false;
+        }
+    }
+    
+    if (std::fclose(out) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        std::cerr << "写入文件失败：" << filename << std::endl;
+        return false;
+    }
+    if (progress) progress(n, n);
+    
+    if (report) {
+        auto endTime = std::chrono::high_resolution_clock::now();
+        report->records = n;
+        report->bytesWritten = bytes;
+        report->timeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    }
+    return true;
+}
+
+bool FileIO::saveToFile(const std::string& filename,
+                       const std::vector<PlateRecord>& records,
+                       const ProgressFn& progress,
+                       SaveReport* report,
+                       unsigned threads) {
+    // 文本格式增加“类别”字段，位于车主之后
+    if (!writeRecords(filename, records, nullptr, ' ', progress, report, threads)) {
+        return false;
+    }
     std::cout << "已保存 " << records.size() << " 条记录到文件：" << filename << std::endl;
     return true;
 }
 
 bool FileIO::exportToCSV(const std::string& filename,
-                        const std::vector<PlateRecord>& records) {
-    std::ofstream fout(filename);
-    if (!fout.is_open()) {
-        std::cerr << "无法创建文件：" << filename << std::endl;
+                        const std::vector<PlateRecord>& records,
+                        const ProgressFn& progress,
+                        SaveReport* report,
+                        unsigned threads) {
+    // 写入CSV头（增加“类别”列）
+    if (!writeRecords(filename, records, "车牌号,城市,车主,类别\n", ',', progress, report, threads)) {
         return false;
     }
-    
+    std::cout << "已导出 " << records.size() << " 条记录到CSV文件：" << filename << std::endl;
+    return true;
+}
+
+bool FileIO::saveToFile(const std::string& filename,
+                       const RecordTable& records,
+                       const ProgressFn& progress,
+                       SaveReport* report,
+                       unsigned threads) {
+    // 文本格式增加“类别”字段，位于车主之后
+    if (!writeRecords(filename, records, nullptr, ' ', progress, report, threads)) {
+        return false;
+    }
+    std::cout << "已保存 " << records.size() << " 条记录到文件：" << filename << std::endl;
+    return true;
+}
+
+bool FileIO::exportToCSV(const std::string& filename,
+                        const RecordTable& records,
+                        const ProgressFn& progress,
+                        SaveReport* report,
+                        unsigned threads) {
     // 写入CSV头（增加“类别”列）
-    fout << "车牌号,城市,车主,类别\n";
-    
-    for (const auto& rec : records) {
-        fout << rec.plate << "," << rec.city << "," << rec.owner << "," << rec.category << "\n";
+    if (!writeRecords(filename, records, "车牌号,城市,车主,类别\n", ',', progress, report, threads)) {
+        return false;
     }
-    
-    fout.close();
     std::cout << "已导出 " << records.size() << " 条记录到CSV文件：" << filename << std::endl;
     return true;
 }
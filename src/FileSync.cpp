@@ -0,0 +1,68 @@
+#include "../include/FileSync.h"
+#include <iostream>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#if defined(__unix__) || defined(__APPLE__)
+    bool syncPath(const std::string& path, int flags) {
+        int fd = ::open(path.c_str(), flags);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = ::fsync(fd) == 0;
+        return ::close(fd) == 0 && ok;
+    }
+#endif
+}
+
+bool FileSync::syncFile(const std::string& filename) {
+#if defined(__unix__) || defined(__APPLE__)
+    return syncPath(filename, O_RDONLY);
+#else
+    (void)filename;
+    return true;
+#endif
+}
+
+bool FileSync::syncParentDirectory(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? std::string(".")
+                    : slash == 0 ? std::string("/")
+                    : path.substr(0, slash);
+    return syncPath(dir, O_RDONLY | O_DIRECTORY);
+#else
+    // 其他平台的改名由文件系统自行保证
+    (void)path;
+    return true;
+#endif
+}
+
+bool FileSync::commitReplace(const std::string& tmpName, const std::string& filename) {
+    if (!syncFile(tmpName)) {
+        std::cerr << "文件落盘失败：" << tmpName << std::endl;
+        std::remove(tmpName.c_str());
+        return false;
+    }
+    
+#ifdef _WIN32
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(tmpName.c_str(), filename.c_str()) != 0) {
+        std::cerr << "无法替换文件：" << filename << std::endl;
+        std::remove(tmpName.c_str());
+        return false;
+    }
+    
+    // 改名只有在目录落盘后才不会因崩溃而回退
+    if (!syncParentDirectory(filename)) {
+        std::cerr << "目录落盘失败：" << filename << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,113 @@
+#include "../include/MappedFile.h"
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PLATE_HAVE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : base(nullptr), length(0), opened(false), mapped(false) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filename, bool sequential) {
+    close();
+    
+#ifdef PLATE_HAVE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    length = static_cast<size_t>(st.st_size);
+    if (length == 0) {
+        // 空文件无法映射，视为空缓冲
+        ::close(fd);
+        base = "";
+        opened = true;
+        return true;
+    }
+    
+    void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // 映射建立后即可关闭描述符
+    if (p == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+    
+    if (sequential) {
+        ::madvise(p, length, MADV_SEQUENTIAL);
+    }
+    
+    base = static_cast<const char*>(p);
+    mapped = true;
+    opened = true;
+    return true;
+#else
+    (void)sequential;
+    std::ifstream fin(filename, std::ios::binary | std::ios::ate);
+    if (!fin.is_open()) {
+        return false;
+    }
+    
+    std::streamsize n = fin.tellg();
+    fin.seekg(0, std::ios::beg);
+    buffer.resize(static_cast<size_t>(n));
+    if (n > 0 && !fin.read(buffer.data(), n)) {
+        buffer.clear();
+        return false;
+    }
+    
+    base = buffer.empty() ? "" : buffer.data();
+    length = buffer.size();
+    opened = true;
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifdef PLATE_HAVE_MMAP
+    if (mapped) {
+        ::munmap(const_cast<char*>(base), length);
+    }
+#endif
+    std::vector<char>().swap(buffer);
+    base = nullptr;
+    length = 0;
+    opened = false;
+    mapped = false;
+}
+
+void MappedFile::release(size_t offset, size_t len) {
+#ifdef PLATE_HAVE_MMAP
+    if (!mapped || offset >= length) {
+        return;
+    }
+    if (len > length - offset) {
+        len = length - offset;
+    }
+    // 只回收完全落在范围内的整页
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t first = (offset + page - 1) / page * page;
+    size_t last = (offset + len) / page * page;
+    if (last > first) {
+        ::madvise(const_cast<char*>(base) + first, last - first, MADV_DONTNEED);
+    }
+#else
+    (void)offset;
+    (void)len;
+#endif
+}
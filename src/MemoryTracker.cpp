@@ -0,0 +1,82 @@
+#include "../include/MemoryTracker.h"
+#include <atomic>
+#include <cstdio>
+
+namespace {
+    std::atomic<size_t> currentBytes[MemoryTracker::CATEGORY_COUNT];
+    std::atomic<size_t> peakBytes[MemoryTracker::CATEGORY_COUNT];
+    std::atomic<size_t> totalBytes(0);
+    std::atomic<size_t> totalPeakBytes(0);
+    
+    // 把 peak 提升到不小于 now
+    void raise(std::atomic<size_t>& peak, size_t now) {
+        size_t seen = peak.load(std::memory_order_relaxed);
+        while (now > seen &&
+               !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {
+        }
+    }
+    
+    const char* const CATEGORY_LABELS[MemoryTracker::CATEGORY_COUNT] = {
+        "排序缓冲", "导入缓冲", "验证缓冲", "整表改写副本"
+    };
+    
+    const char* const CATEGORY_NAMES[MemoryTracker::CATEGORY_COUNT] = {
+        "sort", "import", "validate", "rewrite"
+    };
+}
+
+const char* MemoryTracker::label(Category c) {
+    return CATEGORY_LABELS[c];
+}
+
+const char* MemoryTracker::name(Category c) {
+    return CATEGORY_NAMES[c];
+}
+
+void MemoryTracker::allocated(Category c, size_t bytes) {
+    raise(peakBytes[c], currentBytes[c].fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    raise(totalPeakBytes, totalBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void MemoryTracker::released(Category c, size_t bytes) {
+    currentBytes[c].fetch_sub(bytes, std::memory_order_relaxed);
+    totalBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::current(Category c) {
+    return currentBytes[c].load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::peak(Category c) {
+    return peakBytes[c].load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::totalCurrent() {
+    return totalBytes.load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::totalPeak() {
+    return totalPeakBytes.load(std::memory_order_relaxed);
+}
+
+std::string MemoryTracker::formatBytes(double bytes) {
+    char buf[32];
+    if (bytes < 1024.0) {
+        std::snprintf(buf, sizeof(buf), "%.0f B", bytes);
+    } else if (bytes < 1024.0 * 1024) {
+        std::snprintf(buf, sizeof(buf), "%.1f KB", bytes / 1024);
+    } else if (bytes < 1024.0 * 1024 * 1024) {
+        std::snprintf(buf, sizeof(buf), "%.1f MB", bytes / (1024.0 * 1024));
+    } else {
+        std::snprintf(buf, sizeof(buf), "%.2f GB", bytes / (1024.0 * 1024 * 1024));
+    }
+    return buf;
+}
+
+void MemoryTracker::resetPeaks() {
+    for (size_t c = 0; c < CATEGORY_COUNT; ++c) {
+        peakBytes[c].store(currentBytes[c].load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+    }
+    totalPeakBytes.store(totalBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
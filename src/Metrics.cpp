@@ -0,0 +1,285 @@
+#include "../include/Metrics.h"
+#include <cstdio>
+
+namespace {
+    const std::uint64_t SUB_COUNT = 1u << LatencyHistogram::SUB_BITS;
+    const std::uint64_t MAX_VALUE = (static_cast<std::uint64_t>(1) << LatencyHistogram::MAX_BITS) - 1;
+    
+    // 最高有效位的位置（value > 0）
+    inline unsigned highestBit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+    
+    // 每个线程固定写一个分片，按首次使用顺序轮流分配
+    unsigned shardIndex() {
+        static std::atomic<unsigned> nextShard(0);
+        static thread_local unsigned index = nextShard.fetch_add(1) % Metrics::SHARD_COUNT;
+        return index;
+    }
+    
+    // 每线程、每操作的调用计数，用于抽样计时
+    thread_local unsigned sampleTicks[Metrics::OPERATION_COUNT];
+    
+    const char* const OPERATION_NAMES[Metrics::OPERATION_COUNT] = {
+        "find", "prefix", "city", "sort", "import", "save", "validate"
+    };
+    
+    const char* const OPERATION_LABELS[Metrics::OPERATION_COUNT] = {
+        "精确查找", "前缀查找", "城市查找", "排序", "导入", "保存", "数据验证"
+    };
+    
+    // 精确查找每次只需数百纳秒，两次读时钟的开销不可忽略，默认每 16 次计时一次
+    const unsigned DEFAULT_FIND_INTERVAL = 16;
+    
+    void updateMax(std::atomic<std::uint64_t>& target, std::uint64_t value) {
+        std::uint64_t seen = target.load(std::memory_order_relaxed);
+        while (value > seen &&
+               !target.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+LatencyHistogram::LatencyHistogram() : total(0) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = 0;
+    }
+}
+
+size_t LatencyHistogram::bucketOf(std::uint64_t nanos) {
+    if (nanos < 2 * SUB_COUNT) {
+        return static_cast<size_t>(nanos);
+    }
+    if (nanos > MAX_VALUE) {
+        nanos = MAX_VALUE;
+    }
+    // 2^b 到 2^(b+1) 之间按高 SUB_BITS+1 位分格
+    unsigned shift = highestBit(nanos) - SUB_BITS;
+    return static_cast<size_t>(shift * SUB_COUNT + (nanos >> shift));
+}
+
+std::uint64_t LatencyHistogram::lowerBound(size_t index) {
+    if (index < 2 * SUB_COUNT) {
+        return index;
+    }
+    std::uint64_t shift = index / SUB_COUNT - 1;
+    std::uint64_t mantissa = index - shift * SUB_COUNT;
+    return mantissa << shift;
+}
+
+std::uint64_t LatencyHistogram::upperBound(size_t index) {
+    if (index < 2 * SUB_COUNT) {
+        return index + 1;
+    }
+    std::uint64_t shift = index / SUB_COUNT - 1;
+    std::uint64_t mantissa = index - shift * SUB_COUNT;
+    return (mantissa + 1) << shift;
+}
+
+void LatencyHistogram::add(size_t index, std::uint64_t count) {
+    counts[index] += count;
+    total += count;
+}
+
+std::uint64_t LatencyHistogram::countAtMost(std::uint64_t nanos) const {
+    std::uint64_t sum = 0;
+    for (size_t i = 0; i < BUCKET_COUNT && upperBound(i) <= nanos + 1; ++i) {
+        sum += counts[i];
+    }
+    return sum;
+}
+
+double LatencyHistogram::percentile(double q) const {
+    if (total == 0) {
+        return 0.0;
+    }
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    // 第 rank 个样本（从 1 开始）所在的格
+    std::uint64_t rank = static_cast<std::uint64_t>(q * total + 0.5);
+    if (rank == 0) rank = 1;
+    std::uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return (lowerBound(i) + upperBound(i) - 1) / 2.0;
+        }
+    }
+    return static_cast<double>(MAX_VALUE);
+}
+
+void Metrics::Counters::clear() {
+    calls.store(0, std::memory_order_relaxed);
+    items.store(0, std::memory_order_relaxed);
+    samples.store(0, std::memory_order_relaxed);
+    sampledItems.store(0, std::memory_order_relaxed);
+    bytes.store(0, std::memory_order_relaxed);
+    sampledBytes.store(0, std::memory_order_relaxed);
+    totalNanos.store(0, std::memory_order_relaxed);
+    maxNanos.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+Metrics::Shard::Shard() {
+    for (size_t op = 0; op < OPERATION_COUNT; ++op) {
+        ops[op].clear();
+    }
+}
+
+Metrics::Metrics() {
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        shards[s].store(nullptr);
+    }
+    for (size_t op = 0; op < OPERATION_COUNT; ++op) {
+        intervals[op].store(op == OP_FIND ? DEFAULT_FIND_INTERVAL : 1);
+    }
+}
+
+Metrics::~Metrics() {
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        delete shards[s].load();
+    }
+}
+
+const char* Metrics::operationName(Operation op) {
+    return OPERATION_NAMES[op];
+}
+
+const char* Metrics::operationLabel(Operation op) {
+    return OPERATION_LABELS[op];
+}
+
+void Metrics::setSampleInterval(Operation op, unsigned every) {
+    intervals[op].store(every == 0 ? 1 : every, std::memory_order_relaxed);
+}
+
+unsigned Metrics::sampleInterval(Operation op) const {
+    return intervals[op].load(std::memory_order_relaxed);
+}
+
+bool Metrics::shouldSample(Operation op) const {
+    unsigned every = intervals[op].load(std::memory_order_relaxed);
+    return every <= 1 || sampleTicks[op]++ % every == 0;
+}
+
+Metrics::Counters& Metrics::local(Operation op) {
+    std::atomic<Shard*>& slot = shards[shardIndex()];
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (!shard) {
+        // 多个线程同时分配同一分片时只保留一个
+        Shard* fresh = new Shard();
+        if (slot.compare_exchange_strong(shard, fresh, std::memory_order_acq_rel)) {
+            shard = fresh;
+        } else {
+            delete fresh;
+        }
+    }
+    return shard->ops[op];
+}
+
+void Metrics::record(Operation op, std::uint64_t nanos, std::uint64_t items,
+                     std::uint64_t bytes) {
+    Counters& c = local(op);
+    c.calls.fetch_add(1, std::memory_order_relaxed);
+    c.items.fetch_add(items, std::memory_order_relaxed);
+    c.samples.fetch_add(1, std::memory_order_relaxed);
+    c.sampledItems.fetch_add(items, std::memory_order_relaxed);
+    if (bytes) {
+        c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        c.sampledBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    c.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+    c.buckets[LatencyHistogram::bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+    updateMax(c.maxNanos, nanos);
+}
+
+void Metrics::count(Operation op, std::uint64_t items, std::uint64_t bytes) {
+    Counters& c = local(op);
+    c.calls.fetch_add(1, std::memory_order_relaxed);
+    c.items.fetch_add(items, std::memory_order_relaxed);
+    if (bytes) {
+        c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+OperationStats Metrics::stats(Operation op) const {
+    OperationStats out;
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        const Shard* shard = shards[s].load(std::memory_order_acquire);
+        if (!shard) {
+            continue;
+        }
+        const Counters& c = shard->ops[op];
+        out.calls += c.calls.load(std::memory_order_relaxed);
+        out.items += c.items.load(std::memory_order_relaxed);
+        out.samples += c.samples.load(std::memory_order_relaxed);
+        out.sampledItems += c.sampledItems.load(std::memory_order_relaxed);
+        out.bytes += c.bytes.load(std::memory_order_relaxed);
+        out.sampledBytes += c.sampledBytes.load(std::memory_order_relaxed);
+        out.totalNanos += c.totalNanos.load(std::memory_order_relaxed);
+        std::uint64_t m = c.maxNanos.load(std::memory_order_relaxed);
+        if (m > out.maxNanos) {
+            out.maxNanos = m;
+        }
+        for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+            std::uint64_t n = c.buckets[i].load(std::memory_order_relaxed);
+            if (n) {
+                out.histogram.add(i, n);
+            }
+        }
+    }
+    return out;
+}
+
+void Metrics::reset() {
+    for (size_t s = 0; s < SHARD_COUNT; ++s) {
+        Shard* shard = shards[s].load(std::memory_order_acquire);
+        if (!shard) {
+            continue;
+        }
+        for (size_t op = 0; op < OPERATION_COUNT; ++op) {
+            shard->ops[op].clear();
+        }
+    }
+}
+
+std::string Metrics::formatNanos(double nanos) {
+    char buf[32];
+    if (nanos < 1e3) {
+        std::snprintf(buf, sizeof(buf), "%.0f ns", nanos);
+    } else if (nanos < 1e6) {
+        std::snprintf(buf, sizeof(buf), "%.2f µs", nanos / 1e3);
+    } else if (nanos < 1e9) {
+        std::snprintf(buf, sizeof(buf), "%.2f ms", nanos / 1e6);
+    } else {
+        std::snprintf(buf, sizeof(buf), "%.2f s", nanos / 1e9);
+    }
+    return buf;
+}
+
+Metrics::Timer::Timer(Metrics& m, Operation o, std::uint64_t n)
+    : metrics(m), op(o), items(n), bytes(0), sampled(m.shouldSample(o)) {
+    if (sampled) {
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+Metrics::Timer::~Timer() {
+    if (sampled) {
+        std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+        metrics.record(op, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            items, bytes);
+    } else {
+        metrics.count(op, items, bytes);
+    }
+}
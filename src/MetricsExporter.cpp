@@ -0,0 +1,390 @@
+#include "../include/MetricsExporter.h"
+#include "../include/PlateDatabase.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PLATE_HAVE_SOCKETS 1
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // 直方图的 le 边界（秒），覆盖单次查找到大批量导入
+    const double LATENCY_BOUNDS[] = {
+        1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4,
+        1e-3, 2.5e-3, 5e-3, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5,
+        1, 2.5, 5, 10, 30, 60
+    };
+    
+    // HTTP 线程检查停止标志的间隔
+    const int POLL_INTERVAL_MS = 200;
+    
+    // 请求头最大长度，超过即断开
+    const size_t MAX_REQUEST_BYTES = 8192;
+    
+    std::string formatDouble(double value) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.9g", value);
+        return buf;
+    }
+    
+    void writeHeader(std::ostringstream& out, const char* name, const char* type, const char* help) {
+        out << "# HELP " << name << ' ' << help << '\n';
+        out << "# TYPE " << name << ' ' << type << '\n';
+    }
+    
+    void writeGauge(std::ostringstream& out, const char* name, const char* help, double value) {
+        writeHeader(out, name, "gauge", help);
+        out << name << ' ' << formatDouble(value) << '\n';
+    }
+    
+    // 进程常驻内存（字节），无法获取时返回 -1
+    long long residentBytes() {
+#if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        long long pages = 0, resident = 0;
+        if (statm >> pages >> resident) {
+            return resident * static_cast<long long>(sysconf(_SC_PAGESIZE));
+        }
+#endif
+        return -1;
+    }
+
+#ifdef PLATE_HAVE_SOCKETS
+#ifdef MSG_NOSIGNAL
+    const int SEND_FLAGS = MSG_NOSIGNAL;    // 客户端提前断开时不触发 SIGPIPE
+#else
+    const int SEND_FLAGS = 0;
+#endif
+
+    bool sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, SEND_FLAGS);
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+#endif
+}
+
+MetricsExporter::MetricsExporter(const PlateDatabase& db)
+    : database(db), cachedVersion(0), cachedCities(-1), stopping(false),
+      fileInterval(0), listenFd(-1), boundPort(0) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+std::string MetricsExporter::render() {
+    std::lock_guard<std::mutex> lock(renderMutex);
+    SnapshotPtr snap = database.snapshot();
+    
+    // 内存中未建索引的数据统计城市数需要扫描全部记录，只在快照变化后重新统计；
+    // 已建索引或映射快照时 getCityCount 直接取索引块数或城市字典条目数
+    if (cachedCities < 0 || cachedVersion != snap->version) {
+        cachedCities = database.getCityCount();
+        cachedVersion = snap->version;
+    }
+    
+    std::ostringstream out;
+    writeGauge(out, "plate_records", "当前记录数", static_cast<double>(snap->size()));
+    writeGauge(out, "plate_cities", "当前城市数", static_cast<double>(cachedCities));
+    writeGauge(out, "plate_sorted", "是否已按车牌排序（1 是 0 否）", snap->sortedByPlate ? 1 : 0);
+    writeGauge(out, "plate_city_index_built", "城市分块索引是否已建立（1 是 0 否）",
+               snap->cityIndexBuilt ? 1 : 0);
+    writeGauge(out, "plate_snapshot_version", "当前快照版本", static_cast<double>(snap->version));
+    // isDurable 读取无锁标志，抓取指标不会等待写锁
+    writeGauge(out, "plate_durable", "是否启用预写日志（1 是 0 否）", database.isDurable() ? 1 : 0);
+    
+    long long rss = residentBytes();
+    if (rss >= 0) {
+        writeGauge(out, "process_resident_memory_bytes", "进程常驻内存（字节）",
+                   static_cast<double>(rss));
+    }
+    
+    // 各组成部分与 memoryUsage 的明细一一对应，各项之和即常驻合计加上临时缓冲
+    MemoryUsage usage = database.memoryUsage();
+    const std::pair<const char*, size_t> components[] = {
+        std::make_pair("records", usage.records),
+        std::make_pair("strings", usage.stringHeap),
+        std::make_pair("city_index", usage.cityIndex),
+        std::make_pair("key_index", usage.keyIndex),
+        std::make_pair("plate_index", usage.plateIndex),
+        std::make_pair("occupancy", usage.occupancy),
+        std::make_pair("changes", usage.changeTracking),
+        std::make_pair("wal", usage.walBuffer)
+    };
+    writeHeader(out, "plate_memory_bytes", "gauge",
+                "各组成部分占用的内存字节数（sort / import / validate / rewrite 为临时缓冲）");
+    for (const auto& c : components) {
+        out << "plate_memory_bytes{component=\"" << c.first << "\"} " << c.second << '\n';
+    }
+    for (size_t c = 0; c < MemoryTracker::CATEGORY_COUNT; ++c) {
+        out << "plate_memory_bytes{component=\"" << MemoryTracker::name(static_cast<MemoryTracker::Category>(c))
+            << "\"} " << usage.transientCurrent[c] << '\n';
+    }
+    writeHeader(out, "plate_memory_peak_bytes", "gauge",
+                "临时缓冲的峰值字节数（transient 为各类同时占用之和的峰值）");
+    for (size_t c = 0; c < MemoryTracker::CATEGORY_COUNT; ++c) {
+        out << "plate_memory_peak_bytes{component=\"" << MemoryTracker::name(static_cast<MemoryTracker::Category>(c))
+            << "\"} " << usage.transientPeak[c] << '\n';
+    }
+    out << "plate_memory_peak_bytes{component=\"transient\"} " << usage.transientPeakTotal << '\n';
+    writeGauge(out, "plate_memory_observed_peak_bytes", "观测到的内存最高水位（常驻合计 + 临时缓冲同时占用峰值）",
+               static_cast<double>(usage.observedPeak()));
+    writeGauge(out, "plate_mapped_file_bytes", "映射的列式快照文件大小（按需调页，不计入常驻）",
+               static_cast<double>(usage.mappedFile));
+    
+    const Metrics& metrics = database.operationMetrics();
+    OperationStats stats[Metrics::OPERATION_COUNT];
+    for (int op = 0; op < Metrics::OPERATION_COUNT; ++op) {
+        stats[op] = metrics.stats(static_cast<Metrics::Operation>(op));
+    }
+    
+    writeHeader(out, "plate_operation_calls_total", "counter", "各操作调用次数");
+    for (int op = 0; op < Metrics::OPERATION_COUNT; ++op) {
+        out << "plate_operation_calls_total{op=\"" << Metrics::operationName(static_cast<Metrics::Operation>(op))
+            << "\"} " << stats[op].calls << '\n';
+    }
+    
+    writeHeader(out, "plate_operation_items_total", "counter",
+                "各操作处理的条目数（查找为次数，排序 / 导入 / 保存 / 验证为记录数）");
+    for (int op = 0; op < Metrics::OPERATION_COUNT; ++op) {
+        out << "plate_operation_items_total{op=\"" << Metrics::operationName(static_cast<Metrics::Operation>(op))
+            << "\"} " << stats[op].items << '\n';
+    }
+    
+    writeHeader(out, "plate_operation_bytes_total", "counter", "各操作写出的字节数（保存 / 导出）");
+    for (int op = 0; op < Metrics::OPERATION_COUNT; ++op) {
+        out << "plate_operation_bytes_total{op=\"" << Metrics::operationName(static_cast<Metrics::Operation>(op))
+            << "\"} " << stats[op].bytes << '\n';
+    }
+    
+    writeHeader(out, "plate_operation_throughput", "gauge", "计时期间每秒处理的条目数");
+    for (int op = 0; op < Metrics::OPERATION_COUNT; ++op) {
+        out << "plate_operation_throughput{op=\"" << Metrics::operationName(static_cast<Metrics::Operation>(op))
+            << "\"} " << formatDouble(stats[op].throughput()) << '\n';
+    }
+    
+    writeHeader(out, "plate_operation_duration_seconds", "histogram",
+                "各操作耗时（按采样计时，_count 为样本数）");
+    for (int op = 0; op < Metrics::OPERATION_COUNT; ++op) {
+        const char* name = Metrics::operationName(static_cast<Metrics::Operation>(op));
+        const LatencyHistogram& h = stats[op].histogram;
+        // 一次顺序累加各格得到全部 le 边界的累计数，+Inf 与 _count 取同一直方图的总数，
+        // 不与单独累计的样本计数混用，保证各行彼此一致
+        std::uint64_t cumulative = 0;
+        size_t b = 0;
+        for (size_t i = 0; i < sizeof(LATENCY_BOUNDS) / sizeof(LATENCY_BOUNDS[0]); ++i) {
+            std::uint64_t nanos = static_cast<std::uint64_t>(LATENCY_BOUNDS[i] * 1e9 + 0.5);
+            for (; b < LatencyHistogram::BUCKET_COUNT && LatencyHistogram::upperBound(b) <= nanos + 1; ++b) {
+                cumulative += h.bucket(b);
+            }
+            out << "plate_operation_duration_seconds_bucket{op=\"" << name << "\",le=\""
+                << formatDouble(LATENCY_BOUNDS[i]) << "\"} " << cumulative << '\n';
+        }
+        out << "plate_operation_duration_seconds_bucket{op=\"" << name << "\",le=\"+Inf\"} "
+            << h.count() << '\n';
+        out << "plate_operation_duration_seconds_sum{op=\"" << name << "\"} "
+            << formatDouble(stats[op].totalNanos / 1e9) << '\n';
+        out << "plate_operation_duration_seconds_count{op=\"" << name << "\"} " << h.count() << '\n';
+    }
+    
+    return out.str();
+}
+
+bool MetricsExporter::writeFile() {
+    std::string body = render();
+    std::string tmpName = filePath + ".tmp";
+    {
+        std::ofstream fout(tmpName.c_str(), std::ios::binary | std::ios::trunc);
+        if (!fout) {
+            std::cerr << "无法写入指标文件：" << tmpName << std::endl;
+            return false;
+        }
+        fout << body;
+        if (!fout) {
+            std::cerr << "无法写入指标文件：" << tmpName << std::endl;
+            std::remove(tmpName.c_str());
+            return false;
+        }
+    }
+#ifdef _WIN32
+    std::remove(filePath.c_str());
+#endif
+    if (std::rename(tmpName.c_str(), filePath.c_str()) != 0) {
+        std::cerr << "无法替换指标文件：" << filePath << std::endl;
+        std::remove(tmpName.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool MetricsExporter::startFileExport(const std::string& path, unsigned intervalMs) {
+    if (fileThread.joinable()) {
+        return false;
+    }
+    filePath = path;
+    fileInterval = intervalMs == 0 ? 1 : intervalMs;
+    stopping = false;
+    bool ok = writeFile();
+    fileThread = std::thread(&MetricsExporter::fileLoop, this);
+    return ok;
+}
+
+void MetricsExporter::fileLoop() {
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (!stopping) {
+        stopSignal.wait_for(lock, std::chrono::milliseconds(fileInterval));
+        if (stopping) {
+            break;
+        }
+        lock.unlock();
+        writeFile();
+        lock.lock();
+    }
+}
+
+bool MetricsExporter::startHttp(unsigned short port) {
+#ifdef PLATE_HAVE_SOCKETS
+    if (httpThread.joinable()) {
+        return false;
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "无法创建指标端点套接字" << std::endl;
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, 16) != 0) {
+        std::cerr << "无法监听指标端点 127.0.0.1:" << port << std::endl;
+        ::close(fd);
+        return false;
+    }
+    
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    boundPort = ntohs(addr.sin_port);
+    listenFd = fd;
+    stopping = false;
+    httpThread = std::thread(&MetricsExporter::httpLoop, this);
+    return true;
+#else
+    (void)port;
+    std::cerr << "当前平台不支持指标 HTTP 端点" << std::endl;
+    return false;
+#endif
+}
+
+void MetricsExporter::httpLoop() {
+#ifdef PLATE_HAVE_SOCKETS
+    while (!stopping) {
+        pollfd pfd;
+        pfd.fd = listenFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (::poll(&pfd, 1, POLL_INTERVAL_MS) <= 0) {
+            continue;
+        }
+        int client = ::accept(listenFd, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        serveClient(client);
+        ::close(client);
+    }
+#endif
+}
+
+void MetricsExporter::serveClient(int client) {
+#ifdef PLATE_HAVE_SOCKETS
+    // 读取请求头（慢客户端最多等待 2 秒，避免卡住导出线程）
+    timeval timeout;
+    timeout.tv_sec = 2;
+    timeout.tv_usec = 0;
+    ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES) {
+        ssize_t n = ::recv(client, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            break;
+        }
+        request.append(buf, static_cast<size_t>(n));
+    }
+    
+    std::string line = request.substr(0, request.find("\r\n"));
+    std::string status = "200 OK";
+    std::string body;
+    std::string contentType = "text/plain; version=0.0.4; charset=utf-8";
+    if (line.compare(0, 4, "GET ") != 0) {
+        status = "405 Method Not Allowed";
+        body = "only GET is supported\n";
+        contentType = "text/plain; charset=utf-8";
+    } else {
+        std::string target = line.substr(4, line.find(' ', 4) - 4);
+        if (target == "/metrics" || target == "/") {
+            body = render();
+        } else {
+            status = "404 Not Found";
+            body = "try /metrics\n";
+            contentType = "text/plain; charset=utf-8";
+        }
+    }
+    
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: " << contentType << "\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    sendAll(client, response.str());
+#else
+    (void)client;
+#endif
+}
+
+void MetricsExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopSignal.notify_all();
+    if (fileThread.joinable()) {
+        fileThread.join();
+    }
+    if (httpThread.joinable()) {
+        httpThread.join();
+    }
+#ifdef PLATE_HAVE_SOCKETS
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        listenFd = -1;
+    }
+#endif
+    boundPort = 0;
+}
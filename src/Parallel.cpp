@@ -0,0 +1,138 @@
+#include "../include/Parallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    // 一次 run 调用对应的一批任务
+    struct Job {
+        const std::function<void(size_t)>* task;
+        size_t count;
+        std::atomic<size_t> next;       // 下一个待领取的任务编号
+        std::atomic<size_t> done;       // 已完成的任务数
+        unsigned helpers;               // 还可加入的工作线程数（受线程池锁保护）
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;       // 第一个异常
+        
+        Job(const std::function<void(size_t)>& t, size_t n, unsigned h)
+            : task(&t), count(n), next(0), done(0), helpers(h) {}
+        
+        // 领取并执行任务，直到没有剩余编号
+        void work() {
+            size_t i;
+            while ((i = next.fetch_add(1)) < count) {
+                try {
+                    (*task)(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) error = std::current_exception();
+                }
+                if (done.fetch_add(1) + 1 == count) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+    };
+    
+    // 常驻线程池：线程按需增加，进程退出时统一回收
+    class Pool {
+    public:
+        Pool() : stopping(false) {}
+        
+        ~Pool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& w : workers) {
+                w.join();
+            }
+        }
+        
+        void run(size_t count, const std::function<void(size_t)>& task, unsigned threads) {
+            std::shared_ptr<Job> job = std::make_shared<Job>(task, count, threads - 1);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                while (workers.size() < threads - 1) {
+                    workers.emplace_back([this]() { loop(); });
+                }
+                jobs.push_back(job);
+            }
+            wake.notify_all();
+            
+            // 调用线程自己也领取任务，未被领取的编号不会让它空等
+            job->work();
+            {
+                std::unique_lock<std::mutex> lock(job->mutex);
+                job->finished.wait(lock, [&job]() { return job->done.load() == job->count; });
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+                    if (*it == job) {
+                        jobs.erase(it);
+                        break;
+                    }
+                }
+            }
+            if (job->error) {
+                std::rethrow_exception(job->error);
+            }
+        }
+    
+    private:
+        void loop() {
+            for (;;) {
+                std::shared_ptr<Job> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                    if (stopping) {
+                        return;
+                    }
+                    job = jobs.front();
+                    // 名额用完或编号已领完的批次不再接收新线程
+                    if (job->helpers == 0 || job->next.load() >= job->count) {
+                        jobs.pop_front();
+                        continue;
+                    }
+                    if (--job->helpers == 0) {
+                        jobs.pop_front();
+                    }
+                }
+                job->work();
+            }
+        }
+        
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::shared_ptr<Job> > jobs;
+        std::vector<std::thread> workers;
+        bool stopping;
+    };
+    
+    Pool& pool() {
+        static Pool instance;
+        return instance;
+    }
+}
+
+void Parallel::run(size_t count, const std::function<void(size_t)>& task, unsigned threads) {
+    if (count == 0) {
+        return;
+    }
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+    pool().run(count, task, threads);
+}
@@ -0,0 +1,368 @@
+#include "../include/PlateBatch.h"
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PLATE_BATCH_X86 1
+#include <immintrin.h>
+#else
+#define PLATE_BATCH_X86 0
+#endif
+
+namespace {
+    /*
+     * 字符分类位。一个字节的类别 = LO_NIBBLE[低 4 位] & HI_NIBBLE[高 4 位]，
+     * 两张 16 项表正好放进一个向量寄存器，由 pshufb 并行查表。
+     */
+    const unsigned char C_DIGIT = 0x01;   // 0-9
+    const unsigned char C_AN = 0x02;      // A-N（排除 I）
+    const unsigned char C_PZ = 0x04;      // P-Z
+    const unsigned char C_DF = 0x08;      // D/F 能源标识
+    const unsigned char C_LETTER = C_AN | C_PZ;
+    const unsigned char C_SERIAL = C_DIGIT | C_AN | C_PZ;
+    // 任何字节都不具备的类别，用于让非法长度必然校验失败
+    const unsigned char C_NONE = 0x80;
+    
+    const unsigned char D = C_DIGIT, A = C_AN, P = C_PZ, E = C_DF;
+    alignas(16) const unsigned char LO_NIBBLE[16] = {
+        D | P,     D | A | P,     D | A | P,     D | A | P,
+        D | A | P | E, D | A | P, D | A | P | E, D | A | P,
+        D | A | P, D | P,         A | P,         A,
+        A,         A,             A,             0
+    };
+    alignas(16) const unsigned char HI_NIBBLE[16] = {
+        0, 0, 0, D, A | E, P, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+    
+    // “辽”的 UTF-8 编码及其在槽位中的比较掩码
+    alignas(16) const unsigned char PREFIX[16] = {0xE8, 0xBE, 0xBD};
+    alignas(16) const unsigned char PREFIX_MASK[16] = {0xFF, 0xFF, 0xFF};
+    
+    /*
+     * 37 进制位值 = 字节 - HI_BASE[高 4 位]：'0'-'9' -> 1-10，'A'-'Z' -> 11-36，
+     * 与 PlateCodec 的编码一致；补齐的 0 字节得到 0（燃油车末位补 0）
+     */
+    alignas(16) const unsigned char HI_BASE[16] = {
+        0, 0, 0, '0' - 1, 'A' - 11, 'A' - 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+    
+    /*
+     * 编码的乘加权重：槽位右移 2 字节后第 1-7 字节为 7 位 37 进制数字，
+     * 先两两合并（×37），再两两合并（×37^2），最后两段由标量合并（×37^4）
+     */
+    alignas(16) const signed char PAIR_WEIGHTS[16] = {
+        0, 1, 37, 1, 37, 1, 37, 1, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+    alignas(16) const short QUAD_WEIGHTS[8] = {1369, 1, 1369, 1, 0, 0, 0, 0};
+    const PlateKey WEIGHT_HIGH = 1874161ULL;   // 37^4
+    
+    alignas(16) const unsigned char IOTA[16] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+    };
+    
+    /*
+     * 按车牌长度索引的逐位类别要求（0 表示不检查）。
+     * 9 字节为燃油车：字母 + 5 位编号；10 字节为新能源：字母 + D/F + 5 位编号；
+     * 其他长度首字节要求 C_NONE，保证判为非法，无需额外分支。
+     */
+    struct RequirementTable {
+        alignas(16) unsigned char req[PlateBatch::SLOT_BYTES + 1][16];
+        
+        RequirementTable() {
+            std::memset(req, 0, sizeof(req));
+            for (size_t len = 0; len <= PlateBatch::SLOT_BYTES; ++len) {
+                unsigned char* r = req[len];
+                if (len == 9 || len == 10) {
+                    r[3] = C_LETTER;
+                    size_t serialStart = 4;
+                    if (len == 10) {
+                        r[4] = C_DF;
+                        serialStart = 5;
+                    }
+                    for (size_t i = serialStart; i < len; ++i) {
+                        r[i] = C_SERIAL;
+                    }
+                } else {
+                    r[0] = C_NONE;
+                }
+            }
+        }
+    };
+    
+    const RequirementTable REQUIRE;
+    
+    // 标量实现使用的整字节类别表，与向量查表结果一致
+    struct ClassTable {
+        unsigned char cls[256];
+        
+        ClassTable() {
+            for (int b = 0; b < 256; ++b) {
+                cls[b] = LO_NIBBLE[b & 0x0F] & HI_NIBBLE[b >> 4];
+            }
+        }
+    };
+    
+    const ClassTable CLASSES;
+    
+    std::uint8_t resultFlags(bool ok, size_t len, bool lower) {
+        std::uint8_t f = 0;
+        if (ok) {
+            f |= PlateBatch::FLAG_VALID;
+            if (len == 10) f |= PlateBatch::FLAG_NEW_ENERGY;
+        }
+        if (lower) f |= PlateBatch::FLAG_LOWERCASE;
+        return f;
+    }
+    
+    // 单个槽位的标量处理，也用于向量实现的尾部和超长车牌
+    std::uint8_t classifyOne(char* slot, size_t len, PlateKey& key) {
+        key = PlateCodec::INVALID_KEY;
+        if (len > PlateBatch::SLOT_BYTES) {
+            return 0;
+        }
+        unsigned char* p = reinterpret_cast<unsigned char*>(slot);
+        const unsigned char* r = REQUIRE.req[len];
+        unsigned char bad = 0;
+        bool lower = false;
+        PlateKey value = 0;
+        for (size_t i = 0; i < len; ++i) {
+            unsigned char c = p[i];
+            if (c >= 'a' && c <= 'z') {
+                c = static_cast<unsigned char>(c - 0x20);
+                p[i] = c;
+                lower = true;
+            }
+            bad |= static_cast<unsigned char>((CLASSES.cls[c] & r[i]) == 0 && r[i] != 0);
+            bad |= static_cast<unsigned char>((PREFIX[i] ^ c) & PREFIX_MASK[i]);
+            if (i >= 3) {
+                value = value * 37 + static_cast<unsigned char>(c - HI_BASE[c >> 4]);
+            }
+        }
+        // 长度不足时要求位可能落在车牌之外（如非法长度的 C_NONE）
+        for (size_t i = len; i < 16; ++i) {
+            bad |= r[i] | PREFIX_MASK[i];
+        }
+        if (bad == 0) {
+            key = (len == 9) ? value * 37 : value;   // 燃油车末位补 0
+        }
+        return resultFlags(bad == 0, len, lower);
+    }
+    
+    void classifyScalar(char* slots, const std::uint8_t* lengths,
+                        size_t count, std::uint8_t* flags, PlateKey* keys) {
+        for (size_t i = 0; i < count; ++i) {
+            flags[i] = classifyOne(slots + i * PlateBatch::SLOT_BYTES, lengths[i], keys[i]);
+        }
+    }
+
+#if PLATE_BATCH_X86
+    __attribute__((target("ssse3")))
+    PlateKey keyOf(__m128i quads) {
+        PlateKey high = static_cast<std::uint32_t>(_mm_cvtsi128_si32(quads));
+        PlateKey low = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(quads, 4)));
+        return high * WEIGHT_HIGH + low;
+    }
+    
+    __attribute__((target("ssse3")))
+    void classifySSSE3(char* slots, const std::uint8_t* lengths,
+                       size_t count, std::uint8_t* flags, PlateKey* keys) {
+        const __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(LO_NIBBLE));
+        const __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(HI_NIBBLE));
+        const __m128i base = _mm_load_si128(reinterpret_cast<const __m128i*>(HI_BASE));
+        const __m128i pairWeights = _mm_load_si128(reinterpret_cast<const __m128i*>(PAIR_WEIGHTS));
+        const __m128i quadWeights = _mm_load_si128(reinterpret_cast<const __m128i*>(QUAD_WEIGHTS));
+        const __m128i prefix = _mm_load_si128(reinterpret_cast<const __m128i*>(PREFIX));
+        const __m128i prefixMask = _mm_load_si128(reinterpret_cast<const __m128i*>(PREFIX_MASK));
+        const __m128i iota = _mm_load_si128(reinterpret_cast<const __m128i*>(IOTA));
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        const __m128i aMinus = _mm_set1_epi8('a' - 1);
+        const __m128i zPlus = _mm_set1_epi8('z' + 1);
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+        const __m128i zero = _mm_setzero_si128();
+        
+        for (size_t i = 0; i < count; ++i) {
+            size_t len = lengths[i];
+            char* slot = slots + i * PlateBatch::SLOT_BYTES;
+            if (len > PlateBatch::SLOT_BYTES) {
+                flags[i] = 0;
+                keys[i] = PlateCodec::INVALID_KEY;
+                continue;
+            }
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(slot));
+            __m128i inside = _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(len)), iota);
+            
+            // 'a'-'z' 之外（含 0x80 以上的多字节字符）的字节有符号比较均不成立
+            __m128i lower = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi8(v, aMinus),
+                                                        _mm_cmpgt_epi8(zPlus, v)), inside);
+            v = _mm_sub_epi8(v, _mm_and_si128(lower, caseBit));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(slot), v);
+            
+            __m128i hiNibble = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+            __m128i cls = _mm_and_si128(_mm_shuffle_epi8(lo, _mm_and_si128(v, nibble)),
+                                        _mm_shuffle_epi8(hi, hiNibble));
+            __m128i req = _mm_load_si128(reinterpret_cast<const __m128i*>(REQUIRE.req[len]));
+            __m128i bad = _mm_andnot_si128(_mm_cmpeq_epi8(req, zero),
+                                           _mm_cmpeq_epi8(_mm_and_si128(cls, req), zero));
+            bad = _mm_or_si128(bad, _mm_andnot_si128(_mm_cmpeq_epi8(v, prefix), prefixMask));
+            // 长度不足 3 时前缀位于车牌之外，与标量实现一样判为非法
+            bad = _mm_or_si128(bad, _mm_andnot_si128(inside, prefixMask));
+            
+            // 同一趟内完成编码：位值查表后两级乘加（非法车牌的结果丢弃）
+            __m128i digits = _mm_and_si128(_mm_sub_epi8(v, _mm_shuffle_epi8(base, hiNibble)), inside);
+            __m128i quads = _mm_madd_epi16(
+                _mm_maddubs_epi16(_mm_srli_si128(digits, 2), pairWeights), quadWeights);
+            
+            bool ok = _mm_movemask_epi8(bad) == 0;
+            flags[i] = resultFlags(ok, len, _mm_movemask_epi8(lower) != 0);
+            keys[i] = ok ? keyOf(quads) : PlateCodec::INVALID_KEY;
+        }
+    }
+    
+    __attribute__((target("avx2")))
+    __m256i pairOf(__m128i first, __m128i second) {
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1);
+    }
+    
+    __attribute__((target("avx2")))
+    __m256i broadcast(const void* table) {
+        __m128i v = _mm_load_si128(static_cast<const __m128i*>(table));
+        return pairOf(v, v);
+    }
+    
+    __attribute__((target("avx2")))
+    void classifyAVX2(char* slots, const std::uint8_t* lengths,
+                      size_t count, std::uint8_t* flags, PlateKey* keys) {
+        // vpshufb 在两个 128 位通道内各自查表，表与常量复制到两个通道，每通道一个车牌
+        const __m256i lo = broadcast(LO_NIBBLE);
+        const __m256i hi = broadcast(HI_NIBBLE);
+        const __m256i base = broadcast(HI_BASE);
+        const __m256i pairWeights = broadcast(PAIR_WEIGHTS);
+        const __m256i quadWeights = broadcast(QUAD_WEIGHTS);
+        const __m256i prefix = broadcast(PREFIX);
+        const __m256i prefixMask = broadcast(PREFIX_MASK);
+        const __m256i iota = broadcast(IOTA);
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        const __m256i aMinus = _mm256_set1_epi8('a' - 1);
+        const __m256i zPlus = _mm256_set1_epi8('z' + 1);
+        const __m256i caseBit = _mm256_set1_epi8(0x20);
+        const __m256i zero = _mm256_setzero_si256();
+        
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            size_t len0 = lengths[i];
+            size_t len1 = lengths[i + 1];
+            char* slot = slots + i * PlateBatch::SLOT_BYTES;
+            if (len0 > PlateBatch::SLOT_BYTES || len1 > PlateBatch::SLOT_BYTES) {
+                flags[i] = classifyOne(slot, len0, keys[i]);
+                flags[i + 1] = classifyOne(slot + PlateBatch::SLOT_BYTES, len1, keys[i + 1]);
+                continue;
+            }
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(slot));
+            __m256i lens = pairOf(_mm_set1_epi8(static_cast<char>(len0)),
+                                  _mm_set1_epi8(static_cast<char>(len1)));
+            __m256i inside = _mm256_cmpgt_epi8(lens, iota);
+            
+            __m256i lower = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi8(v, aMinus),
+                                                              _mm256_cmpgt_epi8(zPlus, v)), inside);
+            v = _mm256_sub_epi8(v, _mm256_and_si256(lower, caseBit));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(slot), v);
+            
+            __m256i hiNibble = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+            __m256i cls = _mm256_and_si256(_mm256_shuffle_epi8(lo, _mm256_and_si256(v, nibble)),
+                                           _mm256_shuffle_epi8(hi, hiNibble));
+            __m256i req = pairOf(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(REQUIRE.req[len0])),
+                _mm_load_si128(reinterpret_cast<const __m128i*>(REQUIRE.req[len1])));
+            __m256i bad = _mm256_andnot_si256(_mm256_cmpeq_epi8(req, zero),
+                                              _mm256_cmpeq_epi8(_mm256_and_si256(cls, req), zero));
+            bad = _mm256_or_si256(bad, _mm256_andnot_si256(_mm256_cmpeq_epi8(v, prefix), prefixMask));
+            bad = _mm256_or_si256(bad, _mm256_andnot_si256(inside, prefixMask));
+            
+            __m256i digits = _mm256_and_si256(
+                _mm256_sub_epi8(v, _mm256_shuffle_epi8(base, hiNibble)), inside);
+            __m256i quads = _mm256_madd_epi16(
+                _mm256_maddubs_epi16(_mm256_srli_si256(digits, 2), pairWeights), quadWeights);
+            
+            unsigned badBits = static_cast<unsigned>(_mm256_movemask_epi8(bad));
+            unsigned lowerBits = static_cast<unsigned>(_mm256_movemask_epi8(lower));
+            bool ok0 = (badBits & 0xFFFFu) == 0;
+            bool ok1 = (badBits >> 16) == 0;
+            flags[i] = resultFlags(ok0, len0, (lowerBits & 0xFFFFu) != 0);
+            flags[i + 1] = resultFlags(ok1, len1, (lowerBits >> 16) != 0);
+            keys[i] = ok0 ? keyOf(_mm256_castsi256_si128(quads)) : PlateCodec::INVALID_KEY;
+            keys[i + 1] = ok1 ? keyOf(_mm256_extracti128_si256(quads, 1)) : PlateCodec::INVALID_KEY;
+        }
+        for (; i < count; ++i) {
+            flags[i] = classifyOne(slots + i * PlateBatch::SLOT_BYTES, lengths[i], keys[i]);
+        }
+    }
+#endif
+
+    typedef void (*KernelFn)(char*, const std::uint8_t*, size_t, std::uint8_t*, PlateKey*);
+    
+    struct Kernel {
+        KernelFn fn;
+        const char* name;
+    };
+    
+    const Kernel SCALAR = {classifyScalar, "scalar"};
+#if PLATE_BATCH_X86
+    const Kernel SSSE3 = {classifySSSE3, "ssse3"};
+    const Kernel AVX2 = {classifyAVX2, "avx2"};
+#endif
+
+    const Kernel* detectKernel() {
+#if PLATE_BATCH_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return &AVX2;
+        if (__builtin_cpu_supports("ssse3")) return &SSSE3;
+#endif
+        return &SCALAR;
+    }
+    
+    const Kernel& activeKernel() {
+        static const Kernel* kernel = detectKernel();
+        return *kernel;
+    }
+}
+
+PlateBatch::PlateBatch(size_t capacity)
+    : cap(capacity ? capacity : 1), count(0),
+      slots(cap * SLOT_BYTES), lengths(cap), results(cap), keys(cap) {}
+
+void PlateBatch::clear() {
+    count = 0;
+}
+
+void PlateBatch::add(const char* data, size_t len) {
+    if (count == cap) {
+        cap *= 2;
+        slots.resize(cap * SLOT_BYTES);
+        lengths.resize(cap);
+        results.resize(cap);
+        keys.resize(cap);
+    }
+    char* slot = &slots[count * SLOT_BYTES];
+    std::memset(slot, 0, SLOT_BYTES);
+    if (len <= SLOT_BYTES) {
+        std::memcpy(slot, data, len);
+        lengths[count] = static_cast<std::uint8_t>(len);
+    } else {
+        lengths[count] = static_cast<std::uint8_t>(SLOT_BYTES + 1);
+    }
+    ++count;
+}
+
+void PlateBatch::classify() {
+    if (count > 0) {
+        classify(&slots[0], &lengths[0], count, &results[0], &keys[0]);
+    }
+}
+
+void PlateBatch::classify(char* slots, const std::uint8_t* lengths,
+                          size_t count, std::uint8_t* flags, PlateKey* keys) {
+    activeKernel().fn(slots, lengths, count, flags, keys);
+}
+
+const char* PlateBatch::implementation() {
+    return activeKernel().name;
+}
@@ -1,5 +1,8 @@
 #include "../include/PlateDatabase.h"
 #include "../include/FileIO.h"
+#include "../include/Parallel.h"
+#include "../include/PlateBatch.h"
+#include "../include/Trace.h"
 #include "../include/Utils.h"
 #include <algorithm>
 #include <iostream>
@@ -9,10 +12,239 @@
 #include <sstream>
 #include <cmath>
 #include <vector>
+#include <fstream>
+#include <limits>
+
+// 复制快照供写者修改：记录表只复制块目录，之后改到哪块才复制哪块；
+// 映射快照先解码并复制为记录表的基底（只在打开后的首次修改时发生），此后的版本与映射文件无关
+static std::shared_ptr<PlateSnapshot> cloneForWrite(const PlateSnapshot& base) {
+    PLATE_TRACE_SCOPE_N("PlateDatabase::cloneSnapshot", base.size());
+    std::shared_ptr<PlateSnapshot> next = std::make_shared<PlateSnapshot>(base);
+    if (next->mapped) {
+        next->records.assign(std::vector<PlateRecord>(base.mapped->records()));
+        next->mapped.reset();
+    }
+    return next;
+}
+
+// 复制快照的元数据，全部记录复制到 rows 中；排序、建索引等整表改写完成后再 assign 回新快照
+static std::shared_ptr<PlateSnapshot> cloneForRewrite(const PlateSnapshot& base,
+                                                      std::vector<PlateRecord>& rows) {
+    PLATE_TRACE_SCOPE_N("PlateDatabase::cloneSnapshot", base.size());
+    std::shared_ptr<PlateSnapshot> next = std::make_shared<PlateSnapshot>(base);
+    rows = base.mapped ? base.mapped->records() : base.records.toVector();
+    next->records.clear();
+    next->mapped.reset();
+    next->keyIndex.reset();     // 行序改变，读索引在发布时重建
+    return next;
+}
+
+namespace {
+    // 增量保存最多跟踪的变化条数，超过后下次保存改写完整基准
+    const size_t MAX_TRACKED_CHANGES = 1u << 20;
+    
+    // 统计字符串堆占用时每个任务扫描的记录数
+    const size_t MEMORY_SCAN_CHUNK = 1u << 16;
+    
+    const size_t NO_CACHE = std::numeric_limits<size_t>::max();
+    
+    size_t recordHeapBytes(const PlateRecord& rec) {
+        return MemoryTracker::heapBytes(rec.plate) + MemoryTracker::heapBytes(rec.city) +
+               MemoryTracker::heapBytes(rec.owner) + MemoryTracker::heapBytes(rec.category);
+    }
+    
+    // 全部记录中字符串的堆字节数（分块并行扫描；顺序表与分块记录表通用）
+    template <typename Rows>
+    size_t stringHeapBytes(const Rows& records) {
+        size_t chunks = (records.size() + MEMORY_SCAN_CHUNK - 1) / MEMORY_SCAN_CHUNK;
+        std::vector<size_t> sums(chunks, 0);
+        Parallel::forEach(chunks, [&](size_t c) {
+            size_t end = std::min(records.size(), (c + 1) * MEMORY_SCAN_CHUNK);
+            size_t sum = 0;
+            for (size_t i = c * MEMORY_SCAN_CHUNK; i < end; ++i) {
+                sum += recordHeapBytes(records[i]);
+            }
+            sums[c] = sum;
+        });
+        size_t total = 0;
+        for (size_t c = 0; c < chunks; ++c) {
+            total += sums[c];
+        }
+        return total;
+    }
+    
+    // 预写日志已失效：拒绝修改，数据库保持只读
+    bool rejectReadOnly() {
+        std::cerr << "预写日志已失效，数据库处于只读状态，修改被拒绝！" << std::endl;
+        return false;
+    }
+    
+    // 两条变化是否相同（PlateRecord::operator== 只比较车牌）
+    bool sameChange(const DeltaChange& a, const DeltaChange& b) {
+        return a.removed == b.removed && a.record.plate == b.record.plate &&
+               a.record.city == b.record.city && a.record.owner == b.record.owner &&
+               a.record.category == b.record.category;
+    }
+    
+    // 整表改写复制出的记录（顺序表与字符串堆）字节数，登记到 MemoryTracker::REWRITE
+    size_t rewriteBytes(const std::vector<PlateRecord>& rows) {
+        return rows.capacity() * sizeof(PlateRecord) + stringHeapBytes(rows);
+    }
+    
+    size_t cityIndexBytes(const std::vector<CityBlock>& blocks) {
+        size_t bytes = blocks.capacity() * sizeof(CityBlock);
+        for (const auto& block : blocks) {
+            bytes += MemoryTracker::heapBytes(block.city);
+        }
+        return bytes;
+    }
+    
+    // 按车牌修补快照中的记录（回放日志、叠加增量文件时使用）
+    // 首次修改时才把记录复制为连续向量；车牌到下标的映射按需建立；
+    // 删除先打标记，finish 时统一压缩并写回快照
+    class RowPatcher {
+    public:
+        explicit RowPatcher(std::shared_ptr<PlateSnapshot>& snap)
+            : snap(snap), rows(nullptr), indexed(false), copy(MemoryTracker::REWRITE) {}
+        
+        bool changed() const { return rows != nullptr; }
+        
+        void append(const PlateRecord& rec) {
+            std::vector<PlateRecord>& recs = mutableRows();
+            recs.push_back(rec);
+            removed.push_back(0);
+            if (indexed) position[rec.plate] = recs.size() - 1;
+        }
+        
+        PlateRecord* find(const std::string& plate) {
+            std::vector<PlateRecord>& recs = mutableRows();
+            if (!indexed) {
+                position.reserve(recs.size());
+                for (size_t i = 0; i < recs.size(); i++) {
+                    if (!removed[i]) position[recs[i].plate] = i;
+                }
+                indexed = true;
+            }
+            auto it = position.find(plate);
+            return it == position.end() ? nullptr : &recs[it->second];
+        }
+        
+        // 已存在则整体替换，否则追加
+        void upsert(const PlateRecord& rec) {
+            PlateRecord* existing = find(rec.plate);
+            if (existing) {
+                *existing = rec;
+            } else {
+                append(rec);
+            }
+        }
+        
+        void remove(const std::string& plate) {
+            if (find(plate)) {
+                removed[position[plate]] = 1;
+                position.erase(plate);
+            }
+        }
+        
+        void clear() {
+            mutableRows().clear();
+            removed.clear();
+            position.clear();
+        }
+        
+        // 压缩掉已删除的记录
+        void finish() {
+            if (!rows) return;
+            size_t out = 0;
+            for (size_t i = 0; i < rows->size(); i++) {
+                if (removed[i]) continue;
+                if (out != i) (*rows)[out] = std::move((*rows)[i]);
+                out++;
+            }
+            rows->resize(out);
+            snap->records.assign(std::move(*rows));
+        }
+        
+    private:
+        std::vector<PlateRecord>& mutableRows() {
+            if (!rows) {
+                snap = cloneForRewrite(*snap, patched);
+                copy.set(rewriteBytes(patched));
+                snap->sortedByPlate = false;
+                snap->cityIndexBuilt = false;
+                snap->cityIndex.clear();
+                rows = &patched;
+                removed.assign(rows->size(), 0);
+            }
+            return *rows;
+        }
+        
+        std::shared_ptr<PlateSnapshot>& snap;
+        std::vector<PlateRecord> patched;
+        std::vector<PlateRecord>* rows;
+        std::vector<char> removed;
+        std::unordered_map<std::string, size_t> position;
+        bool indexed;
+        MemoryTracker::Hold copy;   // 复制出的记录，发布前与原快照并存
+    };
+}
 
 PlateDatabase::PlateDatabase() 
-    : sortedByPlate(false), cityIndexBuilt(false), 
-      totalOperations(0), totalSearches(0) {
+    : current(std::make_shared<PlateSnapshot>()),
+      totalOperations(0), verbose(true), durable(false),
+      saving(false), lastSaveOk(true),
+      changesCleared(false), changesOverflow(false), clearEpoch(0), deltaBaseId(0), deltaSeq(0),
+      occupancyBuilt(false), plateIndexBuilt(false), memoryVersion(0), memoryDecoded(false),
+      memoryStringHeap(NO_CACHE), randomEngine(std::random_device()()) {
+}
+
+PlateDatabase::~PlateDatabase() {
+    waitForSave();
+}
+
+SnapshotPtr PlateDatabase::snapshot() const {
+    return std::atomic_load(&current);
+}
+
+void PlateDatabase::publish(const std::shared_ptr<PlateSnapshot>& next) const {
+    if (next->mapped || next->sortedByPlate) {
+        next->keyIndex.reset();     // 映射列与有序记录本身即可折半查找
+    } else if (!next->keyIndex || next->keyIndex->needsRebuild()) {
+        next->keyIndex = PlateKeyIndex::build(next->records);
+    }
+    next->version = snapshot()->version + 1;
+    std::atomic_store(&current, SnapshotPtr(next));
+}
+
+SearchResult PlateDatabase::lookupIn(const PlateSnapshot& snap,
+                                     const std::string& plate) const {
+    // 每次查找都计数，耗时按采样间隔抽样记录
+    Metrics::Timer timer(metrics, Metrics::OP_FIND);
+    
+    // 比较次数只随结果返回，不保存为共享状态
+    if (snap.mapped) {
+        return snap.mapped->find(plate);
+    }
+    if (snap.sortedByPlate) {
+        return SearchAlgorithms::binarySearch(snap.records, plate);
+    }
+    if (snap.keyIndex) {
+        // 只有存在未进索引的记录时，未命中才需要逐条确认
+        SearchResult result = snap.keyIndex->find(PlateCodec::encode(plate));
+        if (result.index != -1 || snap.keyIndex->unindexedRows() == 0) {
+            return result;
+        }
+    }
+    return SearchAlgorithms::linearSearch(snap.records, plate);
+}
+
+bool PlateDatabase::waitDurable(const std::shared_ptr<WriteAheadLog>& log,
+                                std::uint64_t lsn) const {
+    if (!log || log->sync(lsn)) {
+        return true;
+    }
+    std::cerr << "预写日志写入失败，本次修改未能持久化！数据库转为只读，之后的修改将被拒绝。" << std::endl;
+    return false;
 }
 
 bool PlateDatabase::addRecord(const std::string& plate, 
@@ -20,182 +252,597 @@ bool PlateDatabase::addRecord(const std::string& plate,
                               const std::string& owner) {
     std::string upperPlate = Utils::toUpperStr(plate);
     
-    if (!Utils::isValidPlate(upperPlate)) {
-        std::cout << "车牌号格式非法，录入失败！" << std::endl;
+    // 编码一次即完成校验，类别也由编码得出，不再逐字符重复校验
+    PlateKey key = PlateCodec::encode(upperPlate);
+    if (key == PlateCodec::INVALID_KEY) {
+        if (verbose) std::cout << "车牌号格式非法，录入失败！" << std::endl;
         return false;
     }
     
+    std::unique_lock<std::mutex> lock(writeMutex);
+    SnapshotPtr base = snapshot();
+    
     // 检查是否已存在
-    if (findRecord(upperPlate) != -1) {
-        std::cout << "车牌号已存在，录入失败！" << std::endl;
+    if (locateForWrite(*base, upperPlate) != -1) {
+        if (verbose) std::cout << "车牌号已存在，录入失败！" << std::endl;
         return false;
     }
     
-    records.emplace_back(upperPlate, city, owner);
+    PlateRecord rec(upperPlate, city, owner);
     // 根据车牌确定车辆类别（油车/电车）
-    records.back().category = Utils::getPlateCategory(upperPlate);
-    sortedByPlate = false;
-    cityIndexBuilt = false;
+    rec.category = PlateCodec::categoryOf(key);
+    
+    // 先追加日志再发布；日志序号在写锁内分配，与快照发布顺序一致，落盘等待在锁外进行
+    std::shared_ptr<WriteAheadLog> log = wal;
+    std::uint64_t lsn = log ? log->appendAdd(rec) : 0;
+    if (log && lsn == 0) {
+        return rejectReadOnly();
+    }
+    
+    // 只复制末尾一块
+    std::shared_ptr<PlateSnapshot> next = cloneForWrite(*base);
+    next->records.push_back(rec);
+    next->sortedByPlate = false;
+    next->cityIndexBuilt = false;
+    if (next->keyIndex) {
+        PlateKeyIndex::Editor edit(*next->keyIndex);
+        edit.insert(key, static_cast<PlateKeyIndex::Row>(next->records.size() - 1));
+        next->keyIndex = edit.commit();
+    }
+    publish(next);
     totalOperations++;
     
-    return true;
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        trackUpsert(rec);
+        if (occupancyBuilt) occupancy.set(upperPlate);
+        if (plateIndexBuilt) plateIndex.insert(std::make_pair(key, next->records.size() - 1));
+    }
+    lock.unlock();
+    
+    return waitDurable(log, lsn);
 }
 
 bool PlateDatabase::modifyRecord(const std::string& plate,
                                  const std::string& newCity,
                                  const std::string& newOwner) {
     std::string upperPlate = Utils::toUpperStr(plate);
-    int idx = findRecord(upperPlate);
+    
+    std::unique_lock<std::mutex> lock(writeMutex);
+    SnapshotPtr base = snapshot();
+    int idx = locateForWrite(*base, upperPlate);
     
     if (idx == -1) {
-        std::cout << "未找到该车牌号！" << std::endl;
+        if (verbose) std::cout << "未找到该车牌号！" << std::endl;
         return false;
     }
     
-    records[idx].city = newCity;
-    records[idx].owner = newOwner;
-    cityIndexBuilt = false;
+    PlateRecord rec = base->recordAt(static_cast<size_t>(idx));
+    rec.city = newCity;
+    rec.owner = newOwner;
+    
+    std::shared_ptr<WriteAheadLog> log = wal;
+    std::uint64_t lsn = log ? log->appendModify(rec) : 0;
+    if (log && lsn == 0) {
+        return rejectReadOnly();
+    }
+    
+    // 只复制该记录所在的块
+    std::shared_ptr<PlateSnapshot> next = cloneForWrite(*base);
+    next->records.mutableAt(idx) = rec;
+    next->cityIndexBuilt = false;
+    publish(next);
     totalOperations++;
     
-    return true;
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        trackUpsert(rec);
+    }
+    lock.unlock();
+    
+    return waitDurable(log, lsn);
 }
 
 bool PlateDatabase::deleteRecord(const std::string& plate) {
     std::string upperPlate = Utils::toUpperStr(plate);
-    int idx = findRecord(upperPlate);
+    
+    std::unique_lock<std::mutex> lock(writeMutex);
+    SnapshotPtr base = snapshot();
+    
+    // 删除要改写被移动末行的索引项，并据索引判断同一车牌是否还有其他记录：
+    // 无论车牌能否编码都先建立写者索引（加载、打开映射快照后尚未建立）
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        ensurePlateIndex();
+    }
+    int idx = locateForWrite(*base, upperPlate);
     
     if (idx == -1) {
-        std::cout << "未找到该车牌号！" << std::endl;
+        if (verbose) std::cout << "未找到该车牌号！" << std::endl;
         return false;
     }
     
-    records.erase(records.begin() + idx);
-    sortedByPlate = false;
-    cityIndexBuilt = false;
+    std::shared_ptr<WriteAheadLog> log = wal;
+    std::uint64_t lsn = log ? log->appendDelete(upperPlate) : 0;
+    if (log && lsn == 0) {
+        return rejectReadOnly();
+    }
+    
+    // 末行移入空位，只复制这两行所在的块；行序本就不保证，排序标记随之清除
+    std::shared_ptr<PlateSnapshot> next = cloneForWrite(*base);
+    size_t row = static_cast<size_t>(idx);
+    size_t last = next->records.size() - 1;
+    PlateKey key = PlateCodec::encode(next->records[row].plate);
+    PlateKey movedKey = PlateCodec::encode(next->records[last].plate);
+    next->records.swapRemove(row);
+    next->sortedByPlate = false;
+    next->cityIndexBuilt = false;
+    if (next->keyIndex) {
+        PlateKeyIndex::Editor edit(*next->keyIndex);
+        edit.erase(key, static_cast<PlateKeyIndex::Row>(row));
+        if (row != last) {
+            edit.move(movedKey, static_cast<PlateKeyIndex::Row>(last), static_cast<PlateKeyIndex::Row>(row));
+        }
+        next->keyIndex = edit.commit();
+    }
+    publish(next);
     totalOperations++;
     
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        trackRemove(upperPlate);
+        if (plateIndexBuilt) {
+            unindexRow(key, row);
+            if (row != last) moveIndexedRow(movedKey, last, row);
+        }
+        // 导入的数据可能含重复车牌，最后一条删除后才释放号段
+        if (occupancyBuilt && plateIndexBuilt && key != PlateCodec::INVALID_KEY &&
+            plateIndex.count(key) == 0) {
+            occupancy.reset(upperPlate);
+        }
+    }
+    lock.unlock();
+    
+    return waitDurable(log, lsn);
+}
+
+SearchResult PlateDatabase::lookup(const std::string& plate) const {
+    SnapshotPtr snap = snapshot();
+    return lookupIn(*snap, Utils::toUpperStr(plate));
+}
+
+bool PlateDatabase::getRecord(const std::string& plate, PlateRecord* out) const {
+    SnapshotPtr snap = snapshot();
+    int idx = lookupIn(*snap, Utils::toUpperStr(plate)).index;
+    if (idx == -1) {
+        return false;
+    }
+    if (out) {
+        *out = snap->recordAt(static_cast<size_t>(idx));
+    }
     return true;
 }
 
 int PlateDatabase::findRecord(const std::string& plate) const {
-    totalSearches++;
-    
-    if (sortedByPlate) {
-        return SearchAlgorithms::binarySearch(records, plate);
-    } else {
-        return SearchAlgorithms::linearSearch(records, plate);
-    }
+    return lookup(plate).index;
 }
 
 int PlateDatabase::binarySearchPlate(const std::string& plate) const {
-    if (!sortedByPlate) {
-        std::cout << "当前未按车牌排序，将自动使用基数排序..." << std::endl;
-        const_cast<PlateDatabase*>(this)->radixSortByPlate();
+    SnapshotPtr snap = snapshot();
+    if (!snap->sortedByPlate) {
+        if (verbose) std::cout << "当前未按车牌排序，将自动使用基数排序..." << std::endl;
+        snap = ensureSorted();
     }
     
-    return SearchAlgorithms::binarySearch(records, plate);
+    return lookupIn(*snap, Utils::toUpperStr(plate)).index;
 }
 
-bool PlateDatabase::loadFromFile(const std::string& filename) {
-    std::vector<PlateRecord> newRecords;
-    if (!FileIO::loadFromFile(filename, newRecords)) {
+bool PlateDatabase::loadFromFile(const std::string& filename, LoadReport* report,
+                                 unsigned threads) {
+    PLATE_TRACE_SCOPE("PlateDatabase::loadFromFile");
+    Metrics::Timer timer(metrics, Metrics::OP_IMPORT, 0);
+    
+    // 解析在写锁外进行；新记录随后整块移入新快照的末尾，已有记录不复制
+    std::vector<PlateRecord> added;
+    bool ok = (threads == 1)
+        ? FileIO::loadFromFile(filename, added, report)
+        : FileIO::loadFromFileParallel(filename, added, report, threads);
+    if (!ok) {
         return false;
     }
+    timer.setItems(added.size());
     
-    records.insert(records.end(), newRecords.begin(), newRecords.end());
-    sortedByPlate = false;
-    cityIndexBuilt = false;
+    std::unique_lock<std::mutex> lock(writeMutex);
+    std::shared_ptr<PlateSnapshot> next = cloneForWrite(*snapshot());
+    return publishAppended(next, added, lock);
+}
+
+bool PlateDatabase::importFile(const std::string& filename,
+                               const ImportProgressFn& progress,
+                               LoadReport* report) {
+    // 每批单独取写锁、写日志并发布，批与批之间其他写操作和读者都不被阻塞；
+    // 取消或失败时已发布的批次保留
+    PLATE_TRACE_SCOPE("PlateDatabase::importFile");
+    Metrics::Timer timer(metrics, Metrics::OP_IMPORT, 0);
+    size_t imported = 0;
+    
+    bool ok = FileIO::importStreaming(filename, [this, &imported](std::vector<PlateRecord>& batch) {
+        size_t n = batch.size();
+        std::unique_lock<std::mutex> lock(writeMutex);
+        std::shared_ptr<PlateSnapshot> next = cloneForWrite(*snapshot());
+        if (!publishAppended(next, batch, lock)) {
+            return false;
+        }
+        imported += n;
+        return true;
+    }, progress, report);
+    timer.setItems(imported);
+    
+    return ok;
+}
+
+bool PlateDatabase::publishAppended(const std::shared_ptr<PlateSnapshot>& next,
+                                    std::vector<PlateRecord>& added,
+                                    std::unique_lock<std::mutex>& lock) {
+    PLATE_TRACE_SCOPE_N("PlateDatabase::publishAppended", added.size());
+    if (added.empty()) {
+        return true;
+    }
+    
+    // 先追加日志再发布，日志已失效时新增记录不会出现在快照中
+    std::shared_ptr<WriteAheadLog> log = wal;
+    std::uint64_t lsn = log ? log->appendBatch(added.begin(), added.end()) : 0;
+    if (log && lsn == 0) {
+        return rejectReadOnly();
+    }
+    
+    // 变化、位图与索引都按新增部分记录，随后新增记录整体移入快照
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        trackBatch(added.begin(), added.end());
+        if (occupancyBuilt) {
+            for (const auto& rec : added) {
+                occupancy.set(rec.plate);
+            }
+        }
+        if (plateIndexBuilt) {
+            size_t row = next->records.size();
+            for (const auto& rec : added) {
+                PlateKey key = PlateCodec::encode(rec.plate);
+                if (key != PlateCodec::INVALID_KEY) plateIndex.insert(std::make_pair(key, row));
+                row++;
+            }
+        }
+    }
+    
+    // 读索引：小批增量并入覆盖层，大批交由发布时整体重建
+    if (next->keyIndex && next->keyIndex->canAbsorb(added.size())) {
+        PlateKeyIndex::Editor edit(*next->keyIndex);
+        PlateKeyIndex::Row row = static_cast<PlateKeyIndex::Row>(next->records.size());
+        for (const auto& rec : added) {
+            edit.insert(PlateCodec::encode(rec.plate), row++);
+        }
+        next->keyIndex = edit.commit();
+    } else {
+        next->keyIndex.reset();
+    }
+    
+    next->records.append(std::move(added));
+    next->sortedByPlate = false;
+    next->cityIndexBuilt = false;
+    publish(next);
     totalOperations++;
+    lock.unlock();
     
-    return true;
+    return waitDurable(log, lsn);
 }
 
 void PlateDatabase::generateRandomData(int count) {
-    static const std::vector<std::string> cities = {
-        "沈阳", "大连", "鞍山", "抚顺", "本溪", "丹东",
-        "锦州", "营口", "阜新", "辽阳", "盘锦", "铁岭", "朝阳", "葫芦岛"
-    };
+    if (count <= 0) {
+        return;
+    }
+    // 种子取自本实例的随机数引擎，生成与查重统一由 generateData 完成
+    std::uint64_t seed = 0;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        seed = (static_cast<std::uint64_t>(randomEngine()) << 32) | randomEngine();
+    }
+    generateData(static_cast<size_t>(count), seed);
+}
+
+bool PlateDatabase::generateData(size_t count, std::uint64_t seed, unsigned threads) {
+    return generateWith([&](std::vector<PlateRecord>& rows) {
+        return DataGenerator::generate(seed, 0, count, rows, threads);
+    }, seed);
+}
+
+bool PlateDatabase::generateData(size_t count, std::uint64_t seed, const WorkloadSpec& spec,
+                                 unsigned threads) {
+    return generateWith([&](std::vector<PlateRecord>& rows) {
+        return DataGenerator::generate(spec, seed, count, rows, threads);
+    }, seed);
+}
+
+bool PlateDatabase::generateWith(const std::function<bool(std::vector<PlateRecord>&)>& fill,
+                                 std::uint64_t seed) {
+    auto startTime = std::chrono::high_resolution_clock::now();
     
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> cityDist(0, static_cast<int>(cities.size()) - 1);
-    std::uniform_int_distribution<int> typeDist(0, 1); // 0=油车, 1=电车
+    // 生成与已有数据无关，在写锁外进行
+    std::vector<PlateRecord> added;
+    if (!fill(added)) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(writeMutex);
     
-    for (int i = 0; i < count; ++i) {
-        // 先随机选择一个城市
-        std::string city = cities[cityDist(gen)];
-        
-        // 随机决定是油车还是电车
-        bool isNewEnergy = (typeDist(gen) == 1);
-        
-        // 根据城市和类型生成对应的车牌（确保车牌字母与城市匹配）
-        std::string plate = isNewEnergy
-            ? Utils::generateRandomNewEnergyPlateByCity(city)
-            : Utils::generateRandomPlateByCity(city);
-        std::string owner = "随机车主" + std::to_string(i + 1);
-        
-        records.emplace_back(plate, city, owner);
-        records.back().category = isNewEnergy ? "电车" : "油车";
+    // 本批车牌互不重复，但可能与库中已有记录相同：逐条在占用位图中预留，
+    // 已被占用的改取同一号段中其后第一个空闲编号，号段已满的丢弃。
+    // 空库且位图尚未建立时不会冲突，不为此建立位图（随机分布的号段几乎每页都要分配）
+    std::unique_lock<std::mutex> state(stateMutex);
+    if (occupancyBuilt || snapshot()->size() > 0) {
+        ensureOccupancy();
+        size_t kept = 0;
+        for (size_t i = 0; i < added.size(); ++i) {
+            PlateRecord& rec = added[i];
+            if (!occupancy.set(rec.plate)) {
+                char letter = 0;
+                PlateOccupancy::Kind kind = PlateOccupancy::KIND_FUEL;
+                std::uint32_t serial = 0;
+                if (!PlateOccupancy::parse(rec.plate, letter, kind, serial)) {
+                    continue;
+                }
+                rec.plate = occupancy.allocateFrom(letter, kind, serial);
+                if (rec.plate.empty()) {
+                    continue;
+                }
+            }
+            if (kept != i) {
+                added[kept] = std::move(rec);
+            }
+            kept++;
+        }
+        added.resize(kept);
     }
+    const bool reserved = occupancyBuilt;
+    state.unlock();
     
-    sortedByPlate = false;
-    cityIndexBuilt = false;
-    totalOperations++;
+    const size_t generated = added.size();
+    if (!publishAppended(cloneForWrite(*snapshot()), added, lock)) {
+        if (reserved && !added.empty()) {
+            // 日志拒绝追加、记录未发布（写锁仍持有）：归还预留的车牌，否则这些车牌再也无法使用
+            state.lock();
+            for (const auto& rec : added) {
+                occupancy.reset(rec.plate);
+            }
+        }
+        return false;
+    }
     
-    std::cout << "随机生成 " << count << " 条记录完成！" << std::endl;
+    if (verbose) {
+        auto endTime = std::chrono::high_resolution_clock::now();
+        std::cout << "按种子 " << seed << " 生成 " << generated << " 条记录完成，耗时 "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count()
+                  << " ms。" << std::endl;
+    }
+    return true;
 }
 
-void PlateDatabase::radixSortByPlate() {
-    if (records.empty()) {
-        sortedByPlate = true;
+void PlateDatabase::ensureOccupancy() const {
+    if (occupancyBuilt) {
         return;
     }
+    SnapshotPtr snap = snapshot();
+    occupancy.clear();
+    if (snap->mapped) {
+        // 映射快照只解码车牌列
+        for (size_t i = 0; i < snap->mapped->size(); ++i) {
+            PlateKey key = snap->mapped->keyAt(i);
+            if (key != PlateCodec::INVALID_KEY) {
+                occupancy.set(PlateCodec::decode(key));
+            }
+        }
+    } else {
+        for (size_t i = 0; i < snap->records.size(); ++i) {
+            occupancy.set(snap->records[i].plate);
+        }
+    }
+    occupancyBuilt = true;
+}
+
+void PlateDatabase::ensurePlateIndex() const {
+    if (plateIndexBuilt) {
+        return;
+    }
+    SnapshotPtr snap = snapshot();
+    PLATE_TRACE_SCOPE_N("PlateDatabase::buildPlateIndex", snap->size());
+    plateIndex.clear();
+    plateIndex.reserve(snap->size());
+    for (size_t i = 0; i < snap->size(); ++i) {
+        // 映射快照直接取编码列
+        PlateKey key = snap->mapped ? snap->mapped->keyAt(i)
+                                    : PlateCodec::encode(snap->records[i].plate);
+        if (key != PlateCodec::INVALID_KEY) {
+            plateIndex.insert(std::make_pair(key, i));
+        }
+    }
+    plateIndexBuilt = true;
+}
+
+void PlateDatabase::invalidatePlateIndex() const {
+    std::unordered_multimap<PlateKey, size_t>().swap(plateIndex);
+    plateIndexBuilt = false;
+}
+
+void PlateDatabase::unindexRow(PlateKey key, size_t row) {
+    auto range = plateIndex.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == row) {
+            plateIndex.erase(it);
+            return;
+        }
+    }
+}
+
+void PlateDatabase::moveIndexedRow(PlateKey key, size_t from, size_t to) {
+    auto range = plateIndex.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == from) {
+            it->second = to;
+            return;
+        }
+    }
+}
+
+int PlateDatabase::locateForWrite(const PlateSnapshot& base, const std::string& plate) {
+    PlateKey key = PlateCodec::encode(plate);
+    if (key == PlateCodec::INVALID_KEY) {
+        // 无法编码的车牌（来自未经校验的导入数据）不在索引中，退回逐条查找
+        return lookupIn(base, plate).index;
+    }
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        ensurePlateIndex();
+    }
+    auto it = plateIndex.find(key);
+    return it == plateIndex.end() ? -1 : static_cast<int>(it->second);
+}
+
+bool PlateDatabase::isPlateOccupied(const std::string& plate) const {
+    // 只取附属状态锁，不与导入、排序或日志落盘等长时间持有写锁的操作互等
+    std::lock_guard<std::mutex> state(stateMutex);
+    ensureOccupancy();
+    return occupancy.test(plate);
+}
+
+std::vector<std::string> PlateDatabase::allocatePlates(const std::string& city, size_t count,
+                                                       PlateOccupancy::Kind kind,
+                                                       const std::string& pattern) {
+    char letter = Utils::getPlateLetterByCity(city);
+    if (letter == '\0') {
+        if (verbose) std::cout << "城市无效，无法分配车牌！" << std::endl;
+        return std::vector<std::string>();
+    }
     
-    RadixSort::sort(records);
-    sortedByPlate = true;
-    cityIndexBuilt = false;
+    std::lock_guard<std::mutex> lock(writeMutex);
+    std::lock_guard<std::mutex> state(stateMutex);
+    ensureOccupancy();
+    return occupancy.allocate(letter, kind, count, pattern);
+}
+
+SnapshotPtr PlateDatabase::ensureSorted() const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    SnapshotPtr base = snapshot();
+    if (base->sortedByPlate) {
+        return base; // 其他写者已完成排序
+    }
     
-    std::cout << "已使用静态链表链式基数排序对车牌进行排序！" << std::endl;
-    std::cout << "排序记录数：" << RadixSort::getLastSortCount() 
-              << "，耗时：" << RadixSort::getLastSortTime() << " 毫秒" << std::endl;
+    PLATE_TRACE_SCOPE_N("PlateDatabase::ensureSorted", base->size());
+    Metrics::Timer timer(metrics, Metrics::OP_SORT, base->size());
+    std::vector<PlateRecord> rows;
+    std::shared_ptr<PlateSnapshot> next = cloneForRewrite(*base, rows);
+    MemoryTracker::Hold copy(MemoryTracker::REWRITE, rewriteBytes(rows));
+    RadixSort::sort(rows);
+    next->records.assign(std::move(rows));
+    next->sortedByPlate = true;
+    next->cityIndexBuilt = false;
+    next->cityIndex.clear();
+    publish(next);
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        invalidatePlateIndex();
+    }
+    return next;
 }
 
-std::vector<PlateRecord> PlateDatabase::searchByCity(const std::string& city) {
-    if (!cityIndexBuilt) {
-        std::cout << "城市索引未建立，正在建立..." << std::endl;
-        buildCityIndex();
+SortResult PlateDatabase::radixSortByPlate() {
+    SortResult result;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        PLATE_TRACE_SCOPE_N("PlateDatabase::radixSortByPlate", snapshot()->size());
+        Metrics::Timer timer(metrics, Metrics::OP_SORT, snapshot()->size());
+        std::vector<PlateRecord> rows;
+        std::shared_ptr<PlateSnapshot> next = cloneForRewrite(*snapshot(), rows);
+        MemoryTracker::Hold copy(MemoryTracker::REWRITE, rewriteBytes(rows));
+        result = RadixSort::sort(rows);
+        next->records.assign(std::move(rows));
+        next->sortedByPlate = true;
+        next->cityIndexBuilt = false;
+        next->cityIndex.clear();
+        publish(next);
+        std::lock_guard<std::mutex> state(stateMutex);
+        invalidatePlateIndex();
     }
     
-    int blockId = SearchAlgorithms::findCityBlock(cityIndex, city);
+    if (result.count > 0 && verbose) {
+        std::cout << "已使用静态链表链式基数排序对车牌进行排序！" << std::endl;
+        std::cout << "排序记录数：" << result.count 
+                  << "，耗时：" << result.timeMs << " 毫秒" << std::endl;
+    }
+    return result;
+}
+
+std::vector<PlateRecord> PlateDatabase::searchByCity(const std::string& city) const {
+    Metrics::Timer timer(metrics, Metrics::OP_CITY);
+    SnapshotPtr snap = snapshot();
+    if (!snap->cityIndexBuilt) {
+        // 索引未建立或已随修改失效：在当前快照上扫描，不为一次查询在写锁内重排整表；
+        // 结果按车牌排序，与分块索引的块内顺序一致
+        if (verbose) std::cout << "城市索引未建立，按顺序扫描（可先建立城市索引以加速）..." << std::endl;
+        std::vector<PlateRecord> result;
+        if (snap->mapped) {
+            // 映射快照只比较城市列，命中的行才解码
+            for (size_t i = 0; i < snap->mapped->size(); ++i) {
+                if (snap->mapped->cityAt(i) == city) result.push_back(snap->mapped->recordAt(i));
+            }
+        } else {
+            snap->records.forEachRun([&](const PlateRecord* first, size_t n, size_t) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (first[i].city == city) result.push_back(first[i]);
+                }
+            });
+        }
+        std::sort(result.begin(), result.end(),
+                  [](const PlateRecord& a, const PlateRecord& b) { return a.plate < b.plate; });
+        return result;
+    }
+    
+    int blockId = SearchAlgorithms::findCityBlock(snap->cityIndex, city);
     if (blockId == -1) {
         return std::vector<PlateRecord>();
     }
     
-    CityBlock& block = cityIndex[blockId];
+    const CityBlock& block = snap->cityIndex[blockId];
     std::vector<PlateRecord> result;
     result.reserve(block.count);
-    
     for (int i = block.start; i < block.start + block.count; ++i) {
-        result.push_back(records[i]);
+        result.push_back(snap->recordAt(i));
     }
-    
     return result;
 }
 
-void PlateDatabase::buildCityIndex() {
-    if (records.empty()) {
-        std::cout << "当前无记录，无法建立索引。" << std::endl;
-        return;
+SnapshotPtr PlateDatabase::ensureCityIndex() const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    SnapshotPtr base = snapshot();
+    if (base->cityIndexBuilt || base->size() == 0) {
+        return base;
     }
     
+    PLATE_TRACE_SCOPE_N("PlateDatabase::buildCityIndex", base->size());
+    std::vector<PlateRecord> records;
+    std::shared_ptr<PlateSnapshot> next = cloneForRewrite(*base, records);
+    MemoryTracker::Hold copy(MemoryTracker::REWRITE, rewriteBytes(records));
+    
     // 按 city, plate 排序
-    std::sort(records.begin(), records.end(),
-              [](const PlateRecord& a, const PlateRecord& b) {
-                  if (a.city != b.city) return a.city < b.city;
-                  return a.plate < b.plate;
-              });
+    {
+        PLATE_TRACE_SCOPE_N("PlateDatabase::cityIndexSort", records.size());
+        std::sort(records.begin(), records.end(),
+                  [](const PlateRecord& a, const PlateRecord& b) {
+                      if (a.city != b.city) return a.city < b.city;
+                      return a.plate < b.plate;
+                  });
+    }
     
-    cityIndex.clear();
+    PLATE_TRACE_SCOPE_N("PlateDatabase::cityIndexScan", records.size());
+    next->cityIndex.clear();
     int n = static_cast<int>(records.size());
     int i = 0;
     
@@ -205,23 +852,59 @@ void PlateDatabase::buildCityIndex() {
             j++;
         }
         
-        cityIndex.emplace_back(records[i].city, i, j - i);
+        next->cityIndex.emplace_back(records[i].city, i, j - i);
         i = j;
     }
     
-    std::sort(cityIndex.begin(), cityIndex.end());
-    cityIndexBuilt = true;
-    sortedByPlate = false;
+    std::sort(next->cityIndex.begin(), next->cityIndex.end());
+    next->records.assign(std::move(records));
+    next->cityIndexBuilt = true;
+    next->sortedByPlate = false;
+    publish(next);
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        invalidatePlateIndex();
+    }
+    
+    return next;
+}
+
+void PlateDatabase::buildCityIndex() {
+    if (snapshot()->size() == 0) {
+        if (verbose) std::cout << "当前无记录，无法建立索引。" << std::endl;
+        return;
+    }
     
-    std::cout << "已建立城市分块索引，共有 " << cityIndex.size() << " 个城市块。" << std::endl;
+    SnapshotPtr snap = ensureCityIndex();
+    if (verbose) std::cout << "已建立城市分块索引，共有 " << snap->cityIndex.size() << " 个城市块。" << std::endl;
 }
 
 std::vector<PlateRecord> PlateDatabase::prefixSearch(const std::string& prefix) const {
-    return SearchAlgorithms::prefixSearch(records, prefix);
+    Metrics::Timer timer(metrics, Metrics::OP_PREFIX);
+    SnapshotPtr snap = snapshot();
+    if (snap->mapped) {
+        return snap->mapped->prefixSearch(prefix);
+    }
+    if (snap->keyIndex && snap->keyIndex->unindexedRows() == 0) {
+        // 前缀换算为编码区间，在读索引上取出匹配的行
+        std::vector<PlateRecord> result;
+        PlateKey lo = 0, hi = 0;
+        if (PlateCodec::prefixRange(prefix, lo, hi)) {
+            std::vector<PlateKeyIndex::Row> rows;
+            snap->keyIndex->rowsInRange(lo, hi, rows);
+            result.reserve(rows.size());
+            for (PlateKeyIndex::Row row : rows) {
+                result.push_back(snap->records[row]);
+            }
+        }
+        return result;
+    }
+    return SearchAlgorithms::prefixSearch(snap->records, prefix);
 }
 
 void PlateDatabase::showAllRecords() const {
-    if (records.empty()) {
+    SnapshotPtr snap = snapshot();
+    if (snap->size() == 0) {
         std::cout << "当前无任何记录。" << std::endl;
         return;
     }
@@ -233,16 +916,19 @@ void PlateDatabase::showAllRecords() const {
               << std::left << std::setw(8)  << "类别" << std::endl;
     std::cout << std::string(60, '-') << std::endl;
     
-    for (const auto& rec : records) {
-        rec.print();
-    }
+    snap->forEachRun([](const PlateRecord* first, size_t n, size_t) {
+        for (size_t i = 0; i < n; ++i) {
+            first[i].print();
+        }
+    });
     
     std::cout << std::string(50, '=') << std::endl;
-    std::cout << "共 " << records.size() << " 条记录" << std::endl;
+    std::cout << "共 " << snap->size() << " 条记录" << std::endl;
 }
 
 void PlateDatabase::showRecord(int index) const {
-    if (index < 0 || index >= static_cast<int>(records.size())) {
+    SnapshotPtr snap = snapshot();
+    if (index < 0 || index >= static_cast<int>(snap->size())) {
         std::cout << "索引越界！" << std::endl;
         return;
     }
@@ -252,22 +938,25 @@ void PlateDatabase::showRecord(int index) const {
               << std::left << std::setw(15) << "车主"
               << std::left << std::setw(8)  << "类别" << std::endl;
     std::cout << std::string(60, '-') << std::endl;
-    records[index].print();
+    snap->recordAt(static_cast<size_t>(index)).print();
 }
 
 void PlateDatabase::statistics() const {
+    SnapshotPtr snap = snapshot();
     std::cout << "\n========== 统计信息 ==========" << std::endl;
-    std::cout << "当前共有记录条数：" << records.size() << std::endl;
+    std::cout << "当前共有记录条数：" << snap->size() << std::endl;
     
-    if (records.empty()) {
+    if (snap->size() == 0) {
         std::cout << "=============================" << std::endl;
         return;
     }
     
     std::unordered_map<std::string, int> cnt;
-    for (const auto& rec : records) {
-        cnt[rec.city]++;
-    }
+    snap->forEachRun([&cnt](const PlateRecord* first, size_t n, size_t) {
+        for (size_t i = 0; i < n; ++i) {
+            cnt[first[i].city]++;
+        }
+    });
     
     std::cout << "各城市车牌数量统计：" << std::endl;
     for (const auto& p : cnt) {
@@ -279,221 +968,854 @@ void PlateDatabase::statistics() const {
 }
 
 int PlateDatabase::getCityCount() const {
-    std::unordered_map<std::string, int> cities;
-    for (const auto& rec : records) {
-        cities[rec.city] = 1;
+    SnapshotPtr snap = snapshot();
+    if (snap->mapped) {
+        // 映射快照直接取城市字典的条目数，不解码记录
+        return static_cast<int>(snap->mapped->cityCount());
+    }
+    if (snap->cityIndexBuilt) {
+        return static_cast<int>(snap->cityIndex.size());
     }
+    // 按块遍历，不拼接整表
+    std::unordered_map<std::string, int> cities;
+    snap->records.forEachRun([&cities](const PlateRecord* first, size_t n, size_t) {
+        for (size_t i = 0; i < n; ++i) {
+            cities[first[i].city] = 1;
+        }
+    });
     return static_cast<int>(cities.size());
 }
 
+// 把快照写成列式快照文件：内存快照逐块写出，不拼接整表
+static bool writeSnapshotFile(const PlateSnapshot& snap, const std::string& filename,
+                              std::uint64_t walSequence = 0, std::uint64_t snapshotId = 0) {
+    if (snap.mapped) {
+        return ColumnarSnapshot::write(filename, snap.mapped->records(), snap.cityIndex,
+                                       snap.sortedByPlate, snap.cityIndexBuilt,
+                                       walSequence, snapshotId);
+    }
+    return ColumnarSnapshot::write(filename, snap.records, snap.cityIndex,
+                                   snap.sortedByPlate, snap.cityIndexBuilt,
+                                   walSequence, snapshotId);
+}
+
+bool PlateDatabase::writeTo(const PlateSnapshot& snap, const std::string& filename,
+                            SaveFormat format, const ProgressFn& progress) const {
+    // 内存快照逐块写出，不拼接整表；映射快照写出解码后的记录
+    const size_t rowCount = snap.size();
+    PLATE_TRACE_SCOPE_N("PlateDatabase::save", rowCount);
+    Metrics::Timer timer(metrics, Metrics::OP_SAVE, rowCount);
+    SaveReport report;
+    bool ok = false;
+    switch (format) {
+        case SAVE_TEXT:
+            ok = snap.mapped ? FileIO::saveToFile(filename, snap.mapped->records(), progress, &report)
+                             : FileIO::saveToFile(filename, snap.records, progress, &report);
+            if (ok) timer.setBytes(report.bytesWritten);
+            return ok;
+        case SAVE_CSV:
+            ok = snap.mapped ? FileIO::exportToCSV(filename, snap.mapped->records(), progress, &report)
+                             : FileIO::exportToCSV(filename, snap.records, progress, &report);
+            if (ok) timer.setBytes(report.bytesWritten);
+            return ok;
+        case SAVE_SNAPSHOT:
+            if (progress && !progress(0, rowCount)) {
+                return false;
+            }
+            if (!writeSnapshotFile(snap, filename)) {
+                return false;
+            }
+            {
+                // 快照写出不经过 SaveReport，按落盘后的文件大小计字节数
+                std::ifstream fin(filename.c_str(), std::ios::binary | std::ios::ate);
+                std::streamoff size = fin ? static_cast<std::streamoff>(fin.tellg()) : 0;
+                if (size > 0) timer.setBytes(static_cast<std::uint64_t>(size));
+            }
+            if (progress) progress(rowCount, rowCount);
+            if (verbose) std::cout << "已保存 " << rowCount << " 条记录到快照：" << filename << std::endl;
+            return true;
+    }
+    return false;
+}
+
 bool PlateDatabase::saveToFile(const std::string& filename) const {
-    return FileIO::saveToFile(filename, records);
+    SnapshotPtr snap = snapshot();
+    return writeTo(*snap, filename, SAVE_TEXT, ProgressFn());
 }
 
 bool PlateDatabase::exportToCSV(const std::string& filename) const {
-    return FileIO::exportToCSV(filename, records);
+    SnapshotPtr snap = snapshot();
+    return writeTo(*snap, filename, SAVE_CSV, ProgressFn());
 }
 
-void PlateDatabase::clearAll() {
-    records.clear();
-    cityIndex.clear();
-    sortedByPlate = false;
-    cityIndexBuilt = false;
-    totalOperations = 0;
-    totalSearches = 0;
-    std::cout << "已清空所有数据。" << std::endl;
+bool PlateDatabase::saveSnapshot(const std::string& filename) const {
+    SnapshotPtr snap = snapshot();
+    return writeTo(*snap, filename, SAVE_SNAPSHOT, ProgressFn());
 }
 
-std::string PlateDatabase::getPerformanceStats() const {
-    std::ostringstream oss;
-    oss << "========== 性能统计 ==========\n";
-    oss << "总操作次数：" << totalOperations << "\n";
-    oss << "总查找次数：" << totalSearches << "\n";
-    oss << "当前记录数：" << records.size() << "\n";
-    oss << "是否已排序：" << (sortedByPlate ? "是" : "否") << "\n";
-    oss << "城市索引已建立：" << (cityIndexBuilt ? "是" : "否") << "\n";
-    
-    if (RadixSort::getLastSortCount() > 0) {
-        oss << "\n【排序统计】\n";
-        oss << "上次排序记录数：" << RadixSort::getLastSortCount() << "\n";
-        oss << "上次排序耗时：" << std::fixed << std::setprecision(2) 
-            << RadixSort::getLastSortTime() << " 毫秒\n";
-        if (RadixSort::getLastSortCount() > 0) {
-            double avgTime = RadixSort::getLastSortTime() / RadixSort::getLastSortCount();
-            oss << "平均每条记录耗时：" << std::fixed << std::setprecision(4) << avgTime << " 毫秒\n";
+std::shared_ptr<const EliasFanoPlateSet> PlateDatabase::buildPlateSet() const {
+    SnapshotPtr snap = snapshot();
+    std::vector<PlateKey> keys;
+    keys.reserve(snap->size());
+    if (snap->mapped) {
+        // 映射快照直接取编码列，不解码记录
+        for (size_t i = 0; i < snap->mapped->size(); ++i) {
+            PlateKey key = snap->mapped->keyAt(i);
+            if (key != PlateCodec::INVALID_KEY) keys.push_back(key);
+        }
+    } else {
+        for (size_t i = 0; i < snap->records.size(); ++i) {
+            PlateKey key = PlateCodec::encode(snap->records[i].plate);
+            if (key != PlateCodec::INVALID_KEY) keys.push_back(key);
         }
     }
-    
-    if (SearchAlgorithms::getLastSearchCount() > 0) {
-        oss << "\n【查找统计】\n";
-        oss << "上次查找比较次数：" << SearchAlgorithms::getLastSearchCount() << "\n";
-        oss << "上次查找耗时：" << std::fixed << std::setprecision(2) 
-            << SearchAlgorithms::getLastSearchTime() << " 毫秒\n";
+    if (!std::is_sorted(keys.begin(), keys.end())) {
+        std::sort(keys.begin(), keys.end());
     }
     
-    // 计算平均查找时间（如果有查找记录）
-    if (totalSearches > 0 && records.size() > 0) {
-        oss << "\n【性能分析】\n";
-        if (sortedByPlate) {
-            oss << "当前使用折半查找，时间复杂度：O(log n)\n";
-            oss << "理论最大比较次数：" << static_cast<int>(std::ceil(std::log2(records.size()))) << "\n";
-        } else {
-            oss << "当前使用顺序查找，时间复杂度：O(n)\n";
-            oss << "理论平均比较次数：" << records.size() / 2 << "\n";
-        }
+    std::shared_ptr<EliasFanoPlateSet> set = std::make_shared<EliasFanoPlateSet>();
+    set->build(keys);
+    return set;
+}
+
+bool PlateDatabase::saveInBackground(const std::string& filename, SaveFormat format,
+                                     const ProgressFn& progress,
+                                     const std::function<void(bool)>& done) {
+    std::lock_guard<std::mutex> lock(saveMutex);
+    if (saving) {
+        return false;
+    }
+    if (saveThread.joinable()) {
+        saveThread.join();
     }
     
-    oss << "=============================";
-    return oss.str();
+    // 快照不可变，持有引用即得到一致的时间点视图，无需复制数据
+    SnapshotPtr snap = snapshot();
+    saving = true;
+    saveThread = std::thread([this, snap, filename, format, progress, done]() {
+        bool ok = writeTo(*snap, filename, format, progress);
+        lastSaveOk = ok;
+        if (done) done(ok);
+        saving = false;
+    });
+    return true;
 }
 
-void PlateDatabase::showPerformanceStats() const {
-    std::cout << "\n" << getPerformanceStats() << std::endl;
+bool PlateDatabase::waitForSave() {
+    std::lock_guard<std::mutex> lock(saveMutex);
+    if (saveThread.joinable()) {
+        saveThread.join();
+    }
+    return lastSaveOk;
 }
 
-bool PlateDatabase::batchImport(const std::vector<PlateRecord>& newRecords) {
-    int validCount = 0;
-    for (const auto& rec : newRecords) {
-        if (Utils::isValidPlate(rec.plate)) {
-            records.push_back(rec);
-            validCount++;
+bool PlateDatabase::openSnapshot(const std::string& filename) {
+    std::shared_ptr<ColumnarSnapshot> mapped = std::make_shared<ColumnarSnapshot>();
+    if (!mapped->open(filename)) {
+        return false;
+    }
+    
+    std::shared_ptr<PlateSnapshot> next = std::make_shared<PlateSnapshot>();
+    next->sortedByPlate = mapped->isSortedByPlate();
+    next->cityIndexBuilt = mapped->isCityIndexBuilt();
+    next->cityIndex = mapped->cityIndex();
+    next->mapped = mapped;
+    
+    // 依次叠加属于该快照的增量文件
+    std::uint64_t baseId = mapped->snapshotId();
+    std::uint64_t seq = 0;
+    RowPatcher patcher(next);
+    for (;;) {
+        std::string path = DeltaFile::pathFor(filename, seq + 1);
+        if (!std::ifstream(path.c_str()).good()) {
+            break;
+        }
+        std::uint64_t id = 0;
+        std::uint64_t deltaSequence = 0;
+        bool cleared = false;
+        std::vector<DeltaChange> list;
+        if (!DeltaFile::read(path, &id, &deltaSequence, &cleared, list) ||
+            id != baseId || deltaSequence != seq + 1) {
+            break;  // 损坏或属于旧基准的残留文件，之后的增量不再可信
         }
+        if (cleared) {
+            patcher.clear();
+        }
+        for (const auto& c : list) {
+            if (c.removed) {
+                patcher.remove(c.record.plate);
+            } else {
+                patcher.upsert(c.record);
+            }
+        }
+        seq++;
     }
+    patcher.finish();
     
-    sortedByPlate = false;
-    cityIndexBuilt = false;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        if (wal && wal->isFailed()) {
+            return rejectReadOnly();
+        }
+        publish(next);
+        {
+            std::lock_guard<std::mutex> state(stateMutex);
+            resetTracking(filename, baseId, seq);
+            occupancy.clear();
+            occupancyBuilt = false;
+            invalidatePlateIndex();
+        }
+    }
+    // 整体替换的数据无法用日志描述，立即写出检查点
+    if (std::atomic_load(&wal) && !writeCheckpoint()) {
+        return false;
+    }
     totalOperations++;
     
-    std::cout << "批量导入完成，成功导入 " << validCount << " 条记录。" << std::endl;
-    return validCount > 0;
+    if (verbose) {
+        std::cout << "已打开快照：" << filename << "，共 " << next->size() << " 条记录";
+        if (seq > 0) std::cout << "（叠加增量 " << seq << " 个）";
+        std::cout << "。" << std::endl;
+    }
+    return true;
 }
 
-std::vector<std::pair<std::string, int>> PlateDatabase::getCityStatistics() const {
-    std::unordered_map<std::string, int> cnt;
-    for (const auto& rec : records) {
-        cnt[rec.city]++;
+void PlateDatabase::trackUpsert(const PlateRecord& rec) {
+    if (deltaBase.empty() || changesOverflow) {
+        return;
+    }
+    changes[rec.plate] = DeltaChange(false, rec);
+    if (changes.size() > MAX_TRACKED_CHANGES) {
+        changes.clear();
+        changesOverflow = true;
     }
+}
+
+void PlateDatabase::trackRemove(const std::string& plate) {
+    if (deltaBase.empty() || changesOverflow) {
+        return;
+    }
+    PlateRecord rec;
+    rec.plate = plate;
+    changes[plate] = DeltaChange(true, rec);
+    if (changes.size() > MAX_TRACKED_CHANGES) {
+        changes.clear();
+        changesOverflow = true;
+    }
+}
+
+void PlateDatabase::trackBatch(std::vector<PlateRecord>::const_iterator first,
+                               std::vector<PlateRecord>::const_iterator last) {
+    if (deltaBase.empty() || changesOverflow) {
+        return;
+    }
+    // 大批量导入时增量不比完整快照小，直接改为下次写完整基准
+    if (changes.size() + static_cast<size_t>(last - first) > MAX_TRACKED_CHANGES) {
+        changes.clear();
+        changesOverflow = true;
+        return;
+    }
+    for (; first != last; ++first) {
+        changes[first->plate] = DeltaChange(false, *first);
+    }
+}
+
+void PlateDatabase::trackClear() {
+    if (deltaBase.empty()) {
+        return;
+    }
+    // 清空之后的状态只需“先清空”一个标志即可描述
+    changes.clear();
+    changesCleared = true;
+    clearEpoch++;
+    changesOverflow = false;
+}
+
+void PlateDatabase::resetTracking(const std::string& base, std::uint64_t baseId,
+                                  std::uint64_t seq) {
+    deltaBase = base;
+    deltaBaseId = baseId;
+    deltaSeq = seq;
+    changes.clear();
+    changesCleared = false;
+    changesOverflow = false;
+}
+
+bool PlateDatabase::saveIncremental(const std::string& baseFile, bool forceFull) {
+    std::lock_guard<std::mutex> serial(deltaMutex);
     
-    std::vector<std::pair<std::string, int>> result;
-    result.reserve(cnt.size());
-    for (const auto& p : cnt) {
-        result.emplace_back(p.first, p.second);
+    std::string base;
+    std::uint64_t baseId = 0;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        base = deltaBase;
+        baseId = deltaBaseId;
     }
     
-    std::sort(result.begin(), result.end(),
-              [](const std::pair<std::string, int>& a,
-                 const std::pair<std::string, int>& b) {
-                  return a.second > b.second; // 按数量降序
-              });
+    // 基准文件可能已被其他保存覆盖，标识一致才能继续追加增量
+    bool baseValid = false;
+    if (!forceFull && base == baseFile && baseId != 0 &&
+        std::ifstream(baseFile.c_str()).good()) {
+        ColumnarSnapshot probe;
+        baseValid = probe.open(baseFile) && probe.snapshotId() == baseId;
+    }
     
-    return result;
+    // 在写锁内同时取得快照并复制变化，二者对应同一时刻；
+    // 变化表要等增量文件落盘后才清除，写入失败时原样保留，下次保存重试
+    SnapshotPtr snap;
+    std::vector<DeltaChange> list;
+    bool cleared = false;
+    bool full = false;
+    std::uint64_t id = 0;
+    std::uint64_t seq = 0;
+    std::uint64_t epoch = 0;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        snap = snapshot();
+        full = !baseValid || deltaBase != base || deltaBaseId != baseId || changesOverflow;
+        if (full) {
+            id = ColumnarSnapshot::newSnapshotId();
+            std::lock_guard<std::mutex> state(stateMutex);
+            resetTracking(baseFile, id, 0);
+        } else {
+            if (changes.empty() && !changesCleared) {
+                if (verbose) std::cout << "自上次保存以来没有变化。" << std::endl;
+                return true;
+            }
+            list.reserve(changes.size());
+            for (const auto& kv : changes) {
+                list.push_back(kv.second);
+            }
+            cleared = changesCleared;
+            id = deltaBaseId;
+            seq = deltaSeq + 1;
+            epoch = clearEpoch;
+        }
+    }
+    
+    bool ok = false;
+    if (full) {
+        ok = writeSnapshotFile(*snap, baseFile, 0, id);
+        if (ok) {
+            // 旧增量属于被替换的基准，已无用
+            DeltaFile::removeAll(baseFile);
+        } else {
+            // 变化已随基准一起重置，下次保存仍须改写完整基准
+            std::lock_guard<std::mutex> lock(writeMutex);
+            std::lock_guard<std::mutex> state(stateMutex);
+            if (deltaBaseId == id) {
+                changesOverflow = true;
+            }
+        }
+    } else {
+        ok = DeltaFile::write(DeltaFile::pathFor(baseFile, seq), id, seq, cleared, list);
+        if (ok) {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            std::lock_guard<std::mutex> state(stateMutex);
+            if (deltaBaseId == id) {
+                deltaSeq = seq;
+                if (clearEpoch == epoch) {
+                    // 只清除已写出的变化；写出期间又变化过的车牌留到下一个增量
+                    changesCleared = false;
+                    for (const auto& c : list) {
+                        auto it = changes.find(c.record.plate);
+                        if (it != changes.end() && sameChange(it->second, c)) {
+                            changes.erase(it);
+                        }
+                    }
+                }
+                // 期间又清空过：变化表已由清空重置，“先清空”标志留给下一个增量
+            }
+        }
+    }
+    
+    if (!ok) {
+        return false;
+    }
+    
+    if (verbose) {
+        if (full) {
+            std::cout << "已写出基准快照：" << baseFile << "，共 " << snap->size() << " 条记录。" << std::endl;
+        } else {
+            std::cout << "增量保存完成：" << list.size() << " 条变化写入 "
+                      << DeltaFile::pathFor(baseFile, seq) << std::endl;
+        }
+    }
+    return true;
 }
 
-std::string PlateDatabase::getValidateDataResult() const {
-    std::ostringstream oss;
-    std::unordered_map<std::string, int> plateCount;
-    int invalidCount = 0;
-    std::vector<std::string> invalidPlates;
-    std::vector<std::string> duplicatePlates;
+bool PlateDatabase::saveDelta(const std::string& baseFile) {
+    return saveIncremental(baseFile, false);
+}
+
+bool PlateDatabase::compactDeltas(const std::string& baseFile) {
+    return saveIncremental(baseFile, true);
+}
+
+std::string PlateDatabase::deltaBasePath() const {
+    std::lock_guard<std::mutex> state(stateMutex);
+    return deltaBase;
+}
+
+size_t PlateDatabase::pendingChangeCount() const {
+    std::lock_guard<std::mutex> state(stateMutex);
+    return changes.size();
+}
+
+bool PlateDatabase::openDurable(const std::string& snapshotPath,
+                                const std::string& walPath) {
+    std::lock_guard<std::mutex> serial(checkpointMutex);
+    std::lock_guard<std::mutex> lock(writeMutex);
     
-    for (const auto& rec : records) {
-        if (!Utils::isValidPlate(rec.plate)) {
-            invalidCount++;
-            invalidPlates.push_back(rec.plate);
+    // 关闭旧日志（析构时把缓冲中的记录刷盘）
+    durable = false;
+    std::atomic_store(&wal, std::shared_ptr<WriteAheadLog>());
+    
+    std::shared_ptr<PlateSnapshot> next = std::make_shared<PlateSnapshot>();
+    std::uint64_t snapshotLsn = 0;
+    
+    if (std::ifstream(snapshotPath.c_str()).good()) {
+        std::shared_ptr<ColumnarSnapshot> mapped = std::make_shared<ColumnarSnapshot>();
+        if (!mapped->open(snapshotPath)) {
+            return false;
         }
-        plateCount[rec.plate]++;
+        next->sortedByPlate = mapped->isSortedByPlate();
+        next->cityIndexBuilt = mapped->isCityIndexBuilt();
+        next->cityIndex = mapped->cityIndex();
+        next->mapped = mapped;
+        snapshotLsn = mapped->walSequence();
     }
     
-    int duplicateCount = 0;
-    for (const auto& p : plateCount) {
-        if (p.second > 1) {
-            duplicateCount += p.second - 1;
-            duplicatePlates.push_back(p.first);
+    RowPatcher patcher(next);
+    size_t replayed = 0;
+    
+    std::uint64_t lastLsn = 0;
+    std::uint64_t validBytes = 0;
+    bool ok = WriteAheadLog::replay(walPath, [&](const WriteAheadLog::Entry& e) {
+        if (e.lsn <= snapshotLsn) {
+            return;  // 已包含在快照中
         }
+        replayed++;
+        switch (e.type) {
+            case WriteAheadLog::ENTRY_ADD:
+                patcher.append(e.record);
+                break;
+            case WriteAheadLog::ENTRY_MODIFY: {
+                PlateRecord* rec = patcher.find(e.record.plate);
+                if (rec) {
+                    rec->city = e.record.city;
+                    rec->owner = e.record.owner;
+                }
+                break;
+            }
+            case WriteAheadLog::ENTRY_DELETE:
+                patcher.remove(e.record.plate);
+                break;
+            case WriteAheadLog::ENTRY_CLEAR:
+                patcher.clear();
+                break;
+            case WriteAheadLog::ENTRY_BATCH_ADD:
+                for (const auto& rec : e.batch) {
+                    patcher.append(rec);
+                }
+                break;
+        }
+    }, &lastLsn, &validBytes);
+    if (!ok) {
+        std::cerr << "预写日志格式错误：" << walPath << std::endl;
+        return false;
+    }
+    
+    patcher.finish();
+    
+    std::shared_ptr<WriteAheadLog> log = std::make_shared<WriteAheadLog>();
+    if (!log->open(walPath, validBytes, std::max(lastLsn, snapshotLsn) + 1)) {
+        std::cerr << "无法打开预写日志：" << walPath << std::endl;
+        return false;
     }
     
-    oss << "========== 数据验证结果 ==========\n";
-    oss << "总记录数：" << records.size() << "\n";
-    oss << "有效记录数：" << (records.size() - invalidCount) << "\n";
-    oss << "非法车牌数：" << invalidCount << "\n";
-    oss << "重复车牌数：" << duplicateCount << "\n";
+    publish(next);
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        resetTracking(std::string(), 0, 0);
+        occupancy.clear();
+        occupancyBuilt = false;
+        invalidatePlateIndex();
+    }
+    std::atomic_store(&wal, log);
+    durable = true;
+    durableSnapshotPath = snapshotPath;
+    totalOperations++;
     
-    bool isValid = (invalidCount == 0 && duplicateCount == 0);
-    oss << "数据完整性：" << (isValid ? "✓ 通过" : "✗ 未通过") << "\n";
+    if (verbose) {
+        std::cout << "已恢复 " << next->size() << " 条记录（回放日志 "
+                  << replayed << " 条）。" << std::endl;
+    }
+    return true;
+}
+
+bool PlateDatabase::writeCheckpoint(std::string* written) {
+    std::lock_guard<std::mutex> serial(checkpointMutex);
     
-    if (invalidCount > 0) {
-        oss << "\n【非法车牌列表】\n";
-        int showCount = std::min(10, static_cast<int>(invalidPlates.size()));
-        for (int i = 0; i < showCount; ++i) {
-            oss << "  " << invalidPlates[i] << "\n";
+    // 在写锁内同时取得快照与日志位置，二者对应同一时刻
+    std::shared_ptr<WriteAheadLog> log;
+    SnapshotPtr snap;
+    std::string path;
+    std::uint64_t lsn = 0;
+    std::uint64_t offset = 0;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        log = wal;
+        // 日志失效后已发布的修改可能未落盘，不能以检查点掩盖
+        if (!log || log->isFailed()) {
+            return false;
         }
-        if (invalidPlates.size() > 10) {
-            oss << "  ... 还有 " << (invalidPlates.size() - 10) << " 个非法车牌\n";
+        snap = snapshot();
+        lsn = log->lastLsn(&offset);
+        path = durableSnapshotPath;
+    }
+    
+    // 快照记录的最大序号须先落盘；写出快照不占写锁
+    if (!log->sync(lsn)) {
+        return false;
+    }
+    if (!writeSnapshotFile(*snap, path, lsn)) {
+        return false;
+    }
+    
+    // 写出返回时快照内容与目录项都已落盘，只截去 lsn 及之前的日志
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (wal != log || !log->truncateThrough(lsn, offset)) {
+        return false;
+    }
+    if (written) *written = path;
+    return true;
+}
+
+bool PlateDatabase::checkpoint() {
+    std::string path;
+    if (!writeCheckpoint(&path)) {
+        return false;
+    }
+    if (verbose) std::cout << "检查点完成：" << path << std::endl;
+    return true;
+}
+
+bool PlateDatabase::isDurable() const {
+    return durable.load();
+}
+
+void PlateDatabase::clearAll() {
+    std::shared_ptr<WriteAheadLog> log;
+    std::uint64_t lsn = 0;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        log = wal;
+        lsn = log ? log->appendClear() : 0;
+        if (log && lsn == 0) {
+            rejectReadOnly();
+            return;
         }
+        publish(std::make_shared<PlateSnapshot>());
+        std::lock_guard<std::mutex> state(stateMutex);
+        trackClear();
+        occupancy.clear();
+        occupancyBuilt = true;
+        invalidatePlateIndex();
+        plateIndexBuilt = true;
     }
+    waitDurable(log, lsn);
+    totalOperations = 0;
+    metrics.reset();
+    if (verbose) std::cout << "已清空所有数据。" << std::endl;
+}
+
+MemoryUsage::MemoryUsage()
+    : recordCount(0), records(0), stringHeap(0), cityIndex(0), occupancy(0), plateIndex(0),
+      keyIndex(0), changeTracking(0), walBuffer(0), mappedFile(0), transientPeakTotal(0) {
+    for (size_t c = 0; c < MemoryTracker::CATEGORY_COUNT; ++c) {
+        transientCurrent[c] = 0;
+        transientPeak[c] = 0;
+    }
+}
+
+size_t MemoryUsage::total() const {
+    return records + stringHeap + cityIndex + occupancy + plateIndex + keyIndex + changeTracking +
+           walBuffer;
+}
+
+size_t MemoryUsage::observedPeak() const {
+    return total() + transientPeakTotal;
+}
+
+std::string MemoryUsage::toString() const {
+    std::ostringstream oss;
+    oss << "常驻合计：" << MemoryTracker::formatBytes(static_cast<double>(total()));
+    if (recordCount > 0) {
+        oss << "（每条记录 " << std::fixed << std::setprecision(1) << bytesPerRecord() << " 字节）";
+    }
+    oss << "\n";
+    oss << "  顺序表：" << MemoryTracker::formatBytes(static_cast<double>(records)) << "\n";
+    oss << "  字符串堆：" << MemoryTracker::formatBytes(static_cast<double>(stringHeap)) << "\n";
+    oss << "  城市索引：" << MemoryTracker::formatBytes(static_cast<double>(cityIndex)) << "\n";
+    oss << "  号段位图：" << MemoryTracker::formatBytes(static_cast<double>(occupancy)) << "\n";
+    oss << "  车牌索引：" << MemoryTracker::formatBytes(static_cast<double>(plateIndex)) << "\n";
+    oss << "  车牌读索引：" << MemoryTracker::formatBytes(static_cast<double>(keyIndex)) << "\n";
+    oss << "  变化跟踪：" << MemoryTracker::formatBytes(static_cast<double>(changeTracking)) << "\n";
+    oss << "  日志缓冲：" << MemoryTracker::formatBytes(static_cast<double>(walBuffer)) << "\n";
+    if (mappedFile > 0) {
+        oss << "映射快照文件：" << MemoryTracker::formatBytes(static_cast<double>(mappedFile))
+            << "（按需调页，不计入合计）\n";
+    }
+    oss << "临时缓冲（当前 / 峰值）：\n";
+    for (size_t c = 0; c < MemoryTracker::CATEGORY_COUNT; ++c) {
+        oss << "  " << MemoryTracker::label(static_cast<MemoryTracker::Category>(c)) << "："
+            << MemoryTracker::formatBytes(static_cast<double>(transientCurrent[c])) << " / "
+            << MemoryTracker::formatBytes(static_cast<double>(transientPeak[c])) << "\n";
+    }
+    oss << "  同时占用峰值：" << MemoryTracker::formatBytes(static_cast<double>(transientPeakTotal)) << "\n";
+    oss << "观测峰值（常驻 + 临时缓冲最高水位）：" << MemoryTracker::formatBytes(static_cast<double>(observedPeak()));
+    return oss.str();
+}
+
+MemoryUsage PlateDatabase::memoryUsage() const {
+    MemoryUsage usage;
+    SnapshotPtr snap = snapshot();
+    usage.recordCount = snap->size();
+    usage.cityIndex = cityIndexBytes(snap->cityIndex);
     
-    if (duplicateCount > 0) {
-        oss << "\n【重复车牌列表】\n";
-        int showCount = std::min(10, static_cast<int>(duplicatePlates.size()));
-        for (int i = 0; i < showCount; ++i) {
-            oss << "  " << duplicatePlates[i] << " (出现 " << plateCount[duplicatePlates[i]] << " 次)\n";
+    // 映射快照的记录只有解码后才占用堆内存
+    bool decoded = false;
+    if (snap->mapped) {
+        usage.mappedFile = snap->mapped->mappedBytes();
+        usage.cityIndex += cityIndexBytes(snap->mapped->cityIndex());
+        decoded = snap->mapped->isDecoded();
+        if (decoded) {
+            usage.records = snap->mapped->records().capacity() * sizeof(PlateRecord);
         }
-        if (duplicatePlates.size() > 10) {
-            oss << "  ... 还有 " << (duplicatePlates.size() - 10) << " 个重复车牌\n";
+    } else {
+        usage.records = snap->records.memoryBytes();
+    }
+    usage.keyIndex = snap->keyIndex ? snap->keyIndex->memoryBytes() : 0;
+    if (!snap->mapped || decoded) {
+        std::lock_guard<std::mutex> lock(memoryMutex);
+        if (memoryStringHeap == NO_CACHE || memoryVersion != snap->version ||
+            memoryDecoded != decoded) {
+            memoryStringHeap = snap->mapped ? stringHeapBytes(snap->mapped->records())
+                                            : stringHeapBytes(snap->records);
+            memoryVersion = snap->version;
+            memoryDecoded = decoded;
         }
+        usage.stringHeap = memoryStringHeap;
     }
     
-    // 验证车牌字母与城市匹配
-    int mismatchCount = 0;
-    std::vector<std::string> mismatchPlates;
-    for (const auto& rec : records) {
-        if (Utils::isValidPlate(rec.plate)) {
-            if (!Utils::validatePlateCityMatch(rec.plate, rec.city)) {
-                mismatchCount++;
-                if (mismatchPlates.size() < 10) {
-                    mismatchPlates.push_back(rec.plate + " (城市: " + rec.city + ")");
-                }
-            }
+    {
+        std::lock_guard<std::mutex> state(stateMutex);
+        usage.occupancy = occupancyBuilt ? occupancy.memoryBytes() : 0;
+        if (plateIndexBuilt) {
+            size_t node = sizeof(std::pair<const PlateKey, size_t>) + sizeof(void*);
+            usage.plateIndex = plateIndex.size() * node + plateIndex.bucket_count() * sizeof(void*);
         }
+        // 哈希表节点：键、值与链指针；另加桶数组
+        if (!changes.empty()) {
+            size_t node = sizeof(std::pair<const std::string, DeltaChange>) + sizeof(void*);
+            usage.changeTracking = changes.size() * node + changes.bucket_count() * sizeof(void*);
+        }
+        for (const auto& change : changes) {
+            usage.changeTracking += MemoryTracker::heapBytes(change.first) +
+                                    recordHeapBytes(change.second.record);
+        }
+    }
+    
+    std::shared_ptr<WriteAheadLog> log = std::atomic_load(&wal);
+    usage.walBuffer = log ? log->bufferBytes() : 0;
+    
+    for (size_t c = 0; c < MemoryTracker::CATEGORY_COUNT; ++c) {
+        MemoryTracker::Category category = static_cast<MemoryTracker::Category>(c);
+        usage.transientCurrent[c] = MemoryTracker::current(category);
+        usage.transientPeak[c] = MemoryTracker::peak(category);
     }
+    usage.transientPeakTotal = MemoryTracker::totalPeak();
+    return usage;
+}
+
+std::string PlateDatabase::getPerformanceStats() const {
+    SnapshotPtr snap = snapshot();
+    size_t recordCount = snap->size();
+    std::uint64_t totalSearches = metrics.stats(Metrics::OP_FIND).calls;
     
-    if (mismatchCount > 0) {
-        oss << "\n【车牌与城市不匹配】\n";
-        oss << "不匹配数量：" << mismatchCount << "\n";
-        for (const auto& plate : mismatchPlates) {
-            oss << "  " << plate << "\n";
+    std::ostringstream oss;
+    oss << "========== 性能统计 ==========\n";
+    oss << "总操作次数：" << totalOperations << "\n";
+    oss << "总查找次数：" << totalSearches << "\n";
+    oss << "当前记录数：" << recordCount << "\n";
+    oss << "是否已排序：" << (snap->sortedByPlate ? "是" : "否") << "\n";
+    oss << "城市索引已建立：" << (snap->cityIndexBuilt ? "是" : "否") << "\n";
+    oss << "快照版本：" << snap->version << "\n";
+    
+    std::shared_ptr<WriteAheadLog> log = std::atomic_load(&wal);
+    if (log) {
+        oss << "\n【预写日志】\n";
+        oss << "日志序号：" << log->lastLsn() << "\n";
+        oss << "本次追加记录数：" << log->entryCount() << "\n";
+        oss << "fsync 次数：" << log->syncCount() << "\n";
+        oss << "日志大小：" << log->bytesWritten() << " 字节\n";
+    }
+    
+    // 延迟分位数来自对数-线性直方图，相对误差不超过 1/16
+    bool latencyHeader = false;
+    for (int op = 0; op < Metrics::OPERATION_COUNT; ++op) {
+        Metrics::Operation kind = static_cast<Metrics::Operation>(op);
+        OperationStats stats = metrics.stats(kind);
+        if (stats.calls == 0) {
+            continue;
         }
-        if (mismatchCount > 10) {
-            oss << "  ... 还有 " << (mismatchCount - 10) << " 个不匹配记录\n";
+        if (!latencyHeader) {
+            oss << "\n【操作延迟】\n";
+            latencyHeader = true;
+        }
+        // 排序、导入、保存、验证按记录数计吞吐，查找按次数
+        bool perRecord = kind == Metrics::OP_SORT || kind == Metrics::OP_IMPORT ||
+                         kind == Metrics::OP_SAVE || kind == Metrics::OP_VALIDATE;
+        oss << Metrics::operationLabel(kind) << "：" << stats.calls << " 次";
+        if (perRecord) {
+            oss << "，" << stats.items << " 条记录";
+        }
+        oss << "\n";
+        if (stats.samples == 0) {
+            continue;
+        }
+        oss << "  p50 " << Metrics::formatNanos(stats.percentile(0.50))
+            << " / p99 " << Metrics::formatNanos(stats.percentile(0.99))
+            << " / p999 " << Metrics::formatNanos(stats.percentile(0.999))
+            << " / 最大 " << Metrics::formatNanos(static_cast<double>(stats.maxNanos)) << "\n";
+        oss << "  吞吐 " << static_cast<long long>(stats.throughput() + 0.5)
+            << (perRecord ? " 条/秒" : " 次/秒");
+        unsigned every = metrics.sampleInterval(kind);
+        if (every > 1) {
+            oss << "（每 " << every << " 次计时一次，共 " << stats.samples << " 个样本）";
+        }
+        oss << "\n";
+    }
+    
+    OperationStats save = metrics.stats(Metrics::OP_SAVE);
+    if (save.bytes > 0) {
+        oss << "\n【导出统计】\n";
+        oss << "累计写出字节数：" << save.bytes << "\n";
+        oss << "写出速度：" << std::fixed << std::setprecision(1)
+            << save.bytesPerSecond() / 1048576.0 << " MB/s\n";
+        oss.unsetf(std::ios::floatfield);
+        oss.precision(6);
+    }
+    
+    oss << "\n【内存占用】\n" << memoryUsage().toString() << "\n";
+    
+    // 计算平均查找时间（如果有查找记录）
+    if (totalSearches > 0 && recordCount > 0) {
+        oss << "\n【性能分析】\n";
+        if (snap->sortedByPlate) {
+            oss << "当前使用折半查找，时间复杂度：O(log n)\n";
+            oss << "理论最大比较次数：" << static_cast<int>(std::ceil(std::log2(recordCount))) << "\n";
+        } else {
+            oss << "当前使用顺序查找，时间复杂度：O(n)\n";
+            oss << "理论平均比较次数：" << recordCount / 2 << "\n";
         }
-    } else {
-        oss << "\n【车牌与城市匹配】✓ 全部匹配\n";
     }
     
     oss << "=============================";
     return oss.str();
 }
 
-bool PlateDatabase::validateData() const {
-    std::string result = getValidateDataResult();
-    std::cout << "\n" << result << std::endl;
+void PlateDatabase::showPerformanceStats() const {
+    std::cout << "\n" << getPerformanceStats() << std::endl;
+}
+
+bool PlateDatabase::batchImport(const std::vector<PlateRecord>& newRecords) {
+    std::vector<PlateRecord> copy(newRecords);
+    return batchImport(std::move(copy));
+}
+
+bool PlateDatabase::batchImport(std::vector<PlateRecord>&& newRecords, size_t* imported) {
+    PLATE_TRACE_SCOPE_N("PlateDatabase::batchImport", newRecords.size());
+    Metrics::Timer timer(metrics, Metrics::OP_IMPORT, 0);
+    
+    // 按批向量化校验（在写锁外进行）；与 Utils::isValidPlate 一致，含小写字母的车牌视为非法
+    std::vector<PlateRecord> added;
+    added.reserve(newRecords.size());
+    PlateBatch batch;
+    for (size_t begin = 0; begin < newRecords.size(); begin += batch.capacity()) {
+        size_t end = std::min(newRecords.size(), begin + batch.capacity());
+        batch.clear();
+        for (size_t i = begin; i < end; ++i) {
+            batch.add(newRecords[i].plate);
+        }
+        batch.classify();
+        for (size_t i = begin; i < end; ++i) {
+            if (batch.isValid(i - begin) && !batch.hasLowercase(i - begin)) {
+                added.push_back(std::move(newRecords[i]));
+            }
+        }
+    }
     
-    std::unordered_map<std::string, int> plateCount;
-    int invalidCount = 0;
-    for (const auto& rec : records) {
-        if (!Utils::isValidPlate(rec.plate)) {
-            invalidCount++;
+    // 导入与跳过的条数在写锁内随发布一并确定
+    size_t published = 0;
+    {
+        std::unique_lock<std::mutex> lock(writeMutex);
+        published = added.size();
+        if (!publishAppended(cloneForWrite(*snapshot()), added, lock)) {
+            return false;
         }
-        plateCount[rec.plate]++;
     }
+    timer.setItems(published);
+    if (imported) *imported = published;
     
-    int duplicateCount = 0;
-    for (const auto& p : plateCount) {
-        if (p.second > 1) {
-            duplicateCount += p.second - 1;
+    if (verbose) {
+        std::cout << "批量导入完成，成功导入 " << published << " 条记录，跳过 "
+                  << newRecords.size() - published << " 条非法记录。" << std::endl;
+    }
+    return published > 0;
+}
+
+std::vector<std::pair<std::string, int>> PlateDatabase::getCityStatistics() const {
+    SnapshotPtr snap = snapshot();
+    std::unordered_map<std::string, int> cnt;
+    snap->forEachRun([&cnt](const PlateRecord* first, size_t n, size_t) {
+        for (size_t i = 0; i < n; ++i) {
+            cnt[first[i].city]++;
         }
+    });
+    
+    std::vector<std::pair<std::string, int>> result;
+    result.reserve(cnt.size());
+    for (const auto& p : cnt) {
+        result.emplace_back(p.first, p.second);
     }
     
-    return invalidCount == 0 && duplicateCount == 0;
+    std::sort(result.begin(), result.end(),
+              [](const std::pair<std::string, int>& a,
+                 const std::pair<std::string, int>& b) {
+                  return a.second > b.second; // 按数量降序
+              });
+    
+    return result;
+}
+
+ValidationReport PlateDatabase::validate(unsigned threads) const {
+    SnapshotPtr snap = snapshot();
+    PLATE_TRACE_SCOPE_N("PlateDatabase::validate", snap->size());
+    Metrics::Timer timer(metrics, Metrics::OP_VALIDATE, snap->size());
+    if (snap->mapped) {
+        return DataValidator::validate(snap->mapped->records(), threads);
+    }
+    return DataValidator::validate(snap->records, threads);
 }
 
+std::string PlateDatabase::getValidateDataResult() const {
+    return validate().toString();
+}
+
+bool PlateDatabase::validateData() const {
+    ValidationReport report = validate();
+    std::cout << "\n" << report.toString() << std::endl;
+    return report.passed();
+}
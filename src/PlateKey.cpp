@@ -0,0 +1,159 @@
+#include "../include/PlateKey.h"
+
+namespace {
+    // 字符分类位
+    const unsigned char CLS_SERIAL = 1;   // 编号字符：数字或字母（排除 I/O）
+    const unsigned char CLS_LETTER = 2;   // 发牌机关字母：A-Z（排除 I/O）
+    const unsigned char CLS_ENERGY = 4;   // 能源类型：D/F
+    
+    // 按字节查表，避免逐字符分支判断；小写字母按大写处理
+    struct CharTable {
+        unsigned char digit[256];   // 37 进制位值（1-36），非字母数字为 0
+        unsigned char cls[256];
+        
+        CharTable() {
+            for (int i = 0; i < 256; ++i) {
+                digit[i] = 0;
+                cls[i] = 0;
+            }
+            for (int c = '0'; c <= '9'; ++c) {
+                digit[c] = static_cast<unsigned char>(c - '0' + 1);
+                cls[c] = CLS_SERIAL;
+            }
+            for (int c = 'A'; c <= 'Z'; ++c) {
+                unsigned char d = static_cast<unsigned char>(c - 'A' + 11);
+                unsigned char k = 0;
+                if (c != 'I' && c != 'O') {
+                    k = CLS_SERIAL | CLS_LETTER;
+                }
+                if (c == 'D' || c == 'F') {
+                    k |= CLS_ENERGY;
+                }
+                digit[c] = d;
+                cls[c] = k;
+                digit[c - 'A' + 'a'] = d;
+                cls[c - 'A' + 'a'] = k;
+            }
+        }
+    };
+    
+    const CharTable TABLE;
+    
+    // “辽”的 UTF-8 编码
+    const unsigned char LIAO[3] = {0xE8, 0xBE, 0xBD};
+    
+    const char DIGIT_CHARS[] = "?0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+}
+
+namespace PlateCodec {
+    PlateKey encode(const char* data, size_t len) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        if ((len != 9 && len != 10) ||
+            p[0] != LIAO[0] || p[1] != LIAO[1] || p[2] != LIAO[2]) {
+            return INVALID_KEY;
+        }
+        
+        if (!(TABLE.cls[p[3]] & CLS_LETTER)) {
+            return INVALID_KEY;
+        }
+        
+        size_t serialStart = 4;
+        if (len == 10) {
+            if (!(TABLE.cls[p[4]] & CLS_ENERGY)) {
+                return INVALID_KEY;
+            }
+            serialStart = 5;
+        }
+        
+        unsigned char all = CLS_SERIAL;
+        for (size_t i = serialStart; i < len; ++i) {
+            all &= TABLE.cls[p[i]];
+        }
+        if (!(all & CLS_SERIAL)) {
+            return INVALID_KEY;
+        }
+        
+        PlateKey key = 0;
+        for (size_t i = 3; i < len; ++i) {
+            key = key * 37 + TABLE.digit[p[i]];
+        }
+        if (len == 9) {
+            key *= 37; // 燃油车末位补 0
+        }
+        return key;
+    }
+    
+    PlateKey encode(const std::string& plate) {
+        return encode(plate.data(), plate.size());
+    }
+    
+    size_t decode(PlateKey key, char* out) {
+        char suffix[7];
+        for (int i = 6; i >= 0; --i) {
+            suffix[i] = DIGIT_CHARS[key % 37];
+            key /= 37;
+        }
+        
+        out[0] = static_cast<char>(LIAO[0]);
+        out[1] = static_cast<char>(LIAO[1]);
+        out[2] = static_cast<char>(LIAO[2]);
+        size_t n = (suffix[6] == '?') ? 6 : 7;
+        for (size_t i = 0; i < n; ++i) {
+            out[3 + i] = suffix[i];
+        }
+        return 3 + n;
+    }
+    
+    std::string decode(PlateKey key) {
+        char buf[MAX_PLATE_BYTES];
+        size_t n = decode(key, buf);
+        return std::string(buf, n);
+    }
+    
+    bool isNewEnergy(PlateKey key) {
+        return key % 37 != 0;
+    }
+    
+    char letterOf(PlateKey key) {
+        for (int i = 0; i < 6; ++i) {
+            key /= 37;
+        }
+        return DIGIT_CHARS[key % 37];
+    }
+    
+    const char* categoryOf(PlateKey key) {
+        return isNewEnergy(key) ? "电车" : "油车";
+    }
+    
+    bool prefixRange(const std::string& prefix, PlateKey& lo, PlateKey& hi) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(prefix.data());
+        size_t head = prefix.size() < 3 ? prefix.size() : 3;
+        for (size_t i = 0; i < head; ++i) {
+            if (p[i] != LIAO[i]) {
+                return false;
+            }
+        }
+        if (prefix.size() > 3 + 7) {
+            return false;
+        }
+        
+        PlateKey value = 0;
+        size_t digits = 0;
+        for (size_t i = 3; i < prefix.size(); ++i) {
+            unsigned char d = TABLE.digit[p[i]];
+            if (d == 0) {
+                return false;
+            }
+            value = value * 37 + d;
+            digits++;
+        }
+        
+        PlateKey scale = 1;
+        for (size_t i = digits; i < 7; ++i) {
+            scale *= 37;
+        }
+        lo = value * scale;
+        hi = (value + 1) * scale;
+        return true;
+    }
+}
@@ -0,0 +1,220 @@
+#include "../include/PlateKeyIndex.h"
+#include "../include/Trace.h"
+#include <algorithm>
+
+namespace {
+    // 覆盖层上限：至少这么多条，另按基底大小放宽，使重建的代价摊到足够多次修改上
+    const size_t MIN_OVERLAY = 4096;
+    const size_t OVERLAY_SHIFT = 6;
+    
+    typedef PlateKeyIndex::Entry Entry;
+    
+    bool entryLess(const Entry& a, const Entry& b) {
+        return a.key < b.key || (a.key == b.key && a.row < b.row);
+    }
+    
+    // 第一个编码不小于 key 的位置，同时累计比较次数
+    const Entry* lowerBound(const Entry* first, const Entry* last, PlateKey key, int& comparisons) {
+        size_t n = static_cast<size_t>(last - first);
+        while (n > 0) {
+            comparisons++;
+            size_t half = n / 2;
+            if (first[half].key < key) {
+                first += half + 1;
+                n -= half + 1;
+            } else {
+                n = half;
+            }
+        }
+        return first;
+    }
+    
+    const Entry* lowerBound(const Entry* first, const Entry* last, PlateKey key) {
+        int ignored = 0;
+        return lowerBound(first, last, key, ignored);
+    }
+    
+    const Entry* entriesBegin(const std::vector<Entry>& v) { return v.data(); }
+    const Entry* entriesEnd(const std::vector<Entry>& v) { return v.data() + v.size(); }
+}
+
+PlateKeyIndex::PlateKeyIndex() : unindexed(0) {
+    // 空索引共用同一个空基底
+    static const std::shared_ptr<const std::vector<Entry>> empty =
+        std::make_shared<const std::vector<Entry>>();
+    base = empty;
+}
+
+std::shared_ptr<const PlateKeyIndex> PlateKeyIndex::build(const RecordTable& records) {
+    PLATE_TRACE_SCOPE_N("PlateKeyIndex::build", records.size());
+    std::shared_ptr<std::vector<Entry>> entries = std::make_shared<std::vector<Entry>>();
+    entries->reserve(records.size());
+    size_t invalid = 0;
+    records.forEachRun([&](const PlateRecord* first, size_t n, size_t start) {
+        for (size_t i = 0; i < n; ++i) {
+            Entry e;
+            e.key = PlateCodec::encode(first[i].plate);
+            e.row = static_cast<Row>(start + i);
+            if (e.key == PlateCodec::INVALID_KEY) {
+                invalid++;
+            } else {
+                entries->push_back(e);
+            }
+        }
+    });
+    // 已按车牌排序的数据无需再排
+    if (!std::is_sorted(entries->begin(), entries->end(), entryLess)) {
+        std::sort(entries->begin(), entries->end(), entryLess);
+    }
+    
+    std::shared_ptr<PlateKeyIndex> index = std::make_shared<PlateKeyIndex>();
+    index->base = entries;
+    index->unindexed = invalid;
+    return index;
+}
+
+SearchResult PlateKeyIndex::find(PlateKey key) const {
+    SearchResult result;
+    if (key == PlateCodec::INVALID_KEY) {
+        return result;
+    }
+    const Entry* o = lowerBound(entriesBegin(overlay), entriesEnd(overlay), key, result.comparisons);
+    if (o != entriesEnd(overlay) && o->key == key) {
+        if (o->row != NO_ROW) result.index = static_cast<int>(o->row);
+        return result;
+    }
+    const Entry* b = lowerBound(entriesBegin(*base), entriesEnd(*base), key, result.comparisons);
+    if (b != entriesEnd(*base) && b->key == key) {
+        result.index = static_cast<int>(b->row);
+    }
+    return result;
+}
+
+void PlateKeyIndex::rowsOf(PlateKey key, std::vector<Row>& out) const {
+    const Entry* o = lowerBound(entriesBegin(overlay), entriesEnd(overlay), key);
+    if (o != entriesEnd(overlay) && o->key == key) {
+        for (; o != entriesEnd(overlay) && o->key == key; ++o) {
+            if (o->row != NO_ROW) out.push_back(o->row);
+        }
+        return;
+    }
+    for (const Entry* b = lowerBound(entriesBegin(*base), entriesEnd(*base), key);
+         b != entriesEnd(*base) && b->key == key; ++b) {
+        out.push_back(b->row);
+    }
+}
+
+void PlateKeyIndex::rowsInRange(PlateKey lo, PlateKey hi, std::vector<Row>& out) const {
+    const Entry* b = lowerBound(entriesBegin(*base), entriesEnd(*base), lo);
+    const Entry* bEnd = lowerBound(b, entriesEnd(*base), hi);
+    const Entry* o = lowerBound(entriesBegin(overlay), entriesEnd(overlay), lo);
+    const Entry* oEnd = lowerBound(o, entriesEnd(overlay), hi);
+    
+    // 两层按编码归并；覆盖层中出现的编码跳过基底中的同一编码
+    while (b != bEnd || o != oEnd) {
+        if (o != oEnd && (b == bEnd || o->key <= b->key)) {
+            PlateKey key = o->key;
+            for (; o != oEnd && o->key == key; ++o) {
+                if (o->row != NO_ROW) out.push_back(o->row);
+            }
+            while (b != bEnd && b->key == key) {
+                ++b;
+            }
+        } else {
+            out.push_back(b->row);
+            ++b;
+        }
+    }
+}
+
+bool PlateKeyIndex::needsRebuild() const {
+    return !canAbsorb(0);
+}
+
+bool PlateKeyIndex::canAbsorb(size_t n) const {
+    return overlay.size() + n <= MIN_OVERLAY + (base->size() >> OVERLAY_SHIFT);
+}
+
+size_t PlateKeyIndex::memoryBytes() const {
+    return (base->capacity() + overlay.capacity()) * sizeof(Entry);
+}
+
+PlateKeyIndex::Editor::Editor(const PlateKeyIndex& from)
+    : source(from), unindexedDelta(0) {
+}
+
+std::vector<PlateKeyIndex::Row>& PlateKeyIndex::Editor::rowsFor(PlateKey key) {
+    auto it = touched.find(key);
+    if (it == touched.end()) {
+        it = touched.insert(std::make_pair(key, std::vector<Row>())).first;
+        source.rowsOf(key, it->second);
+    }
+    return it->second;
+}
+
+void PlateKeyIndex::Editor::insert(PlateKey key, Row row) {
+    if (key == PlateCodec::INVALID_KEY) {
+        unindexedDelta++;
+        return;
+    }
+    rowsFor(key).push_back(row);
+}
+
+void PlateKeyIndex::Editor::erase(PlateKey key, Row row) {
+    if (key == PlateCodec::INVALID_KEY) {
+        unindexedDelta--;
+        return;
+    }
+    std::vector<Row>& rows = rowsFor(key);
+    rows.erase(std::remove(rows.begin(), rows.end(), row), rows.end());
+}
+
+void PlateKeyIndex::Editor::move(PlateKey key, Row from, Row to) {
+    if (key == PlateCodec::INVALID_KEY) {
+        return;
+    }
+    std::vector<Row>& rows = rowsFor(key);
+    std::replace(rows.begin(), rows.end(), from, to);
+}
+
+std::shared_ptr<const PlateKeyIndex> PlateKeyIndex::Editor::commit() const {
+    // 本次改动过的编码：全部现有行，或一条“已无记录”标记
+    std::vector<Entry> changes;
+    changes.reserve(touched.size());
+    for (const auto& kv : touched) {
+        Entry e;
+        e.key = kv.first;
+        if (kv.second.empty()) {
+            e.row = NO_ROW;
+            changes.push_back(e);
+        }
+        for (Row row : kv.second) {
+            e.row = row;
+            changes.push_back(e);
+        }
+    }
+    std::sort(changes.begin(), changes.end(), entryLess);
+    
+    // 与旧覆盖层归并，旧覆盖层中被改动的编码整体换成新条目
+    std::shared_ptr<PlateKeyIndex> next = std::make_shared<PlateKeyIndex>();
+    next->base = source.base;
+    next->unindexed = static_cast<size_t>(static_cast<long long>(source.unindexed) + unindexedDelta);
+    next->overlay.reserve(source.overlay.size() + changes.size());
+    const Entry* o = entriesBegin(source.overlay);
+    const Entry* c = entriesBegin(changes);
+    while (o != entriesEnd(source.overlay) || c != entriesEnd(changes)) {
+        if (c != entriesEnd(changes) && (o == entriesEnd(source.overlay) || c->key <= o->key)) {
+            PlateKey key = c->key;
+            for (; c != entriesEnd(changes) && c->key == key; ++c) {
+                next->overlay.push_back(*c);
+            }
+            while (o != entriesEnd(source.overlay) && o->key == key) {
+                ++o;
+            }
+        } else {
+            next->overlay.push_back(*o);
+            ++o;
+        }
+    }
+    return next;
+}
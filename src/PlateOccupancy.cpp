@@ -0,0 +1,366 @@
+#include "../include/PlateOccupancy.h"
+#include <cctype>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+    const int LETTER_COUNT = 26;
+    const int KIND_COUNT = 3;
+    const int RADIX = 34;
+    
+    // 编号字符表（ASCII 升序，排除 I 和 O）
+    const char SERIAL_CHARS[] = "0123456789ABCDEFGHJKLMNPQRSTUVWXYZ";
+    
+    // 编号字符 → 0-33，非法字符为 -1
+    int serialDigit(char c) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c < 'A' || c > 'Z' || c == 'I' || c == 'O') return -1;
+        int d = 10 + (c - 'A');
+        if (c > 'I') d--;
+        if (c > 'O') d--;
+        return d;
+    }
+    
+    bool validLetter(char letter) {
+        return letter >= 'A' && letter <= 'Z' && letter != 'I' && letter != 'O';
+    }
+    
+    inline unsigned ctz64(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long idx;
+        _BitScanForward64(&idx, x);
+        return static_cast<unsigned>(idx);
+#else
+        unsigned n = 0;
+        while (!(x & 1)) {
+            x >>= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+    
+    // 34 的幂
+    std::uint32_t power34(size_t k) {
+        std::uint32_t r = 1;
+        while (k-- > 0) r *= RADIX;
+        return r;
+    }
+}
+
+PlateOccupancy::PlateOccupancy()
+    : spaces(LETTER_COUNT * KIND_COUNT), occupied(0) {
+}
+
+bool PlateOccupancy::parse(const std::string& plate, char& letter, Kind& kind,
+                           std::uint32_t& serial) {
+    // 辽（UTF-8：0xE8 0xBE 0xBD）+ 字母 + [D/F] + 5 位编号
+    if ((plate.size() != 9 && plate.size() != 10) ||
+        static_cast<unsigned char>(plate[0]) != 0xE8 ||
+        static_cast<unsigned char>(plate[1]) != 0xBE ||
+        static_cast<unsigned char>(plate[2]) != 0xBD) {
+        return false;
+    }
+    
+    letter = static_cast<char>(std::toupper(static_cast<unsigned char>(plate[3])));
+    if (!validLetter(letter)) {
+        return false;
+    }
+    
+    size_t pos = 4;
+    kind = KIND_FUEL;
+    if (plate.size() == 10) {
+        char type = static_cast<char>(std::toupper(static_cast<unsigned char>(plate[4])));
+        if (type == 'D') {
+            kind = KIND_ELECTRIC;
+        } else if (type == 'F') {
+            kind = KIND_HYBRID;
+        } else {
+            return false;
+        }
+        pos = 5;
+    }
+    
+    serial = 0;
+    for (; pos < plate.size(); ++pos) {
+        int d = serialDigit(plate[pos]);
+        if (d < 0) {
+            return false;
+        }
+        serial = serial * RADIX + static_cast<std::uint32_t>(d);
+    }
+    return true;
+}
+
+size_t PlateOccupancy::formatPlate(char letter, Kind kind, std::uint32_t serial, char* out) {
+    char* p = out;
+    *p++ = static_cast<char>(0xE8);
+    *p++ = static_cast<char>(0xBE);
+    *p++ = static_cast<char>(0xBD);
+    *p++ = letter;
+    if (kind == KIND_ELECTRIC) {
+        *p++ = 'D';
+    } else if (kind == KIND_HYBRID) {
+        *p++ = 'F';
+    }
+    for (size_t i = SERIAL_LENGTH; i-- > 0;) {
+        p[i] = SERIAL_CHARS[serial % RADIX];
+        serial /= RADIX;
+    }
+    return static_cast<size_t>(p - out) + SERIAL_LENGTH;
+}
+
+std::string PlateOccupancy::makePlate(char letter, Kind kind, std::uint32_t serial) {
+    char buf[10];
+    return std::string(buf, formatPlate(letter, kind, serial, buf));
+}
+
+PlateOccupancy::Space* PlateOccupancy::spaceFor(char letter, Kind kind, bool create) {
+    letter = static_cast<char>(std::toupper(static_cast<unsigned char>(letter)));
+    if (!validLetter(letter) || kind < KIND_FUEL || kind > KIND_HYBRID) {
+        return nullptr;
+    }
+    Space& space = spaces[(letter - 'A') * KIND_COUNT + kind];
+    if (space.pages.empty() && create) {
+        size_t pageCount = (SERIAL_COUNT + PAGE_BITS - 1) / PAGE_BITS;
+        space.pages.resize(pageCount);
+        space.pageCounts.assign(pageCount, 0);
+    }
+    return &space;
+}
+
+const PlateOccupancy::Space* PlateOccupancy::spaceFor(char letter, Kind kind) const {
+    return const_cast<PlateOccupancy*>(this)->spaceFor(letter, kind, false);
+}
+
+bool PlateOccupancy::test(const std::string& plate) const {
+    char letter;
+    Kind kind;
+    std::uint32_t serial;
+    if (!parse(plate, letter, kind, serial)) {
+        return false;
+    }
+    const Space* space = spaceFor(letter, kind);
+    if (!space || space->pages.empty()) {
+        return false;
+    }
+    const std::vector<std::uint64_t>& page = space->pages[serial / PAGE_BITS];
+    if (page.empty()) {
+        return false;
+    }
+    std::uint32_t bit = serial % PAGE_BITS;
+    return (page[bit >> 6] >> (bit & 63)) & 1;
+}
+
+bool PlateOccupancy::set(const std::string& plate) {
+    char letter;
+    Kind kind;
+    std::uint32_t serial;
+    if (!parse(plate, letter, kind, serial)) {
+        return false;
+    }
+    Space* space = spaceFor(letter, kind, true);
+    std::uint32_t pageIndex = serial / PAGE_BITS;
+    std::vector<std::uint64_t>& page = space->pages[pageIndex];
+    if (page.empty()) {
+        page.assign(PAGE_WORDS, 0);
+    }
+    std::uint32_t bit = serial % PAGE_BITS;
+    std::uint64_t mask = static_cast<std::uint64_t>(1) << (bit & 63);
+    if (page[bit >> 6] & mask) {
+        return false;
+    }
+    page[bit >> 6] |= mask;
+    space->pageCounts[pageIndex]++;
+    occupied++;
+    return true;
+}
+
+bool PlateOccupancy::reset(const std::string& plate) {
+    char letter;
+    Kind kind;
+    std::uint32_t serial;
+    if (!parse(plate, letter, kind, serial)) {
+        return false;
+    }
+    Space* space = spaceFor(letter, kind, false);
+    if (!space || space->pages.empty()) {
+        return false;
+    }
+    std::uint32_t pageIndex = serial / PAGE_BITS;
+    std::vector<std::uint64_t>& page = space->pages[pageIndex];
+    if (page.empty()) {
+        return false;
+    }
+    std::uint32_t bit = serial % PAGE_BITS;
+    std::uint64_t mask = static_cast<std::uint64_t>(1) << (bit & 63);
+    if (!(page[bit >> 6] & mask)) {
+        return false;
+    }
+    page[bit >> 6] &= ~mask;
+    if (--space->pageCounts[pageIndex] == 0) {
+        std::vector<std::uint64_t>().swap(page);  // 空页归还内存
+    }
+    occupied--;
+    return true;
+}
+
+void PlateOccupancy::clear() {
+    std::vector<Space>(LETTER_COUNT * KIND_COUNT).swap(spaces);
+    occupied = 0;
+}
+
+size_t PlateOccupancy::memoryBytes() const {
+    size_t bytes = sizeof(*this) + spaces.capacity() * sizeof(Space);
+    for (const auto& space : spaces) {
+        bytes += space.pages.capacity() * sizeof(std::vector<std::uint64_t>);
+        bytes += space.pageCounts.capacity() * sizeof(std::uint32_t);
+        for (const auto& page : space.pages) {
+            bytes += page.capacity() * sizeof(std::uint64_t);
+        }
+    }
+    return bytes;
+}
+
+void PlateOccupancy::takeFree(Space& space, std::uint32_t first, std::uint32_t last, size_t n,
+                              std::vector<std::uint32_t>& out) {
+    size_t taken = 0;
+    std::uint32_t serial = first;
+    while (serial < last && taken < n) {
+        std::uint32_t pageIndex = serial / PAGE_BITS;
+        std::uint32_t pageEnd = (pageIndex + 1) * PAGE_BITS;
+        if (pageEnd > last) pageEnd = last;
+        
+        // 整页占满时跳过
+        if (space.pageCounts[pageIndex] == PAGE_BITS) {
+            serial = pageEnd;
+            continue;
+        }
+        
+        std::vector<std::uint64_t>& page = space.pages[pageIndex];
+        if (page.empty()) {
+            page.assign(PAGE_WORDS, 0);
+        }
+        
+        while (serial < pageEnd && taken < n) {
+            std::uint32_t bit = serial % PAGE_BITS;
+            std::uint32_t word = bit >> 6;
+            std::uint64_t freeBits = ~page[word] & (~static_cast<std::uint64_t>(0) << (bit & 63));
+            
+            // 截掉区间终点之后的位
+            std::uint32_t wordEnd = pageIndex * PAGE_BITS + (word + 1) * 64;
+            if (wordEnd > pageEnd) {
+                freeBits &= (static_cast<std::uint64_t>(1) << (pageEnd - (wordEnd - 64))) - 1;
+            }
+            
+            while (freeBits != 0 && taken < n) {
+                unsigned b = ctz64(freeBits);
+                freeBits &= freeBits - 1;
+                page[word] |= static_cast<std::uint64_t>(1) << b;
+                space.pageCounts[pageIndex]++;
+                occupied++;
+                out.push_back(pageIndex * PAGE_BITS + word * 64 + b);
+                taken++;
+            }
+            serial = wordEnd < pageEnd ? wordEnd : pageEnd;
+        }
+    }
+}
+
+std::string PlateOccupancy::allocateFrom(char letter, Kind kind, std::uint32_t start) {
+    Space* space = spaceFor(letter, kind, true);
+    if (!space) {
+        return std::string();
+    }
+    letter = static_cast<char>(std::toupper(static_cast<unsigned char>(letter)));
+    start %= SERIAL_COUNT;
+    
+    std::vector<std::uint32_t> found;
+    takeFree(*space, start, SERIAL_COUNT, 1, found);
+    if (found.empty()) {
+        takeFree(*space, 0, start, 1, found);
+    }
+    return found.empty() ? std::string() : makePlate(letter, kind, found[0]);
+}
+
+std::vector<std::string> PlateOccupancy::allocate(char letter, Kind kind, size_t n,
+                                                  const std::string& pattern) {
+    std::vector<std::string> result;
+    Space* space = spaceFor(letter, kind, true);
+    if (!space || n == 0) {
+        return result;
+    }
+    letter = static_cast<char>(std::toupper(static_cast<unsigned char>(letter)));
+    
+    // 解析模式：-1 表示任意字符
+    int digits[SERIAL_LENGTH];
+    for (size_t i = 0; i < SERIAL_LENGTH; ++i) {
+        digits[i] = -1;
+    }
+    if (!pattern.empty()) {
+        if (pattern.size() != SERIAL_LENGTH) {
+            return result;
+        }
+        for (size_t i = 0; i < SERIAL_LENGTH; ++i) {
+            if (pattern[i] != '?') {
+                digits[i] = serialDigit(pattern[i]);
+                if (digits[i] < 0) {
+                    return result;
+                }
+            }
+        }
+    }
+    
+    // 末尾连续的任意位构成一段连续编号，只需枚举前面各位的组合
+    size_t tail = 0;
+    while (tail < SERIAL_LENGTH && digits[SERIAL_LENGTH - 1 - tail] < 0) {
+        tail++;
+    }
+    size_t lead = SERIAL_LENGTH - tail;
+    std::uint32_t runLength = power34(tail);
+    
+    int odometer[SERIAL_LENGTH];
+    for (size_t i = 0; i < lead; ++i) {
+        odometer[i] = digits[i] < 0 ? 0 : digits[i];
+    }
+    
+    std::vector<std::uint32_t> found;
+    for (;;) {
+        std::uint32_t start = 0;
+        for (size_t i = 0; i < lead; ++i) {
+            start = start * RADIX + static_cast<std::uint32_t>(odometer[i]);
+        }
+        start *= runLength;
+        takeFree(*space, start, start + runLength, n - found.size(), found);
+        if (found.size() >= n) {
+            break;
+        }
+        
+        // 从最低的任意位开始进位，全部回绕（或没有任意位）时结束
+        bool advanced = false;
+        for (size_t i = lead; i-- > 0;) {
+            if (digits[i] >= 0) {
+                continue;
+            }
+            if (++odometer[i] < RADIX) {
+                advanced = true;
+                break;
+            }
+            odometer[i] = 0;
+        }
+        if (!advanced) {
+            break;
+        }
+    }
+    
+    result.reserve(found.size());
+    for (std::uint32_t serial : found) {
+        result.push_back(makePlate(letter, kind, serial));
+    }
+    return result;
+}
@@ -1,85 +1,107 @@
 #include "../include/RadixSort.h"
+#include "../include/Trace.h"
 #include "../include/Utils.h"
 #include <algorithm>
 #include <chrono>
 #include <cstring>
 
-int RadixSort::lastSortCount = 0;
-double RadixSort::lastSortTime = 0.0;
-
-bool RadixSort::sort(std::vector<PlateRecord>& records) {
+SortResult RadixSort::sort(std::vector<PlateRecord>& records) {
+    SortResult result;
     int n = static_cast<int>(records.size());
+    PLATE_TRACE_SCOPE_N("RadixSort::sort", n);
     if (n <= 1) {
-        lastSortCount = n;
-        lastSortTime = 0.0;
-        return true;
+        result.success = true;
+        result.count = n;
+        return result;
     }
     
     auto start = std::chrono::high_resolution_clock::now();
     
-    const int RADIX = 36;  // 0-9, A-Z 共36个字符
-    const int LEN = 7;     // 车牌长度固定为7
+    // 0 号桶留给“已超出车牌长度”的位置，使短车牌排在同前缀的长车牌之前；
+    // 1-36 号桶依次对应 0-9, A-Z，与字符串字典序一致
+    const int RADIX = 37;
     
-    // 创建静态链表，使用 1..n 作为有效节点
-    std::vector<RadixNode> nodes(n + 1);
-    for (int i = 1; i <= n; ++i) {
-        nodes[i].plate = records[i - 1].plate;
-        nodes[i].indexInSeq = i - 1;
-        nodes[i].next = i + 1;
+    // 燃油车 9 字节、新能源车 10 字节（“辽”占 3 字节），按最长车牌逐位分配
+    size_t maxLen = 0;
+    RadixNodeList nodes(n + 1);
+    {
+        PLATE_TRACE_SCOPE_N("RadixSort::buildList", n);
+        for (const auto& rec : records) {
+            maxLen = std::max(maxLen, rec.plate.size());
+        }
+        
+        // 创建静态链表，使用 1..n 作为有效节点
+        for (int i = 1; i <= n; ++i) {
+            nodes[i].plate = records[i - 1].plate;
+            nodes[i].indexInSeq = i - 1;
+            nodes[i].next = i + 1;
+        }
+        nodes[n].next = 0; // 链尾
     }
-    nodes[n].next = 0; // 链尾
+    const int LEN = static_cast<int>(maxLen);
     int head = 1;
     
     std::vector<int> bucketHead(RADIX, 0);
     std::vector<int> bucketTail(RADIX, 0);
     
-    // LSD基数排序：从最低位（第6位）到最高位（第0位）
+    // LSD基数排序：从最低位（最后一个字节）到最高位（第0位）
     for (int pos = LEN - 1; pos >= 0; --pos) {
         // 初始化桶
         std::fill(bucketHead.begin(), bucketHead.end(), 0);
         std::fill(bucketTail.begin(), bucketTail.end(), 0);
         
         // 分配阶段
-        int p = head;
-        while (p != 0) {
-            char c = nodes[p].plate[pos];
-            int k = Utils::charToBucketIndex(c);
-            
-            if (bucketHead[k] == 0) {
-                bucketHead[k] = p;
-            } else {
-                nodes[bucketTail[k]].next = p;
+        {
+            PLATE_TRACE_SCOPE_N("RadixSort::distribute", pos);
+            int p = head;
+            while (p != 0) {
+                const std::string& plate = nodes[p].plate;
+                int k = (pos < static_cast<int>(plate.size()))
+                    ? Utils::charToBucketIndex(plate[pos]) + 1
+                    : 0;
+                
+                if (bucketHead[k] == 0) {
+                    bucketHead[k] = p;
+                } else {
+                    nodes[bucketTail[k]].next = p;
+                }
+                bucketTail[k] = p;
+                
+                int next = nodes[p].next;
+                nodes[p].next = 0; // 暂时断开
+                p = next;
             }
-            bucketTail[k] = p;
-            
-            int next = nodes[p].next;
-            nodes[p].next = 0; // 暂时断开
-            p = next;
         }
         
         // 收集阶段
+        PLATE_TRACE_SCOPE_N("RadixSort::collect", pos);
         head = collect(nodes, bucketHead, bucketTail);
     }
     
     // 根据排序后的链表重排顺序表
-    std::vector<PlateRecord> newRecords;
-    newRecords.reserve(n);
-    int p = head;
-    while (p != 0) {
-        newRecords.push_back(records[nodes[p].indexInSeq]);
-        p = nodes[p].next;
+    {
+        PLATE_TRACE_SCOPE_N("RadixSort::reorder", n);
+        std::vector<PlateRecord> newRecords;
+        newRecords.reserve(n);
+        MemoryTracker::Hold hold(MemoryTracker::SORT, newRecords.capacity() * sizeof(PlateRecord));
+        int p = head;
+        while (p != 0) {
+            newRecords.push_back(std::move(records[nodes[p].indexInSeq]));
+            p = nodes[p].next;
+        }
+        records.swap(newRecords);
     }
-    records.swap(newRecords);
     
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    lastSortTime = duration.count() / 1000.0; // 转换为毫秒
-    lastSortCount = n;
+    result.success = true;
+    result.count = n;
+    result.timeMs = duration.count() / 1000.0; // 转换为毫秒
     
-    return true;
+    return result;
 }
 
-int RadixSort::collect(std::vector<RadixNode>& nodes,
+int RadixSort::collect(RadixNodeList& nodes,
                       const std::vector<int>& bucketHead,
                       const std::vector<int>& bucketTail) {
     int head = 0;
@@ -104,7 +126,7 @@ int RadixSort::collect(std::vector<RadixNode>& nodes,
     return head;
 }
 
-void RadixSort::distribute(const std::vector<RadixNode>& nodes, 
+void RadixSort::distribute(const RadixNodeList& nodes, 
                           int head, int pos,
                           std::vector<int>& bucketHead, 
                           std::vector<int>& bucketTail) {
@@ -0,0 +1,140 @@
+#include "../include/RecordTable.h"
+
+RecordTable::RecordTable() : count(0), ownChunks(0) {
+}
+
+RecordTable::RecordTable(const RecordTable& other)
+    : base(other.base), chunks(other.chunks), count(other.count), ownChunks(other.ownChunks) {
+}
+
+RecordTable& RecordTable::operator=(const RecordTable& other) {
+    if (this != &other) {
+        base = other.base;
+        chunks = other.chunks;
+        count = other.count;
+        ownChunks = other.ownChunks;
+    }
+    return *this;
+}
+
+RecordTable::Chunk& RecordTable::mutableChunk(size_t c) {
+    std::shared_ptr<Chunk>& chunk = chunks[c];
+    if (!chunk) {
+        // 从基底复制本块已有的行
+        size_t start = c << CHUNK_SHIFT;
+        size_t end = count - start < CHUNK_SIZE ? count : start + CHUNK_SIZE;
+        chunk = std::make_shared<Chunk>();
+        chunk->reserve(CHUNK_SIZE);
+        chunk->assign(base->begin() + start, base->begin() + end);
+        ownChunks++;
+    } else if (chunk.use_count() > 1) {
+        // 仍与其他记录表共享：复制后再改
+        std::shared_ptr<Chunk> copy = std::make_shared<Chunk>();
+        copy->reserve(CHUNK_SIZE);
+        copy->assign(chunk->begin(), chunk->end());
+        chunk = copy;
+    }
+    return *chunk;
+}
+
+void RecordTable::addChunk() {
+    chunks.push_back(std::make_shared<Chunk>());
+    chunks.back()->reserve(CHUNK_SIZE);
+    ownChunks++;
+}
+
+PlateRecord& RecordTable::mutableAt(size_t i) {
+    return mutableChunk(i >> CHUNK_SHIFT)[i & (CHUNK_SIZE - 1)];
+}
+
+void RecordTable::push_back(const PlateRecord& rec) {
+    if ((count & (CHUNK_SIZE - 1)) == 0) {
+        addChunk();
+    }
+    mutableChunk(count >> CHUNK_SHIFT).push_back(rec);
+    count++;
+}
+
+void RecordTable::append(std::vector<PlateRecord>&& rows) {
+    if (count == 0) {
+        assign(std::move(rows));
+        return;
+    }
+    chunks.reserve((count + rows.size() + CHUNK_SIZE - 1) >> CHUNK_SHIFT);
+    size_t i = 0;
+    while (i < rows.size()) {
+        if ((count & (CHUNK_SIZE - 1)) == 0) {
+            addChunk();
+        }
+        // 一次填满当前末块
+        Chunk& tail = mutableChunk(count >> CHUNK_SHIFT);
+        size_t room = CHUNK_SIZE - (count & (CHUNK_SIZE - 1));
+        size_t n = rows.size() - i < room ? rows.size() - i : room;
+        for (size_t k = 0; k < n; ++k) {
+            tail.push_back(std::move(rows[i + k]));
+        }
+        i += n;
+        count += n;
+    }
+    rows.clear();
+}
+
+void RecordTable::swapRemove(size_t i) {
+    size_t last = count - 1;
+    if (i != last) {
+        PlateRecord& slot = mutableAt(i);
+        slot = std::move(mutableAt(last));
+    }
+    size_t c = last >> CHUNK_SHIFT;
+    if ((last & (CHUNK_SIZE - 1)) == 0) {
+        // 末块只剩这一行，整块去掉
+        if (chunks[c]) ownChunks--;
+        chunks.pop_back();
+    } else if (chunks[c]) {
+        mutableChunk(c).pop_back();
+    }
+    // 末块取自基底时只需缩短行数，基底本身不变
+    count--;
+}
+
+void RecordTable::assign(std::vector<PlateRecord>&& rows) {
+    std::shared_ptr<std::vector<PlateRecord>> owned = std::make_shared<std::vector<PlateRecord>>();
+    owned->swap(rows);
+    share(owned);
+}
+
+void RecordTable::share(const std::shared_ptr<const std::vector<PlateRecord>>& rows) {
+    base = rows;
+    count = rows ? rows->size() : 0;
+    chunks.assign((count + CHUNK_SIZE - 1) >> CHUNK_SHIFT, std::shared_ptr<Chunk>());
+    ownChunks = 0;
+}
+
+void RecordTable::clear() {
+    base.reset();
+    std::vector<std::shared_ptr<Chunk>>().swap(chunks);
+    count = 0;
+    ownChunks = 0;
+}
+
+std::vector<PlateRecord> RecordTable::toVector() const {
+    std::vector<PlateRecord> rows;
+    rows.reserve(count);
+    forEachRun([&rows](const PlateRecord* first, size_t n, size_t) {
+        rows.insert(rows.end(), first, first + n);
+    });
+    return rows;
+}
+
+size_t RecordTable::memoryBytes() const {
+    size_t bytes = chunks.capacity() * sizeof(std::shared_ptr<Chunk>);
+    if (base) {
+        bytes += base->capacity() * sizeof(PlateRecord);
+    }
+    for (const auto& chunk : chunks) {
+        if (chunk) {
+            bytes += chunk->capacity() * sizeof(PlateRecord);
+        }
+    }
+    return bytes;
+}
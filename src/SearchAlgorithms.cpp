@@ -1,68 +1,89 @@
 #include "../include/SearchAlgorithms.h"
+#include "../include/Trace.h"
 #include "../include/Utils.h"
 #include <algorithm>
-#include <chrono>
 
-int SearchAlgorithms::lastSearchCount = 0;
-double SearchAlgorithms::lastSearchTime = 0.0;
-
-int SearchAlgorithms::binarySearch(const std::vector<PlateRecord>& records, 
-                                  const std::string& plate) {
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    int l = 0, r = static_cast<int>(records.size()) - 1;
-    int comparisons = 0;
-    
-    while (l <= r) {
-        comparisons++;
-        int mid = l + (r - l) / 2;
-        if (records[mid].plate == plate) {
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-            lastSearchTime = duration.count() / 1000.0;
-            lastSearchCount = comparisons;
-            return mid;
-        } else if (records[mid].plate < plate) {
-            l = mid + 1;
-        } else {
-            r = mid - 1;
+namespace {
+    // 顺序表与分块记录表共用的实现，只要求 size() 与 operator[]
+    template <typename Rows>
+    SearchResult binarySearchIn(const Rows& records, const std::string& plate) {
+        SearchResult result;
+        int l = 0, r = static_cast<int>(records.size()) - 1;
+        
+        while (l <= r) {
+            result.comparisons++;
+            int mid = l + (r - l) / 2;
+            if (records[mid].plate == plate) {
+                result.index = mid;
+                break;
+            } else if (records[mid].plate < plate) {
+                l = mid + 1;
+            } else {
+                r = mid - 1;
+            }
         }
+        
+        return result;
     }
     
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    lastSearchTime = duration.count() / 1000.0;
-    lastSearchCount = comparisons;
-    
-    return -1;
-}
-
-int SearchAlgorithms::linearSearch(const std::vector<PlateRecord>& records,
-                                  const std::string& plate) {
-    auto start = std::chrono::high_resolution_clock::now();
-    
-    int comparisons = 0;
-    for (size_t i = 0; i < records.size(); ++i) {
-        comparisons++;
-        if (records[i].plate == plate) {
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-            lastSearchTime = duration.count() / 1000.0;
-            lastSearchCount = comparisons;
-            return static_cast<int>(i);
+    template <typename Rows>
+    SearchResult linearSearchIn(const Rows& records, const std::string& plate) {
+        SearchResult result;
+        for (size_t i = 0; i < records.size(); ++i) {
+            result.comparisons++;
+            if (records[i].plate == plate) {
+                result.index = static_cast<int>(i);
+                break;
+            }
         }
+        
+        return result;
     }
     
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-    lastSearchTime = duration.count() / 1000.0;
-    lastSearchCount = comparisons;
-    
-    return -1;
+    template <typename Rows>
+    std::vector<PlateRecord> prefixSearchIn(const Rows& records, const std::string& prefix) {
+        std::vector<PlateRecord> result;
+        std::string upperPrefix = Utils::toUpperStr(prefix);
+        
+        for (size_t i = 0; i < records.size(); ++i) {
+            const PlateRecord& rec = records[i];
+            if (rec.plate.size() >= upperPrefix.size() &&
+                rec.plate.compare(0, upperPrefix.size(), upperPrefix) == 0) {
+                result.push_back(rec);
+            }
+        }
+        
+        return result;
+    }
+}
+
+SearchResult SearchAlgorithms::binarySearch(const std::vector<PlateRecord>& records, 
+                                           const std::string& plate) {
+    PLATE_TRACE_SCOPE("SearchAlgorithms::binarySearch");
+    return binarySearchIn(records, plate);
+}
+
+SearchResult SearchAlgorithms::binarySearch(const RecordTable& records,
+                                           const std::string& plate) {
+    PLATE_TRACE_SCOPE("SearchAlgorithms::binarySearch");
+    return binarySearchIn(records, plate);
+}
+
+SearchResult SearchAlgorithms::linearSearch(const std::vector<PlateRecord>& records,
+                                           const std::string& plate) {
+    PLATE_TRACE_SCOPE("SearchAlgorithms::linearSearch");
+    return linearSearchIn(records, plate);
+}
+
+SearchResult SearchAlgorithms::linearSearch(const RecordTable& records,
+                                           const std::string& plate) {
+    PLATE_TRACE_SCOPE("SearchAlgorithms::linearSearch");
+    return linearSearchIn(records, plate);
 }
 
 int SearchAlgorithms::findCityBlock(const std::vector<CityBlock>& cityIndex,
                                    const std::string& city) {
+    PLATE_TRACE_SCOPE("SearchAlgorithms::findCityBlock");
     int l = 0, r = static_cast<int>(cityIndex.size()) - 1;
     while (l <= r) {
         int mid = l + (r - l) / 2;
@@ -80,16 +101,13 @@ int SearchAlgorithms::findCityBlock(const std::vector<CityBlock>& cityIndex,
 std::vector<PlateRecord> SearchAlgorithms::prefixSearch(
     const std::vector<PlateRecord>& records,
     const std::string& prefix) {
-    std::vector<PlateRecord> result;
-    std::string upperPrefix = Utils::toUpperStr(prefix);
-    
-    for (const auto& rec : records) {
-        if (rec.plate.size() >= upperPrefix.size() &&
-            rec.plate.compare(0, upperPrefix.size(), upperPrefix) == 0) {
-            result.push_back(rec);
-        }
-    }
-    
-    return result;
+    PLATE_TRACE_SCOPE_N("SearchAlgorithms::prefixSearch", records.size());
+    return prefixSearchIn(records, prefix);
 }
 
+std::vector<PlateRecord> SearchAlgorithms::prefixSearch(
+    const RecordTable& records,
+    const std::string& prefix) {
+    PLATE_TRACE_SCOPE_N("SearchAlgorithms::prefixSearch", records.size());
+    return prefixSearchIn(records, prefix);
+}
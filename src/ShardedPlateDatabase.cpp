@@ -0,0 +1,234 @@
+#include "../include/ShardedPlateDatabase.h"
+#include "../include/FileIO.h"
+#include "../include/Parallel.h"
+#include "../include/Utils.h"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+
+// 有效车牌字母：A-Z 排除 I 和 O，共 24 个
+static const int SHARD_COUNT = 24;
+
+ShardedPlateDatabase::ShardedPlateDatabase() {
+    shards.reserve(SHARD_COUNT);
+    for (int i = 0; i < SHARD_COUNT; ++i) {
+        shards.push_back(std::unique_ptr<PlateDatabase>(new PlateDatabase()));
+        shards.back()->setVerbose(false);
+    }
+}
+
+int ShardedPlateDatabase::shardCount() {
+    return SHARD_COUNT;
+}
+
+int ShardedPlateDatabase::shardOf(const std::string& plate) {
+    char c = Utils::extractPlateLetter(plate);
+    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    if (c < 'A' || c > 'Z' || c == 'I' || c == 'O') {
+        return -1;
+    }
+    // 跳过 I 和 O 后的连续编号
+    return (c - 'A') - (c > 'I' ? 1 : 0) - (c > 'O' ? 1 : 0);
+}
+
+char ShardedPlateDatabase::shardLetter(int shardId) {
+    char c = static_cast<char>('A' + shardId);
+    if (c >= 'I') c++;
+    if (c >= 'O') c++;
+    return c;
+}
+
+template <typename Query>
+std::vector<PlateRecord> ShardedPlateDatabase::gather(Query query) const {
+    std::vector<std::vector<PlateRecord>> parts(shards.size());
+    Parallel::forEach(shards.size(), [&](size_t i) {
+        parts[i] = query(*shards[i]);
+    });
+    
+    size_t total = 0;
+    for (const auto& part : parts) {
+        total += part.size();
+    }
+    
+    std::vector<PlateRecord> result;
+    result.reserve(total);
+    for (auto& part : parts) {
+        std::move(part.begin(), part.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+bool ShardedPlateDatabase::addRecord(const std::string& plate,
+                                     const std::string& city,
+                                     const std::string& owner) {
+    std::string upperPlate = Utils::toUpperStr(plate);
+    int id = shardOf(upperPlate);
+    if (id == -1 || !Utils::isValidPlate(upperPlate)) {
+        std::cout << "车牌号格式非法，录入失败！" << std::endl;
+        return false;
+    }
+    
+    if (!shards[id]->addRecord(upperPlate, city, owner)) {
+        std::cout << "车牌号已存在，录入失败！" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ShardedPlateDatabase::modifyRecord(const std::string& plate,
+                                        const std::string& newCity,
+                                        const std::string& newOwner) {
+    int id = shardOf(plate);
+    if (id == -1 || !shards[id]->modifyRecord(plate, newCity, newOwner)) {
+        std::cout << "未找到该车牌号！" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ShardedPlateDatabase::deleteRecord(const std::string& plate) {
+    int id = shardOf(plate);
+    if (id == -1 || !shards[id]->deleteRecord(plate)) {
+        std::cout << "未找到该车牌号！" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ShardedPlateDatabase::findRecord(const std::string& plate, PlateRecord* out) const {
+    std::string upperPlate = Utils::toUpperStr(plate);
+    int id = shardOf(upperPlate);
+    if (id == -1) {
+        return false;
+    }
+    
+    return shards[id]->getRecord(upperPlate, out);
+}
+
+size_t ShardedPlateDatabase::batchImport(std::vector<PlateRecord> newRecords) {
+    // 按车牌字母分组（非法车牌直接丢弃）
+    std::vector<std::vector<PlateRecord>> groups(shards.size());
+    for (auto& rec : newRecords) {
+        int id = shardOf(rec.plate);
+        if (id != -1) {
+            groups[id].push_back(std::move(rec));
+        }
+    }
+    
+    // 各分片在自己的写锁内报告实际发布的条数；并发写者的修改不会算进来
+    std::vector<size_t> published(shards.size(), 0);
+    Parallel::forEach(shards.size(), [&](size_t i) {
+        if (!groups[i].empty()) {
+            shards[i]->batchImport(std::move(groups[i]), &published[i]);
+        }
+    });
+    
+    size_t imported = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        imported += published[i];
+    }
+    
+    std::cout << "分片批量导入完成，成功导入 " << imported << " 条记录，跳过 "
+              << newRecords.size() - imported << " 条非法记录。" << std::endl;
+    return imported;
+}
+
+bool ShardedPlateDatabase::loadFromFile(const std::string& filename) {
+    std::vector<PlateRecord> newRecords;
+    if (!FileIO::loadFromFile(filename, newRecords)) {
+        return false;
+    }
+    batchImport(std::move(newRecords));
+    return true;
+}
+
+void ShardedPlateDatabase::radixSortByPlate() {
+    Parallel::forEach(shards.size(), [&](size_t i) {
+        shards[i]->radixSortByPlate();
+    });
+}
+
+void ShardedPlateDatabase::buildCityIndex() {
+    Parallel::forEach(shards.size(), [&](size_t i) {
+        shards[i]->buildCityIndex();
+    });
+}
+
+std::vector<PlateRecord> ShardedPlateDatabase::prefixSearch(const std::string& prefix) const {
+    std::string upperPrefix = Utils::toUpperStr(prefix);
+    
+    // 前缀已包含“辽+字母”时只需查询该字母对应的分片
+    if (upperPrefix.size() >= 4) {
+        int id = shardOf(upperPrefix);
+        if (id == -1) {
+            return std::vector<PlateRecord>();
+        }
+        return shards[id]->prefixSearch(upperPrefix);
+    }
+    
+    return gather([&](const PlateDatabase& db) {
+        return db.prefixSearch(upperPrefix);
+    });
+}
+
+std::vector<PlateRecord> ShardedPlateDatabase::searchByCity(const std::string& city) const {
+    return gather([&](const PlateDatabase& db) {
+        return db.searchByCity(city);
+    });
+}
+
+size_t ShardedPlateDatabase::getRecordCount() const {
+    size_t total = 0;
+    for (const auto& db : shards) {
+        total += db->getRecordCount();
+    }
+    return total;
+}
+
+int ShardedPlateDatabase::getCityCount() const {
+    return static_cast<int>(getCityStatistics().size());
+}
+
+std::vector<std::pair<std::string, int>> ShardedPlateDatabase::getCityStatistics() const {
+    std::vector<std::vector<std::pair<std::string, int>>> parts(shards.size());
+    Parallel::forEach(shards.size(), [&](size_t i) {
+        parts[i] = shards[i]->getCityStatistics();
+    });
+    
+    std::unordered_map<std::string, int> cnt;
+    for (const auto& part : parts) {
+        for (const auto& p : part) {
+            cnt[p.first] += p.second;
+        }
+    }
+    
+    std::vector<std::pair<std::string, int>> result(cnt.begin(), cnt.end());
+    std::sort(result.begin(), result.end(),
+              [](const std::pair<std::string, int>& a,
+                 const std::pair<std::string, int>& b) {
+                  return a.second > b.second; // 按数量降序
+              });
+    return result;
+}
+
+std::vector<PlateRecord> ShardedPlateDatabase::getAllRecords() const {
+    return gather([](const PlateDatabase& db) {
+        return db.getAllRecords();
+    });
+}
+
+bool ShardedPlateDatabase::saveToFile(const std::string& filename) const {
+    return FileIO::saveToFile(filename, getAllRecords());
+}
+
+bool ShardedPlateDatabase::exportToCSV(const std::string& filename) const {
+    return FileIO::exportToCSV(filename, getAllRecords());
+}
+
+void ShardedPlateDatabase::clearAll() {
+    for (auto& db : shards) {
+        db->clearAll();
+    }
+    std::cout << "已清空所有分片数据。" << std::endl;
+}
@@ -0,0 +1,280 @@
+#include "../include/Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+std::atomic<bool> Trace::active(false);
+
+namespace {
+    struct Event {
+        const char* name;
+        std::uint64_t start;
+        std::uint64_t duration;
+        std::int64_t arg;
+        unsigned tid;
+    };
+    
+    // 一个线程的环形缓冲区；未写满前按需增长，写满后从 next 处覆盖
+    struct ThreadBuffer {
+        std::mutex lock;                    // 只有导出 / 清空时才会与写入方竞争
+        std::vector<Event> events;
+        size_t next;
+        std::uint64_t dropped;
+        
+        ThreadBuffer() : next(0), dropped(0) {}
+    };
+    
+    struct Registry {
+        std::mutex lock;
+        std::vector<ThreadBuffer*> buffers;     // 全部缓冲区，进程结束前不释放
+        std::vector<ThreadBuffer*> idle;        // 所属线程已退出、可复用的缓冲区
+        std::map<unsigned, std::string> names;
+    };
+    
+    Registry& registry() {
+        static Registry* instance = new Registry();     // 故意不析构，线程退出时仍可访问
+        return *instance;
+    }
+    
+    std::atomic<size_t> bufferCapacity(Trace::DEFAULT_EVENTS);
+    
+    unsigned threadId() {
+        static std::atomic<unsigned> nextId(1);
+        static thread_local unsigned id = nextId.fetch_add(1);
+        return id;
+    }
+    
+    // 线程首次记录时取得缓冲区，退出时归还
+    struct LocalBuffer {
+        ThreadBuffer* buffer;
+        
+        LocalBuffer() : buffer(nullptr) {}
+        ~LocalBuffer() {
+            if (buffer) {
+                Registry& reg = registry();
+                std::lock_guard<std::mutex> guard(reg.lock);
+                reg.idle.push_back(buffer);
+            }
+        }
+        
+        ThreadBuffer* get() {
+            if (!buffer) {
+                Registry& reg = registry();
+                std::lock_guard<std::mutex> guard(reg.lock);
+                if (!reg.idle.empty()) {
+                    buffer = reg.idle.back();
+                    reg.idle.pop_back();
+                } else {
+                    buffer = new ThreadBuffer();
+                    reg.buffers.push_back(buffer);
+                }
+            }
+            return buffer;
+        }
+    };
+    
+    thread_local LocalBuffer localBuffer;
+    
+    const std::chrono::steady_clock::time_point& epoch() {
+        static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return start;
+    }
+    
+    void appendEscaped(std::string& out, const char* text) {
+        for (const char* p = text; *p; ++p) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += static_cast<char>(c);
+            } else if (c < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+    
+    // 事件名中 “::” 之前的部分作为分类
+    std::string categoryOf(const char* name) {
+        const char* sep = std::strstr(name, "::");
+        return sep ? std::string(name, sep) : std::string("plate");
+    }
+    
+    bool earlier(const Event& a, const Event& b) {
+        return a.start < b.start;
+    }
+}
+
+bool Trace::start(size_t eventsPerThread) {
+#ifdef PLATE_TRACE_DISABLED
+    (void)eventsPerThread;
+    std::cerr << "追踪已在编译时关闭（PLATE_TRACE=OFF）" << std::endl;
+    return false;
+#else
+    epoch();
+    bufferCapacity.store(eventsPerThread == 0 ? 1 : eventsPerThread);
+    clear();
+    active.store(true);
+    return true;
+#endif
+}
+
+void Trace::stop() {
+    active.store(false);
+}
+
+void Trace::clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    for (size_t i = 0; i < reg.buffers.size(); ++i) {
+        ThreadBuffer* buf = reg.buffers[i];
+        std::lock_guard<std::mutex> bufGuard(buf->lock);
+        std::vector<Event>().swap(buf->events);
+        buf->next = 0;
+        buf->dropped = 0;
+    }
+}
+
+size_t Trace::eventCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    size_t total = 0;
+    for (size_t i = 0; i < reg.buffers.size(); ++i) {
+        std::lock_guard<std::mutex> bufGuard(reg.buffers[i]->lock);
+        total += reg.buffers[i]->events.size();
+    }
+    return total;
+}
+
+std::uint64_t Trace::droppedCount() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    std::uint64_t total = 0;
+    for (size_t i = 0; i < reg.buffers.size(); ++i) {
+        std::lock_guard<std::mutex> bufGuard(reg.buffers[i]->lock);
+        total += reg.buffers[i]->dropped;
+    }
+    return total;
+}
+
+void Trace::setThreadName(const std::string& name) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.names[threadId()] = name;
+}
+
+std::uint64_t Trace::now() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch()).count());
+}
+
+void Trace::record(const char* name, std::uint64_t startNs, std::uint64_t endNs,
+                   std::int64_t arg) {
+    Event e;
+    e.name = name;
+    e.start = startNs;
+    e.duration = endNs > startNs ? endNs - startNs : 0;
+    e.arg = arg;
+    e.tid = threadId();
+    
+    ThreadBuffer* buf = localBuffer.get();
+    size_t capacity = bufferCapacity.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> guard(buf->lock);
+    if (buf->events.size() < capacity) {
+        buf->events.push_back(e);
+    } else {
+        buf->events[buf->next] = e;
+        buf->next = (buf->next + 1) % buf->events.size();
+        buf->dropped++;
+    }
+}
+
+std::string Trace::toJson() {
+    std::vector<Event> events;
+    std::map<unsigned, std::string> names;
+    std::uint64_t dropped = 0;
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        names = reg.names;
+        for (size_t i = 0; i < reg.buffers.size(); ++i) {
+            ThreadBuffer* buf = reg.buffers[i];
+            std::lock_guard<std::mutex> bufGuard(buf->lock);
+            events.insert(events.end(), buf->events.begin(), buf->events.end());
+            dropped += buf->dropped;
+        }
+    }
+    std::stable_sort(events.begin(), events.end(), earlier);
+    
+    // 出现过的线程都给出轨道名
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (names.find(events[i].tid) == names.end()) {
+            names[events[i].tid] = "线程 " + std::to_string(events[i].tid);
+        }
+    }
+    
+    std::string out;
+    out.reserve(128 + events.size() * 128);
+    out += "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":";
+    out += std::to_string(dropped);
+    out += "},\"traceEvents\":[\n";
+    
+    bool first = true;
+    for (std::map<unsigned, std::string>::const_iterator it = names.begin(); it != names.end(); ++it) {
+        if (!first) out += ",\n";
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+        out += std::to_string(it->first);
+        out += ",\"args\":{\"name\":\"";
+        appendEscaped(out, it->second.c_str());
+        out += "\"}}";
+    }
+    
+    char num[64];
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Event& e = events[i];
+        if (!first) out += ",\n";
+        first = false;
+        out += "{\"name\":\"";
+        appendEscaped(out, e.name);
+        out += "\",\"cat\":\"";
+        appendEscaped(out, categoryOf(e.name).c_str());
+        // 时间单位为微秒，保留纳秒精度
+        std::snprintf(num, sizeof(num), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                      e.start / 1000.0, e.duration / 1000.0);
+        out += num;
+        out += ",\"pid\":1,\"tid\":";
+        out += std::to_string(e.tid);
+        if (e.arg >= 0) {
+            out += ",\"args\":{\"n\":";
+            out += std::to_string(e.arg);
+            out += '}';
+        }
+        out += '}';
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Trace::writeJson(const std::string& filename) {
+    std::ofstream fout(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!fout) {
+        std::cerr << "无法创建追踪文件：" << filename << std::endl;
+        return false;
+    }
+    fout << toJson();
+    if (!fout) {
+        std::cerr << "写入追踪文件失败：" << filename << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -1,9 +1,11 @@
 #include "../include/Utils.h"
+#include "../include/PlateOccupancy.h"
 #include <random>
 #include <algorithm>
 #include <map>
 #include <unordered_map>
 #include <cstring>
+#include <cstdint>
 
 namespace Utils {
     int charToBucketIndex(char c) {
@@ -91,19 +93,16 @@ namespace Utils {
         if (!isValidPlate(plate)) {
             return false;
         }
-        // 新能源车牌长度为 10，且第 5 个字节为 D/F
-        if (plate.size() != 10) {
-            return false;
-        }
-        char energyType = plate[4];
-        return energyType == 'D' || energyType == 'F';
+        // 合法车牌中只有新能源车牌长度为 10（第 5 个字节已校验为 D/F）
+        return plate.size() == 10;
     }
     
     std::string getPlateCategory(const std::string& plate) {
         if (!isValidPlate(plate)) {
             return "";
         }
-        return isNewEnergyPlate(plate) ? "电车" : "油车";
+        // 只校验一次，按长度直接区分，避免经 isNewEnergyPlate 再校验一遍
+        return plate.size() == 10 ? "电车" : "油车";
     }
     
     // 从车牌中提取发牌机关代码字母（第2个字符，跳过省份简称）
@@ -175,7 +174,7 @@ namespace Utils {
     }
     
     // 根据城市生成随机车牌号（车牌字母与城市对应，燃油车）
-    std::string generateRandomPlateByCity(const std::string& city) {
+    std::string generateRandomPlateByCity(const std::string& city, PlateOccupancy* occupied) {
         static std::random_device rd;
         static std::mt19937 gen(rd());
         static std::uniform_int_distribution<int> digitDist(0, 9);
@@ -196,6 +195,12 @@ namespace Utils {
             plateLetter = validLetters[letterDist(gen)];
         }
         
+        // 按占用位图分配：随机起点之后的第一个空闲编号，无需重试
+        if (occupied) {
+            static std::uniform_int_distribution<std::uint32_t> serialDist(0, PlateOccupancy::SERIAL_COUNT - 1);
+            return occupied->allocateFrom(plateLetter, PlateOccupancy::KIND_FUEL, serialDist(gen));
+        }
+        
         // 辽宁省燃油车车牌格式：辽 + 字母 + 5位编号
         std::string plate;
         plate.resize(9);
@@ -225,7 +230,7 @@ namespace Utils {
     }
     
     // 根据城市生成随机新能源车牌号（车牌字母与城市对应，类型 D/F）
-    std::string generateRandomNewEnergyPlateByCity(const std::string& city) {
+    std::string generateRandomNewEnergyPlateByCity(const std::string& city, PlateOccupancy* occupied) {
         static std::random_device rd;
         static std::mt19937 gen(rd());
         static std::uniform_int_distribution<int> digitDist(0, 9);
@@ -246,6 +251,13 @@ namespace Utils {
             plateLetter = validLetters[letterDist(gen)];
         }
         
+        if (occupied) {
+            static std::uniform_int_distribution<std::uint32_t> serialDist(0, PlateOccupancy::SERIAL_COUNT - 1);
+            PlateOccupancy::Kind kind = energyDist(gen) == 0 ? PlateOccupancy::KIND_ELECTRIC
+                                                               : PlateOccupancy::KIND_HYBRID;
+            return occupied->allocateFrom(plateLetter, kind, serialDist(gen));
+        }
+        
         // 新能源车牌格式：辽 + 字母 + D/F + 5位编号
         std::string plate;
         plate.resize(10);
@@ -0,0 +1,447 @@
+#include "../include/WriteAheadLog.h"
+#include "../include/BinaryCodec.h"
+#include "../include/FileSync.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define PLATE_FSYNC(fd) ::fsync(fd)
+#define PLATE_FILENO(fp) ::fileno(fp)
+#define PLATE_FTRUNCATE(fd, size) ::ftruncate(fd, static_cast<off_t>(size))
+#elif defined(_WIN32)
+#include <io.h>
+#define PLATE_FSYNC(fd) ::_commit(fd)
+#define PLATE_FILENO(fp) ::_fileno(fp)
+#define PLATE_FTRUNCATE(fd, size) ::_chsize_s(fd, static_cast<__int64>(size))
+#endif
+
+namespace {
+    const char MAGIC[8] = {'P', 'L', 'A', 'T', 'E', 'W', 'A', 'L'};
+    const size_t HEADER_SIZE = sizeof(MAGIC);
+    
+    // 记录头：长度(4) + CRC(4) + 类型(1) + 序号(8)
+    const size_t ENTRY_HEAD = 4 + 4 + 1 + 8;
+    
+    // 单条记录负载上限，超过视为损坏
+    const std::uint32_t MAX_PAYLOAD = 1u << 30;
+    
+    // 批量添加时每条日志最多包含的记录数
+    const size_t MAX_BATCH_RECORDS = 1u << 16;
+    
+    bool decodePayload(WriteAheadLog::Entry& e, const char* data, size_t n) {
+        BinaryCodec::Reader in(data, data + n);
+        switch (e.type) {
+            case WriteAheadLog::ENTRY_ADD:
+            case WriteAheadLog::ENTRY_MODIFY:
+                e.record = in.record();
+                break;
+            case WriteAheadLog::ENTRY_DELETE:
+                e.record.plate = in.str();
+                break;
+            case WriteAheadLog::ENTRY_CLEAR:
+                break;
+            case WriteAheadLog::ENTRY_BATCH_ADD: {
+                std::uint64_t count = in.varint();
+                // 每条记录至少 4 字节，据此拒绝明显错误的数量
+                if (!in.ok || count > n / 4) return false;
+                e.batch.reserve(static_cast<size_t>(count));
+                for (std::uint64_t i = 0; i < count && in.ok; i++) {
+                    e.batch.push_back(in.record());
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+        return in.ok && in.atEnd();
+    }
+}
+
+WriteAheadLog::WriteAheadLog()
+    : fp(nullptr), nextLsn(1), durableLsn(0), flushing(false), failed(false),
+      entries(0), syncs(0), bytes(0), appended(0) {
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    close();
+}
+
+bool WriteAheadLog::replay(const std::string& path,
+                           const std::function<void(const Entry&)>& visit,
+                           std::uint64_t* lastLsn,
+                           std::uint64_t* validBytes) {
+    if (lastLsn) *lastLsn = 0;
+    if (validBytes) *validBytes = 0;
+    
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) {
+        return true;  // 没有日志：无需回放
+    }
+    
+    char magic[HEADER_SIZE];
+    size_t got = std::fread(magic, 1, HEADER_SIZE, in);
+    if (got < HEADER_SIZE) {
+        // 文件头都没写完，按空日志处理
+        std::fclose(in);
+        return true;
+    }
+    if (std::memcmp(magic, MAGIC, HEADER_SIZE) != 0) {
+        std::fclose(in);
+        return false;
+    }
+    
+    std::uint64_t offset = HEADER_SIZE;
+    std::uint64_t last = 0;
+    char head[ENTRY_HEAD];
+    std::string payload;
+    
+    while (std::fread(head, 1, ENTRY_HEAD, in) == ENTRY_HEAD) {
+        std::uint32_t len = BinaryCodec::getU32(head);
+        std::uint32_t crc = BinaryCodec::getU32(head + 4);
+        if (len > MAX_PAYLOAD) break;
+        
+        payload.resize(len);
+        if (len > 0 && std::fread(&payload[0], 1, len, in) != len) break;
+        
+        // CRC 覆盖类型、序号与负载
+        std::uint32_t actual = BinaryCodec::crc32(head + 8, ENTRY_HEAD - 8);
+        actual = BinaryCodec::crc32(payload.data(), payload.size(), actual);
+        if (actual != crc) break;
+        
+        Entry e;
+        e.type = static_cast<EntryType>(static_cast<unsigned char>(head[8]));
+        e.lsn = BinaryCodec::getU64(head + 9);
+        if (e.lsn <= last || !decodePayload(e, payload.data(), payload.size())) break;
+        
+        visit(e);
+        last = e.lsn;
+        offset += ENTRY_HEAD + len;
+    }
+    
+    std::fclose(in);
+    if (lastLsn) *lastLsn = last;
+    if (validBytes) *validBytes = offset;
+    return true;
+}
+
+bool WriteAheadLog::open(const std::string& filename, std::uint64_t validBytes,
+                         std::uint64_t next) {
+    close();
+    
+    std::lock_guard<std::mutex> lock(mtx);
+    path = filename;
+    
+    // 以追加方式打开，原地截掉残缺的尾部：有效记录始终留在文件中，
+    // 截断完成前崩溃也只会在下次回放时再截一次
+    fp = std::fopen(filename.c_str(), "ab");
+    if (!fp) {
+        return false;
+    }
+    bool fresh = validBytes < HEADER_SIZE;  // 不存在或文件头都没写完，其中没有有效记录
+    if (fresh) {
+        validBytes = 0;
+    }
+    bool ok = true;
+#ifdef PLATE_FTRUNCATE
+    ok = PLATE_FTRUNCATE(PLATE_FILENO(fp), validBytes) == 0;
+#endif
+    if (fresh) {
+        ok = ok && std::fwrite(MAGIC, 1, HEADER_SIZE, fp) == HEADER_SIZE;
+        validBytes = HEADER_SIZE;
+    }
+    ok = ok && std::fflush(fp) == 0;
+#ifdef PLATE_FSYNC
+    ok = ok && PLATE_FSYNC(PLATE_FILENO(fp)) == 0;
+#endif
+    // 新建的日志文件要等目录项落盘后才能在崩溃后找到
+    ok = ok && (!fresh || FileSync::syncParentDirectory(filename));
+    if (!ok) {
+        std::fclose(fp);
+        fp = nullptr;
+        return false;
+    }
+    
+    nextLsn = next > 0 ? next : 1;
+    durableLsn = nextLsn - 1;
+    pending.clear();
+    flushing = false;
+    failed = false;
+    entries = 0;
+    syncs = 0;
+    bytes = validBytes;
+    appended = validBytes;
+    return true;
+}
+
+void WriteAheadLog::close() {
+    std::uint64_t last = lastLsn();
+    if (fp) {
+        sync(last);
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (fp) {
+        std::fclose(fp);
+        fp = nullptr;
+    }
+}
+
+std::uint64_t WriteAheadLog::appendLocked(EntryType type, const std::string& payload) {
+    if (failed) {
+        return 0;
+    }
+    std::uint64_t lsn = nextLsn++;
+    
+    // 类型与序号，与负载一起计入 CRC
+    std::string meta;
+    meta.push_back(static_cast<char>(type));
+    BinaryCodec::putU64(meta, lsn);
+    
+    std::uint32_t crc = BinaryCodec::crc32(meta.data(), meta.size());
+    crc = BinaryCodec::crc32(payload.data(), payload.size(), crc);
+    
+    BinaryCodec::putU32(pending, static_cast<std::uint32_t>(payload.size()));
+    BinaryCodec::putU32(pending, crc);
+    pending.append(meta);
+    pending.append(payload);
+    appended += ENTRY_HEAD + payload.size();
+    entries++;
+    return lsn;
+}
+
+std::uint64_t WriteAheadLog::appendAdd(const PlateRecord& record) {
+    std::string payload;
+    BinaryCodec::putRecord(payload, record);
+    std::lock_guard<std::mutex> lock(mtx);
+    return appendLocked(ENTRY_ADD, payload);
+}
+
+std::uint64_t WriteAheadLog::appendModify(const PlateRecord& record) {
+    std::string payload;
+    BinaryCodec::putRecord(payload, record);
+    std::lock_guard<std::mutex> lock(mtx);
+    return appendLocked(ENTRY_MODIFY, payload);
+}
+
+std::uint64_t WriteAheadLog::appendDelete(const std::string& plate) {
+    std::string payload;
+    BinaryCodec::putString(payload, plate);
+    std::lock_guard<std::mutex> lock(mtx);
+    return appendLocked(ENTRY_DELETE, payload);
+}
+
+std::uint64_t WriteAheadLog::appendClear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return appendLocked(ENTRY_CLEAR, std::string());
+}
+
+std::uint64_t WriteAheadLog::appendBatch(std::vector<PlateRecord>::const_iterator first,
+                                         std::vector<PlateRecord>::const_iterator last) {
+    // 大批量拆成多条记录，单条负载不超过上限；各条连续分配序号
+    std::vector<std::string> payloads;
+    do {
+        std::vector<PlateRecord>::const_iterator stop =
+            (last - first > static_cast<std::ptrdiff_t>(MAX_BATCH_RECORDS)) ? first + MAX_BATCH_RECORDS : last;
+        payloads.push_back(std::string());
+        std::string& payload = payloads.back();
+        BinaryCodec::putVarint(payload, static_cast<std::uint64_t>(stop - first));
+        for (; first != stop; ++first) {
+            BinaryCodec::putRecord(payload, *first);
+        }
+    } while (first != last);
+    
+    std::lock_guard<std::mutex> lock(mtx);
+    std::uint64_t lsn = 0;
+    for (const auto& payload : payloads) {
+        lsn = appendLocked(ENTRY_BATCH_ADD, payload);
+        if (lsn == 0) {
+            break;
+        }
+    }
+    return lsn;
+}
+
+bool WriteAheadLog::sync(std::uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mtx);
+    
+    while (durableLsn < lsn) {
+        if (!fp || failed) {
+            return false;
+        }
+        if (flushing) {
+            // 已有线程在刷盘，等它完成后再检查自己的序号
+            flushed.wait(lock);
+            continue;
+        }
+        
+        // 成为本轮的刷盘者，带走缓冲中所有记录
+        flushing = true;
+        std::string batch;
+        batch.swap(pending);
+        std::uint64_t target = nextLsn - 1;
+        std::FILE* out = fp;
+        lock.unlock();
+        
+        bool ok = std::fwrite(batch.data(), 1, batch.size(), out) == batch.size() &&
+                  std::fflush(out) == 0;
+#ifdef PLATE_FSYNC
+        ok = ok && PLATE_FSYNC(PLATE_FILENO(out)) == 0;
+#endif
+        
+        lock.lock();
+        flushing = false;
+        if (ok) {
+            durableLsn = target;
+            syncs++;
+            bytes += batch.size();
+        } else {
+            failed = true;
+        }
+        flushed.notify_all();
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WriteAheadLog::truncate() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (flushing) {
+        flushed.wait(lock);
+    }
+    if (!fp) {
+        return false;
+    }
+    
+    // 文件以追加方式打开，截到文件头之后新记录接着写在文件头后面
+    bool ok = std::fflush(fp) == 0;
+#ifdef PLATE_FTRUNCATE
+    ok = ok && PLATE_FTRUNCATE(PLATE_FILENO(fp), HEADER_SIZE) == 0;
+#endif
+#ifdef PLATE_FSYNC
+    ok = ok && PLATE_FSYNC(PLATE_FILENO(fp)) == 0;
+#endif
+    
+    // 缓冲中的记录已由检查点覆盖
+    pending.clear();
+    durableLsn = nextLsn - 1;
+    bytes = HEADER_SIZE;
+    appended = HEADER_SIZE;
+    failed = !ok;
+    return ok;
+}
+
+bool WriteAheadLog::truncateThrough(std::uint64_t lsn, std::uint64_t offset) {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (flushing) {
+        flushed.wait(lock);
+    }
+    if (!fp || failed || lsn > durableLsn || offset < HEADER_SIZE || offset > bytes) {
+        return false;
+    }
+    
+    // 文件中没有 lsn 之后的记录（都还在缓冲中）：原地截到文件头
+    if (offset == bytes) {
+        bool ok = std::fflush(fp) == 0;
+#ifdef PLATE_FTRUNCATE
+        ok = ok && PLATE_FTRUNCATE(PLATE_FILENO(fp), HEADER_SIZE) == 0;
+#endif
+#ifdef PLATE_FSYNC
+        ok = ok && PLATE_FSYNC(PLATE_FILENO(fp)) == 0;
+#endif
+        if (ok) {
+            bytes = HEADER_SIZE;
+            appended -= offset - HEADER_SIZE;
+        }
+        failed = !ok;
+        return ok;
+    }
+    
+    // 否则把 offset 之后的记录复制到新文件再替换：崩溃时要么是完整的旧日志
+    // （回放时跳过快照已包含的序号），要么是只含之后记录的新日志
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) {
+        return false;
+    }
+    char head[ENTRY_HEAD];
+    bool ok = std::fseek(in, static_cast<long>(offset), SEEK_SET) == 0 &&
+              std::fread(head, 1, ENTRY_HEAD, in) == ENTRY_HEAD &&
+              BinaryCodec::getU64(head + 9) == lsn + 1 &&
+              std::fseek(in, static_cast<long>(offset), SEEK_SET) == 0;
+    if (!ok) {
+        std::fclose(in);
+        return false;
+    }
+    
+    std::string tmpName = path + ".tmp";
+    std::FILE* out = std::fopen(tmpName.c_str(), "wb");
+    if (!out) {
+        std::fclose(in);
+        return false;
+    }
+    ok = std::fwrite(MAGIC, 1, HEADER_SIZE, out) == HEADER_SIZE;
+    std::vector<char> buf(1u << 16);
+    std::uint64_t remaining = bytes - offset;
+    while (ok && remaining > 0) {
+        size_t n = static_cast<size_t>(std::min<std::uint64_t>(remaining, buf.size()));
+        ok = std::fread(buf.data(), 1, n, in) == n && std::fwrite(buf.data(), 1, n, out) == n;
+        remaining -= n;
+    }
+    std::fclose(in);
+    ok = std::fclose(out) == 0 && ok;
+    if (!ok) {
+        std::remove(tmpName.c_str());
+        return false;
+    }
+    if (!FileSync::commitReplace(tmpName, path)) {
+        return false;
+    }
+    
+    // 改名后旧句柄指向已删除的文件，重新打开新文件继续追加
+    std::fclose(fp);
+    fp = std::fopen(path.c_str(), "ab");
+    if (!fp) {
+        failed = true;
+        return false;
+    }
+    bytes = HEADER_SIZE + (bytes - offset);
+    appended -= offset - HEADER_SIZE;
+    return true;
+}
+
+std::uint64_t WriteAheadLog::lastLsn() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return nextLsn - 1;
+}
+
+std::uint64_t WriteAheadLog::lastLsn(std::uint64_t* endOffset) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (endOffset) *endOffset = appended;
+    return nextLsn - 1;
+}
+
+bool WriteAheadLog::isFailed() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return failed;
+}
+
+std::uint64_t WriteAheadLog::entryCount() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return entries;
+}
+
+std::uint64_t WriteAheadLog::syncCount() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return syncs;
+}
+
+std::uint64_t WriteAheadLog::bytesWritten() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return bytes;
+}
+
+size_t WriteAheadLog::bufferBytes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return pending.capacity();
+}